@@ -0,0 +1,27 @@
+﻿#include "audio_backend.h"
+#include "asset_pack.h"
+#include "trace.h"
+
+
+bool SfmlAudioBackend::decodeSound(const std::string& path, sf::SoundBuffer& buffer) {
+    TraceZone zone("decode sound", path);
+    AssetBlob packed = getAssetPack().find(path);
+    if (packed) {
+        return buffer.loadFromMemory(packed.data, packed.size);
+    }
+    return buffer.loadFromFile(path);
+}
+
+std::unique_ptr<sf::Sound> SfmlAudioBackend::createSound(const sf::SoundBuffer& buffer) {
+    return std::make_unique<sf::Sound>(buffer);
+}
+
+std::unique_ptr<sf::Music> SfmlAudioBackend::openMusic(const std::string& path) {
+    TraceZone zone("open music", path);
+    auto music = std::make_unique<sf::Music>();
+    AssetBlob packed = getAssetPack().find(path);
+    if (packed ? !music->openFromMemory(packed.data, packed.size) : !music->openFromFile(path)) {
+        return nullptr;
+    }
+    return music;
+}
@@ -0,0 +1,41 @@
+﻿#ifndef AUDIO_BACKEND_H
+#define AUDIO_BACKEND_H
+
+#include <SFML/Audio.hpp>
+#include <memory>
+#include <string>
+
+
+// Everything AudioManager needs from the sound device and the decoders.
+// The SFML backend is what the game uses; the null backend never opens a
+// device or reads a file, so simulations and benchmarks can construct an
+// AudioManager for rule code and run at full speed without sound hardware.
+class AudioBackend {
+public:
+    virtual ~AudioBackend() = default;
+
+    virtual bool hasDevice() const = 0;
+    virtual bool decodeSound(const std::string& path, sf::SoundBuffer& buffer) = 0;
+    virtual std::unique_ptr<sf::Sound> createSound(const sf::SoundBuffer& buffer) = 0;
+    virtual std::unique_ptr<sf::Music> openMusic(const std::string& path) = 0;
+};
+
+
+class SfmlAudioBackend : public AudioBackend {
+public:
+    bool hasDevice() const override { return true; }
+    bool decodeSound(const std::string& path, sf::SoundBuffer& buffer) override;
+    std::unique_ptr<sf::Sound> createSound(const sf::SoundBuffer& buffer) override;
+    std::unique_ptr<sf::Music> openMusic(const std::string& path) override;
+};
+
+
+class NullAudioBackend : public AudioBackend {
+public:
+    bool hasDevice() const override { return false; }
+    bool decodeSound(const std::string&, sf::SoundBuffer&) override { return false; }
+    std::unique_ptr<sf::Sound> createSound(const sf::SoundBuffer&) override { return nullptr; }
+    std::unique_ptr<sf::Music> openMusic(const std::string&) override { return nullptr; }
+};
+
+#endif
@@ -1,331 +1,539 @@
 ﻿#include "audio_manager.h"
+#include "asset_pack.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
-AudioManager::AudioManager()
-    : currentMusic(nullptr)
+
+namespace {
+
+// Indexed by SfxCategory: Drop, LineClear, Ability, Voice, Jingle, Menu.
+constexpr std::array<int, SFX_CATEGORY_COUNT> SFX_CATEGORY_VOICE_LIMITS = {4, 3, 3, 2, 2, 2};
+constexpr std::array<int, SFX_CATEGORY_COUNT> SFX_CATEGORY_PRIORITIES = {1, 2, 2, 1, 3, 0};
+
+const std::string SPLASH_MUSIC_PATH = "Assets/Sound/SFX/Kilonia Studios Splash Screen.mp3";
+const std::string MENU_MUSIC_PATH = "Assets/Sound/Music/Tessera_Menu.ogg";
+const std::string GAMEPLAY_MUSIC_PATH = "Assets/Sound/Music/Tessera_Main.ogg";
+const std::string GAME_WIN_MUSIC_PATH = "Assets/Sound/SFX/Game_Win.ogg";
+
+// Indexed by SfxId.
+const std::array<const char*, SFX_ID_COUNT> SFX_FILE_PATHS = {
+    "Assets/Sound/SFX/ground.ogg",
+    "Assets/Sound/SFX/laser.ogg",
+    "Assets/Sound/SFX/bomb.ogg",
+    "Assets/Sound/SFX/stomp.ogg",
+    "Assets/Sound/SFX/delivery.ogg",
+    "Assets/Sound/SFX/Achievement.ogg",
+    "Assets/Sound/SFX/Game_Over.ogg",
+    "Assets/Sound/SFX/Menu_Click.ogg",
+    "Assets/Sound/SFX/Menu_Back.ogg",
+    "Assets/Sound/SFX/wow_01.ogg",
+    "Assets/Sound/SFX/wow_02.ogg",
+    "Assets/Sound/SFX/wow_03.ogg"
+};
+
+}
+
+
+AudioManager::AudioManager(std::unique_ptr<AudioBackend> audioBackend)
+    : backend(std::move(audioBackend))
     , masterVolume(100.0f)
     , musicVolumeMultiplier(100.0f)
     , sfxVolumeMultiplier(100.0f)
     , lastMasterVolume(100.0f)
     , isMuted(false)
+    , soundCache(*backend)
 {
+    if (backend->hasDevice()) {
+        audioThreadRunning.store(true);
+        audioThread = std::thread(&AudioManager::runAudioThread, this);
+    }
 }
 
-bool AudioManager::loadAllAudio() {
-    bool allLoaded = true;
-
-
-    if (splashMusic.openFromFile("Assets/Sound/SFX/Kilonia Studios Splash Screen.mp3")) {
-        splashMusic.setLooping(false);
-        splashMusic.setVolume((splashMusicVolume * masterVolume) / 100.0f);
-        std::cout << "Splash music loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load splash music (Assets/Sound/SFX/Kilonia Studios Splash Screen.mp3)" << std::endl;
-        allLoaded = false;
+AudioManager::~AudioManager() {
+    if (audioThread.joinable()) {
+        audioThreadRunning.store(false, std::memory_order_release);
+        audioThread.join();
     }
+}
 
 
-    if (menuMusic.openFromFile("Assets/Sound/Music/Tessera_Menu.ogg")) {
-        menuMusic.setLooping(true);
-        menuMusic.setVolume((menuMusicVolume * masterVolume) / 100.0f);
-        std::cout << "Menu music loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load menu music (Assets/Sound/Music/Tessera_Menu.ogg)" << std::endl;
-        allLoaded = false;
+// Game thread side. Sound effects are dropped if the queue is ever full so a
+// burst can never stall a frame; everything else waits for a free slot.
+void AudioManager::postCommand(AudioCommand&& command, bool droppable) {
+    if (!audioThreadRunning.load(std::memory_order_relaxed)) {
+        return;
     }
-
-
-    if (gameplayMusic.openFromFile("Assets/Sound/Music/Tessera_Main.ogg")) {
-        gameplayMusic.setLooping(true);
-        gameplayMusic.setVolume((gameplayMusicVolume * masterVolume) / 100.0f);
-        std::cout << "Gameplay music loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load gameplay music (Assets/Sound/Music/Tessera_Main.ogg)" << std::endl;
-        allLoaded = false;
+    while (!commandQueue.push(std::move(command))) {
+        if (droppable) {
+            return;
+        }
+        std::this_thread::yield();
     }
+}
 
+void AudioManager::postEffect(SfxId id, SfxCategory category, float volume) {
+    AudioCommand command;
+    command.type = AudioCommandType::PlayEffect;
+    command.effect = id;
+    command.category = category;
+    command.volume = volume;
+    postCommand(std::move(command), true);
+}
 
-    if (gameWinMusic.openFromFile("Assets/Sound/SFX/Game_Win.ogg")) {
-        gameWinMusic.setLooping(false);
-        gameWinMusic.setVolume((gameWinMusicVolume * masterVolume) / 100.0f);
-        std::cout << "Game Win music loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load game win music (Assets/Sound/Music/Game_Win.ogg)" << std::endl;
-        allLoaded = false;
+void AudioManager::postMusic(const std::string& path, float baseVolume, bool looping, bool restartIfCurrent) {
+    if (!restartIfCurrent && path == requestedMusicPath) {
+        return;
     }
+    requestedMusicPath = path;
 
+    AudioCommand command;
+    command.type = AudioCommandType::RequestMusic;
+    command.path = path;
+    command.volume = baseVolume;
+    command.looping = looping;
+    command.restart = restartIfCurrent;
+    postCommand(std::move(command), false);
+}
 
-    if (spaceSoundBuffer.loadFromFile("Assets/Sound/SFX/ground.ogg")) {
-        spaceSound = std::make_unique<sf::Sound>(spaceSoundBuffer);
-        spaceSound->setVolume((spaceVolume * masterVolume) / 100.0f);
-        std::cout << "Space sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load space sound (Assets/Sound/SFX/ground.ogg)" << std::endl;
-        allLoaded = false;
-    }
+void AudioManager::postVolumes() {
+    AudioCommand command;
+    command.type = AudioCommandType::SetVolumes;
+    command.volume = masterVolume;
+    command.musicVolume = musicVolumeMultiplier;
+    command.sfxVolume = sfxVolumeMultiplier;
+    postCommand(std::move(command), false);
+}
 
 
-    if (laserSoundBuffer.loadFromFile("Assets/Sound/SFX/laser.ogg")) {
-        laserSound = std::make_unique<sf::Sound>(laserSoundBuffer);
-        laserSound->setVolume((laserVolume * masterVolume) / 100.0f);
-        std::cout << "Laser sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load laser sound (Assets/Sound/SFX/laser.ogg)" << std::endl;
-        allLoaded = false;
-    }
+void AudioManager::runAudioThread() {
+    traceSetThreadName("audio");
+    auto lastTick = std::chrono::steady_clock::now();
+    AudioCommand command;
+    while (audioThreadRunning.load(std::memory_order_acquire)) {
+        bool handled = false;
+        while (commandQueue.pop(command)) {
+            executeCommand(command);
+            handled = true;
+        }
 
+        auto now = std::chrono::steady_clock::now();
+        updateMixer(std::chrono::duration<float>(now - lastTick).count());
+        lastTick = now;
 
-    if (bombSoundBuffer.loadFromFile("Assets/Sound/SFX/bomb.ogg")) {
-        bombSound = std::make_unique<sf::Sound>(bombSoundBuffer);
-        bombSound->setVolume((bombVolume * masterVolume) / 100.0f);
-        std::cout << "Bomb sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load bomb sound (Assets/Sound/SFX/bomb.ogg)" << std::endl;
-        allLoaded = false;
+        if (!handled) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_THREAD_IDLE_MS));
+        }
     }
+    stopMusicStreams();
+}
+
+void AudioManager::executeCommand(const AudioCommand& command) {
+    switch (command.type) {
+        case AudioCommandType::PlayEffect:
+            playBuiltinEffect(command.effect, command.category, command.volume);
+            break;
+        case AudioCommandType::PlayLineClear:
+            if (customLineClearBuffer) {
+                playEffect(*customLineClearBuffer, SfxCategory::LineClear, laserVolume);
+            } else {
+                playBuiltinEffect(SfxId::Laser, SfxCategory::LineClear, laserVolume);
+            }
+            break;
+        case AudioCommandType::PlayDrop:
+            if (customDropSoundBuffer) {
+                playEffect(*customDropSoundBuffer, SfxCategory::Drop, spaceVolume);
+            } else {
+                playBuiltinEffect(SfxId::Space, SfxCategory::Drop, spaceVolume);
+            }
+            break;
+        case AudioCommandType::RequestMusic:
+            requestMusic(command.path, command.volume, command.looping, command.restart);
+            break;
+        case AudioCommandType::StopAllMusic:
+            stopMusicStreams();
+            break;
+        case AudioCommandType::SetVolumes:
+            mixMasterVolume = command.volume;
+            mixMusicVolume = command.musicVolume;
+            mixSfxVolume = command.sfxVolume;
+            updateAllVolumes();
+            break;
+        case AudioCommandType::SetLineClearSound:
+            assignCustomSound(command.path, customLineClearBuffer, currentLineClearSoundPath, "line clear");
+            break;
+        case AudioCommandType::SetDropSound:
+            assignCustomSound(command.path, customDropSoundBuffer, currentDropSoundPath, "drop");
+            break;
+        case AudioCommandType::PrefetchSound:
+            soundCache.prefetch(command.path);
+            break;
+    }
+}
 
-
-    if (stompSoundBuffer.loadFromFile("Assets/Sound/SFX/stomp.ogg")) {
-        stompSound = std::make_unique<sf::Sound>(stompSoundBuffer);
-        stompSound->setVolume((bombVolume * masterVolume) / 100.0f);
-        std::cout << "Stomp sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load stomp sound (Assets/Sound/SFX/stomp.ogg)" << std::endl;
-        allLoaded = false;
+bool AudioManager::loadAllAudio() {
+    if (!backend->hasDevice()) {
+        std::cout << "Audio disabled: no audio device backend" << std::endl;
+        return true;
     }
 
+    bool allLoaded = true;
 
-    if (deliverySoundBuffer.loadFromFile("Assets/Sound/SFX/delivery.ogg")) {
-        deliverySound = std::make_unique<sf::Sound>(deliverySoundBuffer);
-        deliverySound->setVolume((bombVolume * masterVolume) / 100.0f);
-        std::cout << "Delivery sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load delivery sound (Assets/Sound/SFX/delivery.ogg)" << std::endl;
-        allLoaded = false;
+
+    for (const std::string& musicPath : {SPLASH_MUSIC_PATH, MENU_MUSIC_PATH, GAMEPLAY_MUSIC_PATH, GAME_WIN_MUSIC_PATH}) {
+        if (!assetExists(musicPath)) {
+            std::cout << "Unable to find music (" << musicPath << ")" << std::endl;
+            allLoaded = false;
+        }
     }
 
 
-    if (achievementSoundBuffer.loadFromFile("Assets/Sound/SFX/Achievement.ogg")) {
-        achievementSound = std::make_unique<sf::Sound>(achievementSoundBuffer);
-        achievementSound->setVolume((achievementVolume * masterVolume) / 100.0f);
-        std::cout << "Achievement sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load achievement sound (Assets/Sound/SFX/Achievement.ogg)" << std::endl;
-        allLoaded = false;
+    for (std::unique_ptr<sf::SoundBuffer>& buffer : sfxBuffers) {
+        buffer = std::make_unique<sf::SoundBuffer>();
+    }
+    int workerCount = std::max(1, std::min<int>(SFX_DECODE_MAX_WORKERS, std::thread::hardware_concurrency()));
+    for (int i = 0; i < workerCount; i++) {
+        sfxDecodeWorkers.push_back(std::async(std::launch::async, &AudioManager::decodeBuiltinEffects, this));
     }
+    std::cout << "Decoding " << SFX_ID_COUNT << " sound effects on " << workerCount << " threads" << std::endl;
 
+    return allLoaded;
+}
 
-    if (gameOverSoundBuffer.loadFromFile("Assets/Sound/SFX/Game_Over.ogg")) {
-        gameOverSound = std::make_unique<sf::Sound>(gameOverSoundBuffer);
-        gameOverSound->setVolume((gameOverVolume * masterVolume) / 100.0f);
-        std::cout << "Game Over sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load game over sound (Assets/Sound/SFX/Game_Over.ogg)" << std::endl;
-        allLoaded = false;
-    }
+void AudioManager::updateAllVolumes() {
 
 
-    if (menuClickSoundBuffer.loadFromFile("Assets/Sound/SFX/Menu_Click.ogg")) {
-        menuClickSound = std::make_unique<sf::Sound>(menuClickSoundBuffer);
-        menuClickSound->setVolume((menuClickVolume * masterVolume) / 100.0f);
-        std::cout << "Menu Click sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load menu click sound (Assets/Sound/SFX/Menu_Click.ogg)" << std::endl;
-        allLoaded = false;
-    }
+    float sfxEffective = (mixMasterVolume * mixSfxVolume) / 100.0f;
 
 
-    if (menuBackSoundBuffer.loadFromFile("Assets/Sound/SFX/Menu_Back.ogg")) {
-        menuBackSound = std::make_unique<sf::Sound>(menuBackSoundBuffer);
-        menuBackSound->setVolume((menuBackVolume * masterVolume) / 100.0f);
-        std::cout << "Menu Back sound loaded successfully!" << std::endl;
-    } else {
-        std::cout << "Unable to load menu back sound (Assets/Sound/SFX/Menu_Back.ogg)" << std::endl;
-        allLoaded = false;
-    }
+    applyMusicVolumes();
 
 
-    wowSoundBuffers.resize(3);
-    wowSounds.resize(3);
-    for (int i = 0; i < 3; i++) {
-        std::string filename = "Assets/Sound/SFX/wow_0" + std::to_string(i + 1) + ".ogg";
-        if (wowSoundBuffers[i].loadFromFile(filename)) {
-            wowSounds[i] = std::make_unique<sf::Sound>(wowSoundBuffers[i]);
-            wowSounds[i]->setVolume((wowVolume * masterVolume) / 100.0f);
-            std::cout << "Wow sound loaded successfully: " << filename << std::endl;
-        } else {
-            std::cout << "Unable to load wow sound: " << filename << std::endl;
-            allLoaded = false;
+    for (SfxVoice& voice : voices) {
+        if (voice.sound) {
+            voice.sound->setVolume((voice.baseVolume * sfxEffective) / 100.0f);
         }
     }
+}
 
-    return allLoaded;
+void AudioManager::playMenuMusic() {
+    postMusic(MENU_MUSIC_PATH, menuMusicVolume, true, false);
 }
 
-void AudioManager::updateAllVolumes() {
+void AudioManager::playGameplayMusic() {
+    postMusic(GAMEPLAY_MUSIC_PATH, gameplayMusicVolume, true, false);
+}
 
+void AudioManager::playSplashMusic() {
+    postMusic(SPLASH_MUSIC_PATH, splashMusicVolume, false, true);
+}
 
-    float musicEffective = (masterVolume * musicVolumeMultiplier) / 100.0f;
-    float sfxEffective = (masterVolume * sfxVolumeMultiplier) / 100.0f;
+void AudioManager::playGameWinSound() {
+    postMusic(GAME_WIN_MUSIC_PATH, gameWinMusicVolume, false, true);
+    std::cout << "Playing Game Win music!" << std::endl;
+}
 
+void AudioManager::switchToGameplayMusic() {
+    playGameplayMusic();
+}
 
-    menuMusic.setVolume((menuMusicVolume * musicEffective) / 100.0f);
-    gameplayMusic.setVolume((gameplayMusicVolume * musicEffective) / 100.0f);
-    splashMusic.setVolume((splashMusicVolume * musicEffective) / 100.0f);
-    gameWinMusic.setVolume((gameWinMusicVolume * musicEffective) / 100.0f);
-    themeMusic.setVolume((gameplayMusicVolume * musicEffective) / 100.0f);
+void AudioManager::switchToMenuMusic() {
+    playMenuMusic();
+}
 
+void AudioManager::stopAllMusic() {
+    requestedMusicPath.clear();
+    AudioCommand command;
+    command.type = AudioCommandType::StopAllMusic;
+    postCommand(std::move(command), false);
+}
 
-    if (spaceSound) {
-        spaceSound->setVolume((spaceVolume * sfxEffective) / 100.0f);
-    }
-    if (laserSound) {
-        laserSound->setVolume((laserVolume * sfxEffective) / 100.0f);
+
+void AudioManager::stopMusicStreams() {
+    if (currentSlot.music) currentSlot.music->stop();
+    if (fadingSlot.music) fadingSlot.music->stop();
+    currentSlot = MusicSlot();
+    fadingSlot = MusicSlot();
+    hasQueuedRequest = false;
+    discardPendingMusic = pendingMusic.valid();
+    currentMusicPath.clear();
+}
+
+
+// Requests are served one at a time; a request made while another track is
+// still opening replaces whatever was queued behind it.
+void AudioManager::requestMusic(const std::string& path, float baseVolume, bool looping, bool restartIfCurrent) {
+    if (!restartIfCurrent && path == currentMusicPath) {
+        return;
     }
-    if (bombSound) {
-        bombSound->setVolume((bombVolume * sfxEffective) / 100.0f);
+    currentMusicPath = path;
+
+    MusicRequest request{path, baseVolume, looping};
+    if (pendingMusic.valid()) {
+        queuedRequest = request;
+        hasQueuedRequest = true;
+        discardPendingMusic = true;
+        return;
     }
-    if (achievementSound) {
-        achievementSound->setVolume((achievementVolume * sfxEffective) / 100.0f);
+    startMusicLoad(request);
+}
+
+void AudioManager::startMusicLoad(const MusicRequest& request) {
+    pendingRequest = request;
+    discardPendingMusic = false;
+    pendingMusic = std::async(std::launch::async, [this, path = request.path, looping = request.looping]() {
+        std::unique_ptr<sf::Music> music = backend->openMusic(path);
+        if (music) {
+            music->setLooping(looping);
+        }
+        return music;
+    });
+}
+
+void AudioManager::finishMusicLoad() {
+    std::unique_ptr<sf::Music> music = pendingMusic.get();
+
+    if (discardPendingMusic) {
+        discardPendingMusic = false;
+    } else if (!music) {
+        std::cout << "Failed to load music: " << pendingRequest.path << std::endl;
+        if (pendingRequest.path != GAMEPLAY_MUSIC_PATH && pendingRequest.path != SPLASH_MUSIC_PATH &&
+            pendingRequest.path != GAME_WIN_MUSIC_PATH && pendingRequest.path != MENU_MUSIC_PATH) {
+            std::cout << "Falling back to default gameplay music" << std::endl;
+            queuedRequest = {GAMEPLAY_MUSIC_PATH, gameplayMusicVolume, true};
+            hasQueuedRequest = true;
+            currentMusicPath = GAMEPLAY_MUSIC_PATH;
+        }
+    } else {
+        if (fadingSlot.music) fadingSlot.music->stop();
+        fadingSlot = std::move(currentSlot);
+        currentSlot = MusicSlot();
+        currentSlot.music = std::move(music);
+        currentSlot.path = pendingRequest.path;
+        currentSlot.baseVolume = pendingRequest.baseVolume;
+        currentSlot.fade = fadingSlot.music ? 0.0f : 1.0f;
+        applyMusicVolumes();
+        currentSlot.music->play();
+        std::cout << "Music started: " << currentSlot.path << std::endl;
     }
-    if (gameOverSound) {
-        gameOverSound->setVolume((gameOverVolume * sfxEffective) / 100.0f);
+
+    if (hasQueuedRequest) {
+        hasQueuedRequest = false;
+        startMusicLoad(queuedRequest);
     }
-    if (menuClickSound) {
-        menuClickSound->setVolume((menuClickVolume * sfxEffective) / 100.0f);
+}
+
+void AudioManager::updateMixer(float deltaTime) {
+    reportBuiltinDecodes();
+    soundCache.poll();
+
+    if (pendingMusic.valid() && pendingMusic.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        finishMusicLoad();
     }
-    if (menuBackSound) {
-        menuBackSound->setVolume((menuBackVolume * sfxEffective) / 100.0f);
+
+    int playing = 0;
+    for (const SfxVoice& voice : voices) {
+        if (isVoicePlaying(voice)) ++playing;
     }
-    if (customLineClearSound) {
-        customLineClearSound->setVolume((laserVolume * sfxEffective) / 100.0f);
+    activeVoiceCount.store(playing, std::memory_order_relaxed);
+
+    if (!fadingSlot.music && currentSlot.fade >= 1.0f) {
+        return;
     }
-    if (customDropSound) {
-        customDropSound->setVolume((spaceVolume * sfxEffective) / 100.0f);
+    float step = deltaTime / MUSIC_CROSSFADE_SECONDS;
+    currentSlot.fade = std::min(1.0f, currentSlot.fade + step);
+    if (fadingSlot.music) {
+        fadingSlot.fade -= step;
+        if (fadingSlot.fade <= 0.0f) {
+            fadingSlot.music->stop();
+            fadingSlot = MusicSlot();
+        }
     }
-    for (auto& wowSound : wowSounds) {
-        if (wowSound) {
-            wowSound->setVolume((wowVolume * sfxEffective) / 100.0f);
+    applyMusicVolumes();
+}
+
+void AudioManager::applyMusicVolumes() {
+    float musicEffective = (mixMasterVolume * mixMusicVolume) / 100.0f;
+    for (MusicSlot* slot : {&currentSlot, &fadingSlot}) {
+        if (slot->music) {
+            slot->music->setVolume((slot->baseVolume * musicEffective * slot->fade) / 100.0f);
         }
     }
 }
 
-void AudioManager::playMenuMusic() {
-    if (currentMusic != &menuMusic) {
-        if (currentMusic) {
-            currentMusic->stop();
+// Worker loop: claim the next undecoded effect until none are left. Nothing
+// here writes to std::cout, which the main thread may be redirecting.
+void AudioManager::decodeBuiltinEffects() {
+    traceSetThreadName("sfx decode");
+    int id;
+    while ((id = nextSfxDecode.fetch_add(1)) < SFX_ID_COUNT) {
+        if (backend->decodeSound(SFX_FILE_PATHS[id], *sfxBuffers[id])) {
+            sfxReady[id].store(true, std::memory_order_release);
+        } else {
+            sfxFailed[id].store(true, std::memory_order_release);
         }
-        menuMusic.play();
-        currentMusic = &menuMusic;
     }
 }
 
-void AudioManager::playGameplayMusic() {
-    if (currentMusic != &gameplayMusic) {
-        if (currentMusic) {
-            currentMusic->stop();
+void AudioManager::reportBuiltinDecodes() {
+    if (sfxDecodeReported) {
+        return;
+    }
+    int loaded = 0;
+    for (int id = 0; id < SFX_ID_COUNT; id++) {
+        if (sfxReady[id].load(std::memory_order_acquire)) {
+            loaded++;
+        } else if (!sfxFailed[id].load(std::memory_order_acquire)) {
+            return;
+        }
+    }
+    sfxDecodeReported = true;
+    std::cout << "Sound effects decoded: " << loaded << "/" << SFX_ID_COUNT << std::endl;
+    for (int id = 0; id < SFX_ID_COUNT; id++) {
+        if (sfxFailed[id].load(std::memory_order_acquire)) {
+            std::cout << "Unable to load sound effect (" << SFX_FILE_PATHS[id] << ")" << std::endl;
         }
-        gameplayMusic.play();
-        currentMusic = &gameplayMusic;
     }
 }
 
-void AudioManager::playSplashMusic() {
-    if (currentMusic) {
-        currentMusic->stop();
+bool AudioManager::isVoicePlaying(const SfxVoice& voice) const {
+    return voice.sound && voice.sound->getStatus() == sf::Sound::Status::Playing;
+}
+
+// A category at its limit recycles its own oldest voice; otherwise a free
+// voice is used, and with none free the lowest-priority, oldest voice is
+// stolen unless everything playing outranks the new effect.
+SfxVoice* AudioManager::acquireVoice(SfxCategory category, int priority) {
+    int limit = SFX_CATEGORY_VOICE_LIMITS[static_cast<int>(category)];
+    int playingInCategory = 0;
+    SfxVoice* oldestInCategory = nullptr;
+    SfxVoice* freeVoice = nullptr;
+    SfxVoice* weakestVoice = nullptr;
+
+    for (SfxVoice& voice : voices) {
+        if (!isVoicePlaying(voice)) {
+            if (!freeVoice) freeVoice = &voice;
+            continue;
+        }
+        if (voice.category == category) {
+            ++playingInCategory;
+            if (!oldestInCategory || voice.startedAt < oldestInCategory->startedAt) {
+                oldestInCategory = &voice;
+            }
+        }
+        if (!weakestVoice || voice.priority < weakestVoice->priority ||
+            (voice.priority == weakestVoice->priority && voice.startedAt < weakestVoice->startedAt)) {
+            weakestVoice = &voice;
+        }
     }
-    splashMusic.play();
-    currentMusic = &splashMusic;
+
+    if (playingInCategory >= limit) return oldestInCategory;
+    if (freeVoice) return freeVoice;
+    if (weakestVoice && weakestVoice->priority <= priority) return weakestVoice;
+    return nullptr;
 }
 
-void AudioManager::playGameWinSound() {
-    if (currentMusic) {
-        currentMusic->stop();
+void AudioManager::playEffect(const sf::SoundBuffer& buffer, SfxCategory category, float volume) {
+    if (!isBufferLoaded(buffer)) {
+        return;
     }
-    gameWinMusic.play();
-    currentMusic = &gameWinMusic;
-    std::cout << "Playing Game Win music!" << std::endl;
+
+    int priority = SFX_CATEGORY_PRIORITIES[static_cast<int>(category)];
+    SfxVoice* voice = acquireVoice(category, priority);
+    if (!voice) {
+        return;
+    }
+
+    if (voice->sound) {
+        voice->sound->stop();
+        voice->sound->setBuffer(buffer);
+    } else {
+        voice->sound = backend->createSound(buffer);
+        if (!voice->sound) {
+            return;
+        }
+    }
+    voice->category = category;
+    voice->priority = priority;
+    voice->baseVolume = volume;
+    voice->startedAt = ++voiceSequence;
+
+    float sfxEffective = (mixMasterVolume * mixSfxVolume) / 100.0f;
+    voice->sound->setVolume((volume * sfxEffective) / 100.0f);
+    voice->sound->play();
 }
 
-void AudioManager::switchToGameplayMusic() {
-    playGameplayMusic();
+int AudioManager::getActiveVoiceCount() const {
+    return activeVoiceCount.load(std::memory_order_relaxed);
 }
 
-void AudioManager::switchToMenuMusic() {
-    playMenuMusic();
+// Fraction of the built-in effects that have finished decoding, failed or not.
+float AudioManager::getLoadProgress() const {
+    if (!backend->hasDevice() || sfxDecodeWorkers.empty()) {
+        return 1.0f;
+    }
+    int settled = 0;
+    for (int i = 0; i < SFX_ID_COUNT; i++) {
+        if (sfxReady[i].load(std::memory_order_acquire) || sfxFailed[i].load(std::memory_order_acquire)) {
+            ++settled;
+        }
+    }
+    return static_cast<float>(settled) / static_cast<float>(SFX_ID_COUNT);
 }
 
-void AudioManager::stopAllMusic() {
-    splashMusic.stop();
-    menuMusic.stop();
-    gameplayMusic.stop();
-    gameWinMusic.stop();
-    themeMusic.stop();
-    currentMusic = nullptr;
+void AudioManager::playBuiltinEffect(SfxId id, SfxCategory category, float volume) {
+    int index = static_cast<int>(id);
+    if (sfxReady[index].load(std::memory_order_acquire)) {
+        playEffect(*sfxBuffers[index], category, volume);
+    }
 }
 
 void AudioManager::playSpaceSound() {
-    if (spaceSound) {
-        spaceSound->play();
-    }
+    postEffect(SfxId::Space, SfxCategory::Drop, spaceVolume);
 }
 
 void AudioManager::playLaserSound() {
-    if (laserSound) {
-        laserSound->play();
-    }
+    postEffect(SfxId::Laser, SfxCategory::LineClear, laserVolume);
 }
 
 void AudioManager::playBombSound() {
-    if (bombSound) {
-        bombSound->play();
-    }
+    postEffect(SfxId::Bomb, SfxCategory::Ability, bombVolume);
 }
 
 void AudioManager::playStompSound() {
-    if (stompSound) {
-        stompSound->play();
-    }
+    postEffect(SfxId::Stomp, SfxCategory::Ability, bombVolume);
 }
 
 void AudioManager::playDeliverySound() {
-    if (deliverySound) {
-        deliverySound->play();
-    }
+    postEffect(SfxId::Delivery, SfxCategory::Ability, bombVolume);
 }
 
 void AudioManager::playAchievementSound() {
-    if (achievementSound) {
-        achievementSound->play();
-    }
+    postEffect(SfxId::Achievement, SfxCategory::Jingle, achievementVolume);
 }
 
 void AudioManager::playGameOverSound() {
-    if (gameOverSound) {
-        gameOverSound->play();
-    }
+    postEffect(SfxId::GameOver, SfxCategory::Jingle, gameOverVolume);
 }
 
 void AudioManager::playWowSound(int index) {
-    if (index >= 0 && index < static_cast<int>(wowSounds.size()) && wowSounds[index]) {
-        wowSounds[index]->play();
+    if (index >= 0 && index < 3) {
+        postEffect(static_cast<SfxId>(static_cast<int>(SfxId::Wow1) + index), SfxCategory::Voice, wowVolume);
     }
 }
 
 void AudioManager::playMenuClickSound() {
-    if (menuClickSound) {
-        menuClickSound->play();
-    }
+    postEffect(SfxId::MenuClick, SfxCategory::Menu, menuClickVolume);
 }
 
 void AudioManager::playMenuBackSound() {
-    if (menuBackSound) {
-        menuBackSound->play();
-    }
+    postEffect(SfxId::MenuBack, SfxCategory::Menu, menuBackVolume);
 }
 
 void AudioManager::setMasterVolume(float volume) {
     masterVolume = std::max(0.0f, std::min(100.0f, volume));
-    updateAllVolumes();
+    postVolumes();
 }
 
 float AudioManager::getMasterVolume() const {
@@ -334,7 +542,7 @@ float AudioManager::getMasterVolume() const {
 
 void AudioManager::setMusicVolume(float volume) {
     musicVolumeMultiplier = std::max(0.0f, std::min(100.0f, volume));
-    updateAllVolumes();
+    postVolumes();
 }
 
 float AudioManager::getMusicVolume() const {
@@ -343,7 +551,7 @@ float AudioManager::getMusicVolume() const {
 
 void AudioManager::setSfxVolume(float volume) {
     sfxVolumeMultiplier = std::max(0.0f, std::min(100.0f, volume));
-    updateAllVolumes();
+    postVolumes();
 }
 
 float AudioManager::getSfxVolume() const {
@@ -353,7 +561,7 @@ float AudioManager::getSfxVolume() const {
 void AudioManager::increaseMasterVolume() {
     if (!isMuted && masterVolume < 100.0f) {
         masterVolume = std::min(100.0f, masterVolume + 10.0f);
-        updateAllVolumes();
+        postVolumes();
         std::cout << "Master volume increased to: " << masterVolume << "%" << std::endl;
     } else if (isMuted) {
         std::cout << "Cannot change volume while muted" << std::endl;
@@ -365,7 +573,7 @@ void AudioManager::increaseMasterVolume() {
 void AudioManager::decreaseMasterVolume() {
     if (!isMuted && masterVolume > 0.0f) {
         masterVolume = std::max(0.0f, masterVolume - 10.0f);
-        updateAllVolumes();
+        postVolumes();
         std::cout << "Master volume decreased to: " << masterVolume << "%" << std::endl;
     } else if (isMuted) {
         std::cout << "Cannot change volume while muted" << std::endl;
@@ -378,13 +586,13 @@ void AudioManager::toggleMute() {
     if (isMuted) {
         isMuted = false;
         masterVolume = lastMasterVolume;
-        updateAllVolumes();
+        postVolumes();
         std::cout << "Audio UNMUTED - Master volume restored to: " << masterVolume << "%" << std::endl;
     } else {
         isMuted = true;
         lastMasterVolume = masterVolume;
         masterVolume = 0.0f;
-        updateAllVolumes();
+        postVolumes();
         std::cout << "Audio MUTED" << std::endl;
     }
 }
@@ -393,113 +601,75 @@ bool AudioManager::isMutedStatus() const {
     return isMuted;
 }
 
+// Returns as soon as the track is queued; it fades in on the audio thread once
+// the stream has been opened off the main thread.
 bool AudioManager::playMusicFromPath(const std::string& musicPath, float volumeMultiplier) {
-
-    if (currentMusicPath == musicPath && currentMusic == &themeMusic && 
-        themeMusic.getStatus() == sf::Music::Status::Playing) {
-        return true;
-    }
-    
-
-    if (currentMusic) {
-        currentMusic->stop();
-    }
-    
-
-    if (themeMusic.openFromFile(musicPath)) {
-        themeMusic.setLooping(true);
-        float musicEffective = (masterVolume * musicVolumeMultiplier) / 100.0f;
-        themeMusic.setVolume((gameplayMusicVolume * musicEffective * volumeMultiplier) / 100.0f);
-        themeMusic.play();
-        currentMusic = &themeMusic;
-        currentMusicPath = musicPath;
-        std::cout << "Theme music loaded: " << musicPath << std::endl;
-        return true;
-    } else {
-        std::cout << "Failed to load theme music: " << musicPath << ", falling back to default" << std::endl;
-
-        playGameplayMusic();
-        currentMusicPath = "Assets/Sound/Music/Tessera_Main.ogg";
-        return false;
-    }
+    postMusic(musicPath, gameplayMusicVolume * volumeMultiplier, true, false);
+    return true;
 }
 
+// Custom theme sounds are resolved on the audio thread, so a cache miss
+// decodes there instead of on the frame.
 bool AudioManager::setLineClearSound(const std::string& soundPath) {
-
-    if (soundPath.empty()) {
-        currentLineClearSoundPath = "";
-        customLineClearSound.reset();
-        std::cout << "Line clear sound reset to default (laser)" << std::endl;
-        return true;
-    }
-    
-
-    if (currentLineClearSoundPath == soundPath && customLineClearSound) {
-        return true;
-    }
-    
-
-    if (customLineClearBuffer.loadFromFile(soundPath)) {
-        customLineClearSound = std::make_unique<sf::Sound>(customLineClearBuffer);
-        float sfxEffective = (masterVolume * sfxVolumeMultiplier) / 100.0f;
-        customLineClearSound->setVolume((laserVolume * sfxEffective) / 100.0f);
-        currentLineClearSoundPath = soundPath;
-        std::cout << "Custom line clear sound loaded: " << soundPath << std::endl;
-        return true;
-    } else {
-        std::cout << "Failed to load custom line clear sound: " << soundPath << ", using default" << std::endl;
-        currentLineClearSoundPath = "";
-        customLineClearSound.reset();
-        return false;
-    }
+    AudioCommand command;
+    command.type = AudioCommandType::SetLineClearSound;
+    command.path = soundPath;
+    postCommand(std::move(command), false);
+    return true;
 }
 
 void AudioManager::playLineClearSound() {
-
-    if (customLineClearSound && !currentLineClearSoundPath.empty()) {
-        customLineClearSound->play();
-    } else {
-
-        playLaserSound();
-    }
+    AudioCommand command;
+    command.type = AudioCommandType::PlayLineClear;
+    postCommand(std::move(command), true);
 }
 
 bool AudioManager::setDropSound(const std::string& soundPath) {
+    AudioCommand command;
+    command.type = AudioCommandType::SetDropSound;
+    command.path = soundPath;
+    postCommand(std::move(command), false);
+    return true;
+}
+
+void AudioManager::playDropSound() {
+    AudioCommand command;
+    command.type = AudioCommandType::PlayDrop;
+    postCommand(std::move(command), true);
+}
 
+bool AudioManager::assignCustomSound(const std::string& soundPath, std::shared_ptr<sf::SoundBuffer>& buffer, std::string& currentPath, const char* label) {
     if (soundPath.empty()) {
-        currentDropSoundPath = "";
-        customDropSound.reset();
-        std::cout << "Drop sound reset to default (ground)" << std::endl;
+        currentPath = "";
+        buffer.reset();
+        std::cout << "Custom " << label << " sound reset to default" << std::endl;
         return true;
     }
-    
 
-    if (currentDropSoundPath == soundPath && customDropSound) {
+    if (currentPath == soundPath) {
         return true;
     }
-    
 
-    if (customDropSoundBuffer.loadFromFile(soundPath)) {
-        customDropSound = std::make_unique<sf::Sound>(customDropSoundBuffer);
-        float sfxEffective = (masterVolume * sfxVolumeMultiplier) / 100.0f;
-        customDropSound->setVolume((spaceVolume * sfxEffective) / 100.0f);
-        currentDropSoundPath = soundPath;
-        std::cout << "Custom drop sound loaded: " << soundPath << std::endl;
+    std::shared_ptr<sf::SoundBuffer> loaded = soundCache.acquire(soundPath);
+    if (loaded) {
+        buffer = std::move(loaded);
+        currentPath = soundPath;
+        std::cout << "Custom " << label << " sound set: " << soundPath << std::endl;
         return true;
     } else {
-        std::cout << "Failed to load custom drop sound: " << soundPath << ", using default" << std::endl;
-        currentDropSoundPath = "";
-        customDropSound.reset();
+        std::cout << "Failed to load custom " << label << " sound: " << soundPath << ", using default" << std::endl;
+        buffer.reset();
+        currentPath = "";
         return false;
     }
 }
 
-void AudioManager::playDropSound() {
-
-    if (customDropSound && !currentDropSoundPath.empty()) {
-        customDropSound->play();
-    } else {
-
-        playSpaceSound();
+void AudioManager::prefetchSound(const std::string& soundPath) {
+    if (soundPath.empty()) {
+        return;
     }
+    AudioCommand command;
+    command.type = AudioCommandType::PrefetchSound;
+    command.path = soundPath;
+    postCommand(std::move(command), true);
 }
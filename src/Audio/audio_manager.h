@@ -2,52 +2,117 @@
 #define AUDIO_MANAGER_H
 
 #include <SFML/Audio.hpp>
+#include "audio_backend.h"
+#include "sound_buffer_cache.h"
+#include "spsc_queue.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <thread>
 #include <vector>
 #include <string>
 #include <iostream>
 
-class AudioManager {
-private:
 
-    sf::Music menuMusic;
-    sf::Music gameplayMusic;
-    sf::Music splashMusic;
-    sf::Music gameWinMusic;
-    sf::Music themeMusic;
-    sf::Music* currentMusic;
-    std::string currentMusicPath;
+enum class SfxCategory {
+    Drop,
+    LineClear,
+    Ability,
+    Voice,
+    Jingle,
+    Menu,
+    Count
+};
 
+constexpr int SFX_CATEGORY_COUNT = static_cast<int>(SfxCategory::Count);
 
-    sf::SoundBuffer spaceSoundBuffer;
-    sf::SoundBuffer customDropSoundBuffer;
-    sf::SoundBuffer laserSoundBuffer;
-    sf::SoundBuffer bombSoundBuffer;
-    sf::SoundBuffer stompSoundBuffer;
-    sf::SoundBuffer deliverySoundBuffer;
-    sf::SoundBuffer achievementSoundBuffer;
-    sf::SoundBuffer gameOverSoundBuffer;
-    sf::SoundBuffer menuClickSoundBuffer;
-    sf::SoundBuffer menuBackSoundBuffer;
-    sf::SoundBuffer customLineClearBuffer;
-    std::vector<sf::SoundBuffer> wowSoundBuffers;
-
-
-    std::unique_ptr<sf::Sound> spaceSound;
-    std::unique_ptr<sf::Sound> customDropSound;
-    std::unique_ptr<sf::Sound> laserSound;
-    std::unique_ptr<sf::Sound> bombSound;
-    std::unique_ptr<sf::Sound> stompSound;
-    std::unique_ptr<sf::Sound> deliverySound;
-    std::unique_ptr<sf::Sound> achievementSound;
-    std::unique_ptr<sf::Sound> gameOverSound;
-    std::unique_ptr<sf::Sound> menuClickSound;
-    std::unique_ptr<sf::Sound> menuBackSound;
-    std::unique_ptr<sf::Sound> customLineClearSound;
-    std::vector<std::unique_ptr<sf::Sound>> wowSounds;
-    
-    std::string currentLineClearSoundPath;
-    std::string currentDropSoundPath;
+
+enum class SfxId {
+    Space,
+    Laser,
+    Bomb,
+    Stomp,
+    Delivery,
+    Achievement,
+    GameOver,
+    MenuClick,
+    MenuBack,
+    Wow1,
+    Wow2,
+    Wow3,
+    Count
+};
+
+constexpr int SFX_ID_COUNT = static_cast<int>(SfxId::Count);
+constexpr int SFX_DECODE_MAX_WORKERS = 4;
+constexpr int SFX_VOICE_COUNT = 12;
+
+
+// One pooled sf::Sound. The sound object is created once and rebound to
+// whichever buffer the next effect needs, so bursts never allocate sources.
+struct SfxVoice {
+    std::unique_ptr<sf::Sound> sound;
+    SfxCategory category = SfxCategory::Menu;
+    int priority = 0;
+    float baseVolume = 100.0f;
+    std::uint64_t startedAt = 0;
+};
+
+constexpr float MUSIC_CROSSFADE_SECONDS = 0.6f;
+
+
+// A music track that is playing or fading. Tracks are opened on demand and
+// released once they fade out, so at most two streams are ever open.
+struct MusicSlot {
+    std::unique_ptr<sf::Music> music;
+    std::string path;
+    float baseVolume = 100.0f;
+    float fade = 0.0f;
+};
+
+struct MusicRequest {
+    std::string path;
+    float baseVolume = 100.0f;
+    bool looping = true;
+};
+
+enum class AudioCommandType {
+    PlayEffect,
+    PlayLineClear,
+    PlayDrop,
+    RequestMusic,
+    StopAllMusic,
+    SetVolumes,
+    SetLineClearSound,
+    SetDropSound,
+    PrefetchSound
+};
+
+struct AudioCommand {
+    AudioCommandType type = AudioCommandType::PlayEffect;
+    SfxId effect = SfxId::Space;
+    SfxCategory category = SfxCategory::Menu;
+    float volume = 0.0f;
+    float musicVolume = 0.0f;
+    float sfxVolume = 0.0f;
+    bool looping = false;
+    bool restart = false;
+    std::string path;
+};
+
+constexpr std::size_t AUDIO_COMMAND_QUEUE_CAPACITY = 256;
+constexpr int AUDIO_THREAD_IDLE_MS = 2;
+
+
+// The public interface only records settings and pushes commands; a
+// dedicated thread owns every sf::Sound and sf::Music and drains the queue.
+// With the null backend no thread is started and commands are dropped.
+class AudioManager {
+private:
+
+    std::unique_ptr<AudioBackend> backend;
 
 
     float masterVolume;
@@ -55,6 +120,48 @@ private:
     float sfxVolumeMultiplier;
     float lastMasterVolume;
     bool isMuted;
+    std::string requestedMusicPath;
+
+    SpscQueue<AudioCommand, AUDIO_COMMAND_QUEUE_CAPACITY> commandQueue;
+    std::atomic<bool> audioThreadRunning{false};
+    std::atomic<int> activeVoiceCount{0};
+    std::thread audioThread;
+
+
+    float mixMasterVolume = 100.0f;
+    float mixMusicVolume = 100.0f;
+    float mixSfxVolume = 100.0f;
+
+    MusicSlot currentSlot;
+    MusicSlot fadingSlot;
+    std::future<std::unique_ptr<sf::Music>> pendingMusic;
+    MusicRequest pendingRequest;
+    MusicRequest queuedRequest;
+    bool hasQueuedRequest = false;
+    bool discardPendingMusic = false;
+    std::string currentMusicPath;
+
+
+    // Built-in effects are decoded by a few workers while the splash plays.
+    // A buffer is only touched by the main thread once its flag is set.
+    // They are allocated in loadAllAudio, and only when there is a device.
+    std::array<std::unique_ptr<sf::SoundBuffer>, SFX_ID_COUNT> sfxBuffers;
+    std::array<std::atomic<bool>, SFX_ID_COUNT> sfxReady{};
+    std::array<std::atomic<bool>, SFX_ID_COUNT> sfxFailed{};
+    std::atomic<int> nextSfxDecode{0};
+    std::vector<std::future<void>> sfxDecodeWorkers;
+    bool sfxDecodeReported = false;
+
+    SoundBufferCache soundCache;
+    std::shared_ptr<sf::SoundBuffer> customLineClearBuffer;
+    std::shared_ptr<sf::SoundBuffer> customDropSoundBuffer;
+
+
+    std::array<SfxVoice, SFX_VOICE_COUNT> voices;
+    std::uint64_t voiceSequence = 0;
+    
+    std::string currentLineClearSoundPath;
+    std::string currentDropSoundPath;
 
 
     const float menuMusicVolume = 60.0f;
@@ -71,11 +178,34 @@ private:
     const float menuBackVolume = 100.0f;
 
 
+    void postCommand(AudioCommand&& command, bool droppable);
+    void postEffect(SfxId id, SfxCategory category, float volume);
+    void postMusic(const std::string& path, float baseVolume, bool looping, bool restartIfCurrent);
+    void postVolumes();
+
+    void runAudioThread();
+    void executeCommand(const AudioCommand& command);
+    void updateMixer(float deltaTime);
     void updateAllVolumes();
+    void applyMusicVolumes();
+    void requestMusic(const std::string& path, float baseVolume, bool looping, bool restartIfCurrent);
+    void stopMusicStreams();
+    bool assignCustomSound(const std::string& soundPath, std::shared_ptr<sf::SoundBuffer>& buffer, std::string& currentPath, const char* label);
+    void startMusicLoad(const MusicRequest& request);
+    void finishMusicLoad();
+    bool isBufferLoaded(const sf::SoundBuffer& buffer) const { return buffer.getSampleCount() > 0; }
+    bool isVoicePlaying(const SfxVoice& voice) const;
+    SfxVoice* acquireVoice(SfxCategory category, int priority);
+    void playEffect(const sf::SoundBuffer& buffer, SfxCategory category, float volume);
+    void playBuiltinEffect(SfxId id, SfxCategory category, float volume);
+    void decodeBuiltinEffects();
+    void reportBuiltinDecodes();
 
 public:
-    AudioManager();
-    ~AudioManager() = default;
+    explicit AudioManager(std::unique_ptr<AudioBackend> audioBackend = std::make_unique<SfmlAudioBackend>());
+    ~AudioManager();
+
+    bool hasAudioDevice() const { return backend->hasDevice(); }
 
 
     bool loadAllAudio();
@@ -91,7 +221,7 @@ public:
     
 
     bool playMusicFromPath(const std::string& musicPath, float volumeMultiplier = 1.0f);
-    std::string getCurrentMusicPath() const { return currentMusicPath; }
+    std::string getCurrentMusicPath() const { return requestedMusicPath; }
 
 
     void playSpaceSound();
@@ -113,6 +243,8 @@ public:
     bool setDropSound(const std::string& soundPath);
     void playDropSound();
 
+    void prefetchSound(const std::string& soundPath);
+
 
     void setMasterVolume(float volume);
     float getMasterVolume() const;
@@ -126,14 +258,8 @@ public:
     bool isMutedStatus() const;
 
 
-    sf::Sound* getSpaceSound() { return spaceSound.get(); }
-    sf::Sound* getLaserSound() { return laserSound.get(); }
-    sf::Sound* getBombSound() { return bombSound.get(); }
-    sf::Sound* getStompSound() { return stompSound.get(); }
-    sf::Sound* getDeliverySound() { return deliverySound.get(); }
-    sf::Sound* getAchievementSound() { return achievementSound.get(); }
-    sf::Sound* getGameOverSound() { return gameOverSound.get(); }
-    std::vector<std::unique_ptr<sf::Sound>>& getWowSounds() { return wowSounds; }
+    int getActiveVoiceCount() const;
+    float getLoadProgress() const;
 };
 
 #endif
@@ -0,0 +1,93 @@
+﻿#include "sound_buffer_cache.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+
+
+namespace {
+
+std::shared_ptr<sf::SoundBuffer> decodeSoundFile(AudioBackend& backend, const std::string& path) {
+    if (!backend.hasDevice()) {
+        return nullptr;
+    }
+    auto buffer = std::make_shared<sf::SoundBuffer>();
+    if (!backend.decodeSound(path, *buffer)) {
+        return nullptr;
+    }
+    return buffer;
+}
+
+}
+
+
+void SoundBufferCache::insert(const std::string& path, std::shared_ptr<sf::SoundBuffer> buffer) {
+    Entry entry;
+    entry.path = path;
+    entry.bytes = static_cast<std::size_t>(buffer->getSampleCount()) * sizeof(std::int16_t);
+    entry.buffer = std::move(buffer);
+    storedBytes += entry.bytes;
+    entries.push_front(std::move(entry));
+    index[path] = entries.begin();
+    evictToBudget();
+}
+
+// The most recently used entry is never evicted, so a single sound larger
+// than the budget still stays cached while it is the one being played.
+void SoundBufferCache::evictToBudget() {
+    while (storedBytes > SOUND_CACHE_BUDGET_BYTES && entries.size() > 1) {
+        Entry& oldest = entries.back();
+        std::cout << "Sound cache evicted: " << oldest.path << std::endl;
+        storedBytes -= oldest.bytes;
+        index.erase(oldest.path);
+        entries.pop_back();
+    }
+}
+
+
+std::shared_ptr<sf::SoundBuffer> SoundBufferCache::acquire(const std::string& path) {
+    auto found = index.find(path);
+    if (found != index.end()) {
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->buffer;
+    }
+
+    std::shared_ptr<sf::SoundBuffer> buffer;
+    auto inFlight = pending.find(path);
+    if (inFlight != pending.end()) {
+        buffer = inFlight->second.get();
+        pending.erase(inFlight);
+    } else {
+        buffer = decodeSoundFile(backend, path);
+    }
+    if (!buffer) {
+        return nullptr;
+    }
+    insert(path, buffer);
+    return buffer;
+}
+
+void SoundBufferCache::prefetch(const std::string& path) {
+    if (path.empty() || index.count(path) || pending.count(path) || failedPrefetches.count(path)) {
+        return;
+    }
+    pending[path] = std::async(std::launch::async, decodeSoundFile, std::ref(backend), path);
+}
+
+void SoundBufferCache::poll() {
+    for (auto it = pending.begin(); it != pending.end(); ) {
+        if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        std::shared_ptr<sf::SoundBuffer> buffer = it->second.get();
+        if (buffer) {
+            std::cout << "Prefetched sound: " << it->first << std::endl;
+            insert(it->first, std::move(buffer));
+        } else {
+            std::cout << "Failed to prefetch sound: " << it->first << std::endl;
+            failedPrefetches.insert(it->first);
+        }
+        it = pending.erase(it);
+    }
+}
@@ -0,0 +1,49 @@
+﻿#ifndef SOUND_BUFFER_CACHE_H
+#define SOUND_BUFFER_CACHE_H
+
+#include <SFML/Audio.hpp>
+#include "audio_backend.h"
+#include <cstddef>
+#include <future>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+
+constexpr std::size_t SOUND_CACHE_BUDGET_BYTES = 24 * 1024 * 1024;
+
+
+// Decoded sound buffers keyed by file path, evicted least-recently-used
+// once the decoded size passes the budget. Buffers are shared so one that
+// is still assigned to an effect outlives its eviction from the cache.
+class SoundBufferCache {
+private:
+    struct Entry {
+        std::string path;
+        std::shared_ptr<sf::SoundBuffer> buffer;
+        std::size_t bytes = 0;
+    };
+
+    AudioBackend& backend;
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    std::unordered_map<std::string, std::future<std::shared_ptr<sf::SoundBuffer>>> pending;
+    std::unordered_set<std::string> failedPrefetches;
+    std::size_t storedBytes = 0;
+
+    void insert(const std::string& path, std::shared_ptr<sf::SoundBuffer> buffer);
+    void evictToBudget();
+
+public:
+    explicit SoundBufferCache(AudioBackend& audioBackend) : backend(audioBackend) {}
+
+    std::shared_ptr<sf::SoundBuffer> acquire(const std::string& path);
+    void prefetch(const std::string& path);
+    void poll();
+
+    std::size_t getStoredBytes() const { return storedBytes; }
+};
+
+#endif
@@ -0,0 +1,43 @@
+﻿#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+
+// Bounded single-producer/single-consumer ring. push() is only ever called
+// from one thread and pop() from one other thread; neither blocks or locks.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+private:
+    std::array<T, Capacity> slots;
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+
+public:
+    bool push(T&& value) {
+        std::size_t writeIndex = tail.load(std::memory_order_relaxed);
+        if (writeIndex - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[writeIndex & (Capacity - 1)] = std::move(value);
+        tail.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        std::size_t readIndex = head.load(std::memory_order_relaxed);
+        if (readIndex == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots[readIndex & (Capacity - 1)]);
+        head.store(readIndex + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif
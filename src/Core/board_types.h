@@ -0,0 +1,38 @@
+﻿#pragma once
+
+
+// Board size and piece identities without any SFML dependency, so the
+// simulator library can share them with the game.
+constexpr int GRID_WIDTH = 11;
+constexpr int GRID_HEIGHT = 22;
+
+
+enum class PieceType {
+    I_Basic,
+    T_Basic,
+    L_Basic,
+    J_Basic,
+    O_Basic,
+    S_Basic,
+    Z_Basic,
+
+    I_Medium,
+    T_Medium,
+    L_Medium,
+    J_Medium,
+    O_Medium,
+    S_Medium,
+    Z_Medium,
+
+    I_Hard,
+    T_Hard,
+    L_Hard,
+    J_Hard,
+    O_Hard,
+    S_Hard,
+    Z_Hard,
+
+    Cream_Single,
+    A_Bomb,
+    A_Stomp
+};
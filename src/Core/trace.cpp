@@ -0,0 +1,176 @@
+﻿#include "trace.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+const char* const TRACE_DEFAULT_FILE = "tessera_trace.json";
+
+namespace {
+
+struct TraceEvent {
+    const char* name = nullptr;
+    std::string detail;
+    std::int64_t startMicros = 0;
+    std::int64_t durationMicros = 0;
+    int threadId = 0;
+    bool instant = false;
+};
+
+struct TraceState {
+    // Set once from main() before any other thread starts, then only read.
+    bool enabled = false;
+    std::string outputPath;
+    std::chrono::steady_clock::time_point origin;
+
+    std::mutex mutex;
+    std::vector<TraceEvent> ring;
+    std::uint64_t written = 0;
+    std::vector<std::pair<int, std::string>> threadNames;
+    std::atomic<int> nextThreadId{1};
+};
+
+TraceState& state() {
+    static TraceState traceState;
+    return traceState;
+}
+
+std::int64_t nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - state().origin).count();
+}
+
+int currentThreadId() {
+    thread_local int id = state().nextThreadId.fetch_add(1);
+    return id;
+}
+
+void record(const char* name, std::string&& detail, std::int64_t start, std::int64_t duration, bool instant) {
+    TraceState& trace = state();
+    int threadId = currentThreadId();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    TraceEvent& event = trace.ring[trace.written % trace.ring.size()];
+    event.name = name;
+    event.detail = std::move(detail);
+    event.startMicros = start;
+    event.durationMicros = duration;
+    event.threadId = threadId;
+    event.instant = instant;
+    trace.written++;
+}
+
+void writeEscaped(std::ostream& out, const std::string& text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+}
+
+} // namespace
+
+
+void traceEnable(const std::string& outputPath) {
+    TraceState& trace = state();
+    trace.origin = std::chrono::steady_clock::now();
+    trace.outputPath = outputPath;
+    trace.ring.resize(TRACE_RING_CAPACITY);
+    trace.enabled = true;
+}
+
+bool traceEnabled() {
+    return state().enabled;
+}
+
+void traceSetThreadName(const char* name) {
+    TraceState& trace = state();
+    if (!trace.enabled) return;
+    int threadId = currentThreadId();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    for (auto& entry : trace.threadNames) {
+        if (entry.first == threadId) {
+            entry.second = name;
+            return;
+        }
+    }
+    trace.threadNames.emplace_back(threadId, name);
+}
+
+void traceInstant(const char* name) {
+    if (!state().enabled) return;
+    record(name, std::string(), nowMicros(), 0, true);
+}
+
+bool traceWrite() {
+    TraceState& trace = state();
+    if (!trace.enabled) return false;
+
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    std::ofstream out(trace.outputPath, std::ios::trunc);
+    if (!out) {
+        std::cout << "Failed to write trace: " << trace.outputPath << std::endl;
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& entry : trace.threadNames) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << entry.first
+            << ",\"args\":{\"name\":\"";
+        writeEscaped(out, entry.second);
+        out << "\"}}";
+        first = false;
+    }
+
+    std::uint64_t capacity = trace.ring.size();
+    std::uint64_t begin = trace.written > capacity ? trace.written - capacity : 0;
+    for (std::uint64_t i = begin; i < trace.written; ++i) {
+        const TraceEvent& event = trace.ring[i % capacity];
+        out << (first ? "" : ",\n") << "{\"name\":\"";
+        writeEscaped(out, event.name);
+        out << "\",\"ph\":\"" << (event.instant ? "i\",\"s\":\"g" : "X") << "\",\"pid\":1,\"tid\":" << event.threadId
+            << ",\"ts\":" << event.startMicros;
+        if (!event.instant) {
+            out << ",\"dur\":" << event.durationMicros;
+        }
+        if (!event.detail.empty()) {
+            out << ",\"args\":{\"detail\":\"";
+            writeEscaped(out, event.detail);
+            out << "\"}";
+        }
+        out << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+
+    std::cout << "Trace written: " << trace.outputPath << " (" << (trace.written - begin) << " events"
+              << (begin > 0 ? ", oldest dropped" : "") << ")" << std::endl;
+    return static_cast<bool>(out);
+}
+
+
+TraceZone::TraceZone(const char* zoneName, const std::string& zoneDetail)
+    : name(zoneName)
+{
+    if (state().enabled) {
+        detail = zoneDetail;
+        startMicros = nowMicros();
+        active = true;
+    }
+}
+
+TraceZone::~TraceZone() {
+    finish();
+}
+
+void TraceZone::finish() {
+    if (!active) return;
+    active = false;
+    record(name, std::move(detail), startMicros, nowMicros() - startMicros, false);
+}
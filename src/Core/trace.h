@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+constexpr std::size_t TRACE_RING_CAPACITY = 1 << 17;
+extern const char* const TRACE_DEFAULT_FILE;
+
+
+// Optional timeline of where startup and each frame spend their time,
+// written as Chrome trace JSON (chrome://tracing, ui.perfetto.dev). Off
+// unless --trace is passed; a disabled zone costs one branch. Events go into
+// a fixed ring, so a long session keeps only its most recent stretch.
+void traceEnable(const std::string& outputPath);
+bool traceEnabled();
+void traceSetThreadName(const char* name);
+void traceInstant(const char* name);
+bool traceWrite();
+
+
+// Times the enclosing scope, or up to an explicit finish() for phases that
+// do not line up with a block. name must be a string literal; detail is for
+// per-item context such as an asset path, copied only while tracing is on.
+class TraceZone {
+public:
+    explicit TraceZone(const char* zoneName, const std::string& zoneDetail = std::string());
+    ~TraceZone();
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+    void finish();
+
+private:
+    const char* name;
+    std::string detail;
+    std::int64_t startMicros = 0;
+    bool active = false;
+};
@@ -1,8 +1,10 @@
 ﻿#pragma once
 
+#include "board_types.h"
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 #include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
@@ -16,8 +18,6 @@ struct BagLevelConfig;
 enum class Achievement;
 
 
-constexpr int GRID_WIDTH = 11;
-constexpr int GRID_HEIGHT = 22;
 constexpr float CELL_SIZE = 32.0f;
 constexpr int MAX_LEVEL = 10;
 constexpr int LEVEL_THRESHOLDS[MAX_LEVEL + 1] = {
@@ -85,7 +85,6 @@ constexpr float GRID_OFFSET_X = (1920 - GRID_WIDTH * CELL_SIZE) / 2.0f;
 constexpr float GRID_OFFSET_Y = (1080 - GRID_HEIGHT * CELL_SIZE) / 2.0f;
 
 
-enum class PieceType;
 struct PieceShape;
 enum class TextureType;
 PieceShape getPieceShape(PieceType type);
@@ -264,6 +263,27 @@ struct KeyBindings {
 };
 
 
+constexpr int MODE_STATS_SLOTS = 20;
+constexpr int STATS_CLEAR_TYPES = 6;
+
+
+// Running totals for one mode/difficulty slot, folded in as each game ends.
+// The recent* fields are exponential moving averages over the last games.
+struct ModeStats {
+    int gamesPlayed = 0;
+    int gamesCompleted = 0;
+    std::int64_t totalScore = 0;
+    int bestScore = 0;
+    int totalLines = 0;
+    int totalPieces = 0;
+    float totalPlayTimeSeconds = 0.0f;
+    int clearCounts[STATS_CLEAR_TYPES] = {};
+    float recentScore = 0.0f;
+    float recentLinesPerMinute = 0.0f;
+    float recentPiecesPerSecond = 0.0f;
+};
+
+
 struct SaveData {
 
     int highScoreClassicNormal = 0;
@@ -306,6 +326,8 @@ struct SaveData {
     int totalHolds = 0;
     int totalPerfectClears = 0;
     
+    ModeStats modeStats[MODE_STATS_SLOTS];
+    
 
     int highScore = 0;
     
@@ -356,37 +378,6 @@ enum class DifficultyLevel {
 };
 
 
-enum class PieceType {
-    I_Basic,
-    T_Basic,
-    L_Basic,
-    J_Basic,
-    O_Basic,
-    S_Basic,
-    Z_Basic,
-
-    I_Medium,
-    T_Medium,
-    L_Medium,
-    J_Medium,
-    O_Medium,
-    S_Medium,
-    Z_Medium,
-
-    I_Hard,
-    T_Hard,
-    L_Hard,
-    J_Hard,
-    O_Hard,
-    S_Hard,
-    Z_Hard,
-
-    Cream_Single,
-    A_Bomb,
-    A_Stomp
-};
-
-
 enum class AbilityType {
     None,
     Bomb,
@@ -608,6 +599,24 @@ struct BackgroundPiece {
 };
 
 
+// Everything needed to continue a bag bit-exactly; every shuffle seeds the
+// RNG from the bag seed and its own index, so the count is all it needs.
+struct PieceBagState {
+    std::vector<PieceType> currentBag;
+    std::vector<PieceType> nextBag;
+    std::vector<PieceType> nextQueue;
+    std::vector<PieceType> mediumBag;
+    std::vector<PieceType> hardBag;
+    int bagIndex = 0;
+    int mediumBagIndex = 0;
+    int hardBagIndex = 0;
+    int currentLevel = 0;
+    bool nextBagReady = false;
+    std::uint32_t seed = 0;
+    std::uint64_t shuffleCount = 0;
+};
+
+
 class PieceBag {
 private:
     std::vector<PieceType> currentBag;
@@ -615,6 +624,8 @@ private:
     std::vector<PieceType> nextQueue;
     int bagIndex = 0;
     std::mt19937 rng;
+    std::uint32_t seed = 0;
+    std::uint64_t shuffleCount = 0;
     bool nextBagReady = false;
     int currentLevel = 0;
     
@@ -624,8 +635,10 @@ private:
     int hardBagIndex = 0;
     
     const DifficultyConfig* difficultyConfig = nullptr;
+    bool logging = true;
     
     std::vector<PieceType> createNewBag(int level);
+    void shuffleBag(std::vector<PieceType>& bag);
     void ensureNextBagReady();
     void fillNextQueue();
     void refillMediumBag();
@@ -633,6 +646,11 @@ private:
     
 public:
     PieceBag();
+    explicit PieceBag(std::uint32_t seed, bool logging = true);
+    void reseed(std::uint32_t seed);
+    std::uint32_t getSeed() const;
+    PieceBagState captureState() const;
+    void restoreState(const PieceBagState& state);
     PieceType getNextPiece();
     void updateLevel(int newLevel);
     void setDifficultyConfig(const DifficultyConfig* config);
@@ -0,0 +1,192 @@
+﻿#include "achievement_engine.h"
+#include "save_system.h"
+#include <algorithm>
+#include <iostream>
+
+
+
+
+namespace {
+
+AchievementRule challengeRule(Achievement achievement, bool (*matches)(const GameEvent&)) {
+    return {achievement, GameEventType::ModeCompleted, false, matches};
+}
+
+bool isFirstChallengeClear(const GameEvent& e, ChallengeMode challenge) {
+    return e.mode == GameModeOption::Challenge && e.challenge == challenge && e.firstCompletion;
+}
+
+}
+
+
+const std::vector<AchievementRule>& getAchievementRules() {
+    static const std::vector<AchievementRule> rules = {
+        {Achievement::Combo10, GameEventType::LinesCleared, true,
+            [](const GameEvent& e) { return e.combo >= 12; }},
+        {Achievement::Combo5OneClear, GameEventType::LinesCleared, true,
+            [](const GameEvent& e) { return e.lines >= 5; }},
+        {Achievement::Combo6OneClear, GameEventType::LinesCleared, true,
+            [](const GameEvent& e) { return e.lines >= 6; }},
+        {Achievement::Score200kNoBomb, GameEventType::GameFinished, true,
+            [](const GameEvent& e) { return e.mode == GameModeOption::Classic && e.score >= 200000 && !e.bombUsed; }},
+        {Achievement::Blitz48Under230, GameEventType::ModeCompleted, true,
+            [](const GameEvent& e) { return e.mode == GameModeOption::Sprint && e.lineGoal == 48 && e.timeSeconds < 133.7f; }},
+        {Achievement::Score400kMedHard, GameEventType::GameFinished, true,
+            [](const GameEvent& e) { return e.mode == GameModeOption::Classic && e.difficulty == ClassicDifficulty::Hard && e.score >= 400000; }},
+        {Achievement::HoldBomb, GameEventType::PieceHeld, true,
+            [](const GameEvent& e) { return e.piece == PieceType::A_Bomb; }},
+        {Achievement::Explosion, GameEventType::BombExploded, true,
+            [](const GameEvent& e) { return e.bombStreak >= 3; }},
+        {Achievement::MenuBombClicker, GameEventType::MenuBombClicked, false,
+            [](const GameEvent&) { return true; }},
+        {Achievement::PerfectClear, GameEventType::PerfectClear, true,
+            [](const GameEvent&) { return true; }},
+
+        challengeRule(Achievement::ChallengeTheForest,
+            [](const GameEvent& e) { return isFirstChallengeClear(e, ChallengeMode::TheForest); }),
+        challengeRule(Achievement::ChallengeRandomness,
+            [](const GameEvent& e) { return isFirstChallengeClear(e, ChallengeMode::Randomness); }),
+        challengeRule(Achievement::ChallengeNonStraight,
+            [](const GameEvent& e) { return isFirstChallengeClear(e, ChallengeMode::NonStraight); }),
+        challengeRule(Achievement::ChallengeOneRot,
+            [](const GameEvent& e) { return isFirstChallengeClear(e, ChallengeMode::OneRot); }),
+        challengeRule(Achievement::ChallengeChristopherCurse,
+            [](const GameEvent& e) { return isFirstChallengeClear(e, ChallengeMode::ChristopherCurse); }),
+        challengeRule(Achievement::ChallengeVanishing,
+            [](const GameEvent& e) { return isFirstChallengeClear(e, ChallengeMode::Vanishing); }),
+        challengeRule(Achievement::ChallengeAutoDrop,
+            [](const GameEvent& e) { return isFirstChallengeClear(e, ChallengeMode::AutoDrop); })
+    };
+    return rules;
+}
+
+
+void AchievementEngine::sync(const SaveData& saveData) {
+    for (int i = 0; i < TOTAL_ACHIEVEMENTS; i++) {
+        armed[i] = !saveData.achievements[i];
+    }
+    pending.clear();
+
+    for (auto& list : subscribers) {
+        list.clear();
+    }
+    for (const AchievementRule& rule : getAchievementRules()) {
+        if (armed[static_cast<int>(rule.achievement)]) {
+            subscribers[static_cast<int>(rule.event)].push_back(&rule);
+        }
+    }
+}
+
+void AchievementEngine::post(const GameEvent& event) {
+    for (const AchievementRule* rule : subscribers[static_cast<int>(event.type)]) {
+        int id = static_cast<int>(rule->achievement);
+        if (!armed[id] || (rule->rankedOnly && !event.rankedPlay)) {
+            continue;
+        }
+        if (rule->matches(event)) {
+            armed[id] = false;
+            pending.push_back(rule->achievement);
+        }
+    }
+}
+
+
+void AchievementEngine::onLinesCleared(int lines, int combo, bool rankedPlay) {
+    GameEvent event;
+    event.type = GameEventType::LinesCleared;
+    event.rankedPlay = rankedPlay;
+    event.lines = lines;
+    event.combo = combo;
+    post(event);
+}
+
+void AchievementEngine::onBombExploded(int bombStreak, bool rankedPlay) {
+    GameEvent event;
+    event.type = GameEventType::BombExploded;
+    event.rankedPlay = rankedPlay;
+    event.bombStreak = bombStreak;
+    post(event);
+}
+
+void AchievementEngine::onPieceHeld(PieceType piece, bool rankedPlay) {
+    GameEvent event;
+    event.type = GameEventType::PieceHeld;
+    event.rankedPlay = rankedPlay;
+    event.piece = piece;
+    post(event);
+}
+
+void AchievementEngine::onPerfectClear(bool rankedPlay) {
+    GameEvent event;
+    event.type = GameEventType::PerfectClear;
+    event.rankedPlay = rankedPlay;
+    post(event);
+}
+
+void AchievementEngine::onSprintCompleted(int lineGoal, float timeSeconds, bool rankedPlay) {
+    GameEvent event;
+    event.type = GameEventType::ModeCompleted;
+    event.rankedPlay = rankedPlay;
+    event.mode = GameModeOption::Sprint;
+    event.lineGoal = lineGoal;
+    event.timeSeconds = timeSeconds;
+    post(event);
+}
+
+void AchievementEngine::onChallengeCompleted(ChallengeMode challenge, float timeSeconds, bool firstCompletion) {
+    GameEvent event;
+    event.type = GameEventType::ModeCompleted;
+    event.mode = GameModeOption::Challenge;
+    event.challenge = challenge;
+    event.timeSeconds = timeSeconds;
+    event.firstCompletion = firstCompletion;
+    post(event);
+}
+
+void AchievementEngine::onClassicFinished(ClassicDifficulty difficulty, int score, bool bombUsed, bool rankedPlay) {
+    GameEvent event;
+    event.type = GameEventType::GameFinished;
+    event.rankedPlay = rankedPlay;
+    event.mode = GameModeOption::Classic;
+    event.difficulty = difficulty;
+    event.score = score;
+    event.bombUsed = bombUsed;
+    post(event);
+}
+
+void AchievementEngine::onMenuBombClicked() {
+    GameEvent event;
+    event.type = GameEventType::MenuBombClicked;
+    post(event);
+}
+
+
+int AchievementEngine::flush(SaveData& saveData, std::vector<AchievementPopup>& popups, AudioManager* audioManager) {
+    if (pending.empty()) {
+        return 0;
+    }
+
+    int unlocked = 0;
+    for (Achievement ach : pending) {
+        if (tryUnlockAchievement(saveData, ach)) {
+            popups.emplace_back(ach, getAchievementInfo(ach).title);
+            unlocked++;
+        }
+    }
+    pending.clear();
+
+    for (auto& list : subscribers) {
+        list.erase(std::remove_if(list.begin(), list.end(), [this](const AchievementRule* rule) {
+            return !armed[static_cast<int>(rule->achievement)];
+        }), list.end());
+    }
+
+    if (unlocked > 0) {
+        saveGameData(saveData);
+        if (audioManager) {
+            audioManager->playAchievementSound();
+        }
+        std::cout << "[ACHIEVEMENT] " << unlocked << " unlocked this frame" << std::endl;
+    }
+    return unlocked;
+}
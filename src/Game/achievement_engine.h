@@ -0,0 +1,86 @@
+﻿#ifndef ACHIEVEMENT_ENGINE_H
+#define ACHIEVEMENT_ENGINE_H
+
+#include "types.h"
+#include "achievements.h"
+#include "audio_manager.h"
+#include <array>
+#include <vector>
+
+
+
+
+enum class GameEventType {
+    LinesCleared,
+    BombExploded,
+    PieceHeld,
+    PerfectClear,
+    ModeCompleted,
+    GameFinished,
+    MenuBombClicked,
+    Count
+};
+
+constexpr int GAME_EVENT_TYPE_COUNT = static_cast<int>(GameEventType::Count);
+
+
+// rankedPlay is false in challenge and practice sessions, which only count
+// towards their own completion achievements.
+struct GameEvent {
+    GameEventType type = GameEventType::LinesCleared;
+    bool rankedPlay = false;
+
+    int lines = 0;
+    int combo = 0;
+    int bombStreak = 0;
+    PieceType piece = PieceType::I_Basic;
+
+    GameModeOption mode = GameModeOption::Classic;
+    ClassicDifficulty difficulty = ClassicDifficulty::Normal;
+    ChallengeMode challenge = ChallengeMode::Debug;
+    int lineGoal = 0;
+    float timeSeconds = 0.0f;
+    int score = 0;
+    bool bombUsed = false;
+    bool firstCompletion = false;
+};
+
+
+struct AchievementRule {
+    Achievement achievement;
+    GameEventType event;
+    bool rankedOnly;
+    bool (*matches)(const GameEvent& event);
+};
+
+const std::vector<AchievementRule>& getAchievementRules();
+
+
+// Rules subscribe to a single event type and drop out of their list once
+// unlocked, so posting an event only walks the few rules still armed for it.
+// Unlocks queue up until flush(), which persists once per frame.
+class AchievementEngine {
+private:
+    std::array<std::vector<const AchievementRule*>, GAME_EVENT_TYPE_COUNT> subscribers;
+    std::array<bool, TOTAL_ACHIEVEMENTS> armed{};
+    std::vector<Achievement> pending;
+
+    void post(const GameEvent& event);
+
+public:
+    void sync(const SaveData& saveData);
+
+    void onLinesCleared(int lines, int combo, bool rankedPlay);
+    void onBombExploded(int bombStreak, bool rankedPlay);
+    void onPieceHeld(PieceType piece, bool rankedPlay);
+    void onPerfectClear(bool rankedPlay);
+    void onSprintCompleted(int lineGoal, float timeSeconds, bool rankedPlay);
+    void onChallengeCompleted(ChallengeMode challenge, float timeSeconds, bool firstCompletion);
+    void onClassicFinished(ClassicDifficulty difficulty, int score, bool bombUsed, bool rankedPlay);
+    void onMenuBombClicked();
+
+    bool hasPending() const { return !pending.empty(); }
+    int flush(SaveData& saveData, std::vector<AchievementPopup>& popups, AudioManager* audioManager);
+};
+
+#endif
@@ -0,0 +1,28 @@
+﻿#include "bitboard.h"
+#include <algorithm>
+
+
+
+
+
+int findRotationIndex(PieceType type, const PieceShape& shape) {
+    PieceMask current = buildPieceMask(shape.blocks);
+    for (int r = 0; r < PIECE_ROTATIONS; ++r) {
+        const PieceMask& mask = getPieceMask(type, r);
+        if (mask.width != current.width || mask.height != current.height) continue;
+        if (std::equal(mask.rows, mask.rows + MAX_PIECE_SPAN, current.rows)) return r;
+    }
+    return 0;
+}
+
+BoardRows gridToBoardRows(const std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid) {
+    BoardRows board{};
+    for (int y = 0; y < GRID_HEIGHT; ++y) {
+        for (int x = 0; x < GRID_WIDTH; ++x) {
+            if (grid[y][x].occupied) {
+                board[y] |= static_cast<std::uint16_t>(1u << x);
+            }
+        }
+    }
+    return board;
+}
@@ -0,0 +1,18 @@
+﻿#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "types.h"
+#include "piece_mask.h"
+#include <array>
+
+
+
+
+// Bridges between the game's Cell grid and PieceShape and the SFML-free
+// masks in piece_mask.h.
+int findRotationIndex(PieceType type, const PieceShape& shape);
+
+
+BoardRows gridToBoardRows(const std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid);
+
+#endif
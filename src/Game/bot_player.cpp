@@ -0,0 +1,175 @@
+﻿#include "bot_player.h"
+#include "game_logic.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+
+
+
+
+namespace {
+    constexpr float NO_MOVE = -std::numeric_limits<float>::infinity();
+
+    int getRegionTop(const BoardRows& board) {
+        int top = 0;
+        while (top < GRID_HEIGHT && board[top] == 0) ++top;
+        return std::max(0, top - MAX_PIECE_SPAN);
+    }
+
+    bool spawnBlocked(const BoardRows& board, PieceType type) {
+        return maskCollides(board, getPieceMask(type, 0), getSpawnX(type), getSpawnY(type));
+    }
+
+    int applyPlacement(BoardRows& board, const Placement& placement) {
+        placeMask(board, getPieceMask(placement.type, placement.rotation), placement.x, placement.y);
+        return clearFullBoardRows(board);
+    }
+
+    float bestFollowUp(const BoardRows& board, PieceType next, int linesSoFar, const BotWeights& weights, std::vector<Placement>& scratch) {
+        findRegionPlacements(board, next, getRegionTop(board), scratch);
+        float best = NO_MOVE;
+        for (const Placement& placement : scratch) {
+            BoardRows after = board;
+            int lines = applyPlacement(after, placement);
+            best = std::max(best, evaluateBoard(after, linesSoFar + lines, weights));
+        }
+        return best;
+    }
+}
+
+
+const std::vector<BotConfig>& getBotPresets() {
+    static const std::vector<BotConfig> presets = [] {
+        BotWeights elTetris;
+        elTetris.linesCleared = 0.760666f;
+        elTetris.aggregateHeight = -0.510066f;
+        elTetris.holes = -0.35663f;
+        elTetris.bumpiness = -0.184483f;
+
+        BotWeights stacker;
+        stacker.linesCleared = 0.2f;
+        stacker.aggregateHeight = -0.35f;
+        stacker.holes = -0.6f;
+        stacker.bumpiness = -0.25f;
+        stacker.maxHeight = -0.2f;
+        stacker.wellDepth = 0.15f;
+
+        std::vector<BotConfig> list;
+        list.push_back({"eltetris", elTetris, 0, false});
+        list.push_back({"eltetris-hold", elTetris, 0, true});
+        list.push_back({"lookahead", elTetris, 1, true});
+        list.push_back({"stacker", stacker, 0, true});
+        return list;
+    }();
+    return presets;
+}
+
+float evaluateBoard(const BoardRows& board, int linesCleared, const BotWeights& weights) {
+    int heights[GRID_WIDTH];
+    int aggregateHeight = 0;
+    int maxHeight = 0;
+    int holes = 0;
+    for (int col = 0; col < GRID_WIDTH; ++col) {
+        std::uint16_t bit = static_cast<std::uint16_t>(1u << col);
+        int row = 0;
+        while (row < GRID_HEIGHT && !(board[row] & bit)) ++row;
+        heights[col] = GRID_HEIGHT - row;
+        aggregateHeight += heights[col];
+        maxHeight = std::max(maxHeight, heights[col]);
+        for (++row; row < GRID_HEIGHT; ++row) {
+            if (!(board[row] & bit)) ++holes;
+        }
+    }
+
+    int bumpiness = 0;
+    int wellDepth = 0;
+    for (int col = 0; col < GRID_WIDTH; ++col) {
+        if (col + 1 < GRID_WIDTH) bumpiness += std::abs(heights[col] - heights[col + 1]);
+        int left = col > 0 ? heights[col - 1] : GRID_HEIGHT;
+        int right = col + 1 < GRID_WIDTH ? heights[col + 1] : GRID_HEIGHT;
+        wellDepth = std::max(wellDepth, std::min(left, right) - heights[col]);
+    }
+
+    return weights.linesCleared * linesCleared
+        + weights.aggregateHeight * aggregateHeight
+        + weights.holes * holes
+        + weights.bumpiness * bumpiness
+        + weights.maxHeight * maxHeight
+        + weights.wellDepth * wellDepth;
+}
+
+BotGameResult playHeadlessGame(const BotConfig& config, std::uint32_t seed, int pieceLimit, std::vector<BotMove>* replay) {
+    BotGameResult result;
+    if (replay) replay->clear();
+
+    PieceBag bag(seed, false);
+    BoardRows board{};
+    PieceType current = bag.getNextPiece();
+    PieceType hold = current;
+    bool hasHold = false;
+
+    std::vector<Placement> firstPlacements;
+    std::vector<Placement> secondPlacements;
+
+    while (result.piecesPlaced < pieceLimit) {
+        auto thinkStart = std::chrono::steady_clock::now();
+        const std::vector<PieceType>& queue = bag.getNextQueue();
+
+        BotMove bestMove;
+        float bestValue = NO_MOVE;
+        int optionCount = config.useHold ? 2 : 1;
+        for (int option = 0; option < optionCount; ++option) {
+            bool useHold = option == 1;
+            PieceType piece = current;
+            PieceType next = queue[0];
+            if (useHold) {
+                piece = hasHold ? hold : queue[0];
+                next = hasHold ? queue[0] : queue[1];
+            }
+
+            findRegionPlacements(board, piece, getRegionTop(board), firstPlacements);
+            for (const Placement& placement : firstPlacements) {
+                BoardRows after = board;
+                int lines = applyPlacement(after, placement);
+                float value = config.lookahead > 0
+                    ? bestFollowUp(after, next, lines, config.weights, secondPlacements)
+                    : evaluateBoard(after, lines, config.weights);
+                if (value > bestValue) {
+                    bestValue = value;
+                    bestMove.placement = placement;
+                    bestMove.useHold = useHold;
+                }
+            }
+        }
+        result.thinkSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - thinkStart).count();
+
+        if (bestValue == NO_MOVE) {
+            result.toppedOut = true;
+            break;
+        }
+
+        if (bestMove.useHold) {
+            if (hasHold) {
+                std::swap(current, hold);
+            } else {
+                hold = current;
+                current = bag.getNextPiece();
+                hasHold = true;
+            }
+        }
+
+        int lines = applyPlacement(board, bestMove.placement);
+        result.linesCleared += lines;
+        result.score += calculateScore(lines);
+        ++result.piecesPlaced;
+        if (replay) replay->push_back(bestMove);
+
+        current = bag.getNextPiece();
+        if (spawnBlocked(board, current)) {
+            result.toppedOut = true;
+            break;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,61 @@
+﻿#ifndef BOT_PLAYER_H
+#define BOT_PLAYER_H
+
+#include "bitboard.h"
+#include "placement_search.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+
+struct BotWeights {
+    float linesCleared = 0.0f;
+    float aggregateHeight = 0.0f;
+    float holes = 0.0f;
+    float bumpiness = 0.0f;
+    float maxHeight = 0.0f;
+    float wellDepth = 0.0f;
+};
+
+
+struct BotConfig {
+    std::string name;
+    BotWeights weights;
+    int lookahead = 0;
+    bool useHold = false;
+};
+
+
+struct BotMove {
+    Placement placement;
+    bool useHold = false;
+};
+
+
+struct BotGameResult {
+    int score = 0;
+    int linesCleared = 0;
+    int piecesPlaced = 0;
+    bool toppedOut = false;
+    double thinkSeconds = 0.0;
+};
+
+
+const std::vector<BotConfig>& getBotPresets();
+
+
+float evaluateBoard(const BoardRows& board, int linesCleared, const BotWeights& weights);
+
+
+// Plays one game on the PieceBag sequence for the given seed with no window,
+// audio or timing; the same seed always produces the same game for a config.
+BotGameResult playHeadlessGame(
+    const BotConfig& config,
+    std::uint32_t seed,
+    int pieceLimit,
+    std::vector<BotMove>* replay = nullptr
+);
+
+#endif
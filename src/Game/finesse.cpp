@@ -0,0 +1,54 @@
+﻿#include "finesse.h"
+#include <algorithm>
+#include <iostream>
+
+
+
+
+
+void FinesseTracker::reset() {
+    piecesAnalyzed = 0;
+    perfectPieces = 0;
+    totalFaults = 0;
+    hasLast = false;
+    lastPlayerInputs = 0;
+    lastOptimalInputs = 0;
+    lastFaults = 0;
+    lastOptimalPath.clear();
+}
+
+int FinesseTracker::analyzePiece(const BoardRows& board, const Placement& placed, int playerInputs) {
+    if (!findInputPath(board, placed, lastOptimalPath)) {
+        return -1;
+    }
+
+    lastPlayerInputs = playerInputs;
+    lastOptimalInputs = static_cast<int>(lastOptimalPath.size());
+    lastFaults = std::max(0, playerInputs - lastOptimalInputs);
+    hasLast = true;
+
+    piecesAnalyzed++;
+    totalFaults += lastFaults;
+    if (lastFaults == 0) {
+        perfectPieces++;
+    } else {
+        std::cout << "[FINESSE] " << playerInputs << " inputs, optimal " << lastOptimalInputs
+                  << ": " << describeLastOptimalPath() << std::endl;
+    }
+    return lastFaults;
+}
+
+float FinesseTracker::getAccuracy() const {
+    if (piecesAnalyzed == 0) return 1.0f;
+    return static_cast<float>(perfectPieces) / piecesAnalyzed;
+}
+
+std::string FinesseTracker::describeLastOptimalPath() const {
+    if (lastOptimalPath.empty()) return "DROP";
+    std::string description;
+    for (size_t i = 0; i < lastOptimalPath.size(); ++i) {
+        if (i > 0) description += ", ";
+        description += placementInputToString(lastOptimalPath[i]);
+    }
+    return description;
+}
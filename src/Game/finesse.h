@@ -0,0 +1,42 @@
+﻿#ifndef FINESSE_H
+#define FINESSE_H
+
+#include "bitboard.h"
+#include "placement_search.h"
+#include <string>
+#include <vector>
+
+
+
+
+class FinesseTracker {
+private:
+    int piecesAnalyzed = 0;
+    int perfectPieces = 0;
+    int totalFaults = 0;
+
+    bool hasLast = false;
+    int lastPlayerInputs = 0;
+    int lastOptimalInputs = 0;
+    int lastFaults = 0;
+    std::vector<PlacementInput> lastOptimalPath;
+
+public:
+    void reset();
+
+
+    int analyzePiece(const BoardRows& board, const Placement& placed, int playerInputs);
+
+    int getPiecesAnalyzed() const { return piecesAnalyzed; }
+    int getPerfectPieces() const { return perfectPieces; }
+    int getTotalFaults() const { return totalFaults; }
+    float getAccuracy() const;
+
+    bool hasLastResult() const { return hasLast; }
+    int getLastPlayerInputs() const { return lastPlayerInputs; }
+    int getLastOptimalInputs() const { return lastOptimalInputs; }
+    int getLastFaults() const { return lastFaults; }
+    std::string describeLastOptimalPath() const;
+};
+
+#endif
@@ -0,0 +1,53 @@
+﻿#include "game_analytics.h"
+#include <algorithm>
+#include <ctime>
+#include <vector>
+
+
+
+
+
+GameAnalytics aggregatePieceEvents(const PieceEventLog& log, std::uint32_t durationMs, GameModeOption mode, int subMode) {
+    GameAnalytics analytics;
+    analytics.timestamp = static_cast<std::int64_t>(std::time(nullptr));
+    analytics.mode = static_cast<std::uint8_t>(mode);
+    analytics.subMode = static_cast<std::uint8_t>(subMode);
+    analytics.durationMs = durationMs;
+    analytics.piecesPlaced = log.getTotalRecorded();
+
+    std::vector<float> placeTimes;
+    placeTimes.reserve(log.size());
+    float placeTimeSum = 0.0f;
+
+    for (int i = 0; i < log.size(); ++i) {
+        const PieceEvent& event = log.at(i);
+        analytics.totalInputs += event.inputs;
+        analytics.totalRotations += event.rotations;
+        analytics.holdsUsed += event.holdUsed;
+        analytics.linesCleared += event.linesCleared;
+        analytics.maxCombo = std::max<std::uint32_t>(analytics.maxCombo, event.combo);
+        analytics.finesseFaults += event.finesseFaults;
+
+        float placeTime = static_cast<float>(event.lockTick - event.spawnTick) / ANALYTICS_TICKS_PER_SECOND;
+        placeTimes.push_back(placeTime);
+        placeTimeSum += placeTime;
+
+        int bucket = 0;
+        while (bucket < PLACE_TIME_BUCKETS - 1 && placeTime >= PLACE_TIME_BUCKET_LIMITS[bucket]) {
+            bucket++;
+        }
+        analytics.placeTimeHistogram[bucket]++;
+    }
+
+    if (durationMs > 0) {
+        analytics.piecesPerSecond = analytics.piecesPlaced * static_cast<float>(ANALYTICS_TICKS_PER_SECOND) / durationMs;
+    }
+    if (!placeTimes.empty()) {
+        analytics.keysPerPiece = static_cast<float>(analytics.totalInputs) / placeTimes.size();
+        analytics.averagePlaceTime = placeTimeSum / placeTimes.size();
+        auto middle = placeTimes.begin() + placeTimes.size() / 2;
+        std::nth_element(placeTimes.begin(), middle, placeTimes.end());
+        analytics.medianPlaceTime = *middle;
+    }
+    return analytics;
+}
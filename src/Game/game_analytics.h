@@ -0,0 +1,85 @@
+﻿#ifndef GAME_ANALYTICS_H
+#define GAME_ANALYTICS_H
+
+#include "types.h"
+#include <array>
+#include <cstdint>
+
+
+
+
+constexpr int ANALYTICS_TICKS_PER_SECOND = 1000;
+constexpr int PIECE_EVENT_CAPACITY = 4096;
+constexpr int PLACE_TIME_BUCKETS = 8;
+constexpr float PLACE_TIME_BUCKET_LIMITS[PLACE_TIME_BUCKETS - 1] = {0.25f, 0.5f, 0.75f, 1.0f, 1.5f, 2.0f, 3.0f};
+
+
+struct PieceEvent {
+    std::uint32_t spawnTick = 0;
+    std::uint32_t lockTick = 0;
+    std::uint8_t type = 0;
+    std::uint8_t inputs = 0;
+    std::uint8_t rotations = 0;
+    std::uint8_t dropDistance = 0;
+    std::uint8_t linesCleared = 0;
+    std::uint8_t holdUsed = 0;
+    std::uint16_t combo = 0;
+    std::uint8_t finesseFaults = 0;
+};
+
+
+// Fixed-size ring buffer: recording is a struct copy and an index bump, so it
+// never allocates during play. Old events are overwritten once it is full.
+class PieceEventLog {
+private:
+    std::array<PieceEvent, PIECE_EVENT_CAPACITY> events;
+    int head = 0;
+    int count = 0;
+    std::uint32_t totalRecorded = 0;
+
+public:
+    void clear() {
+        head = 0;
+        count = 0;
+        totalRecorded = 0;
+    }
+
+    void record(const PieceEvent& event) {
+        events[head] = event;
+        head = (head + 1) % PIECE_EVENT_CAPACITY;
+        if (count < PIECE_EVENT_CAPACITY) count++;
+        totalRecorded++;
+    }
+
+    int size() const { return count; }
+    std::uint32_t getTotalRecorded() const { return totalRecorded; }
+
+    const PieceEvent& at(int index) const {
+        return events[(head - count + index + PIECE_EVENT_CAPACITY) % PIECE_EVENT_CAPACITY];
+    }
+};
+
+
+struct GameAnalytics {
+    std::int64_t timestamp = 0;
+    std::uint8_t mode = 0;
+    std::uint8_t subMode = 0;
+    std::uint32_t durationMs = 0;
+    std::uint32_t piecesPlaced = 0;
+    std::uint32_t totalInputs = 0;
+    std::uint32_t totalRotations = 0;
+    std::uint32_t holdsUsed = 0;
+    std::uint32_t linesCleared = 0;
+    std::uint32_t maxCombo = 0;
+    std::uint32_t finesseFaults = 0;
+    float piecesPerSecond = 0.0f;
+    float keysPerPiece = 0.0f;
+    float averagePlaceTime = 0.0f;
+    float medianPlaceTime = 0.0f;
+    std::array<std::uint32_t, PLACE_TIME_BUCKETS> placeTimeHistogram{};
+};
+
+
+GameAnalytics aggregatePieceEvents(const PieceEventLog& log, std::uint32_t durationMs, GameModeOption mode, int subMode);
+
+#endif
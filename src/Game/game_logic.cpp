@@ -276,26 +276,16 @@ void applyGameTheme(
     audioManager.setDropSound(currentTheme.dropSoundPath);
 }
 
-
-
-
-
-void unlockAchievement(
-    SaveData& saveData,
-    Achievement ach,
-    std::vector<AchievementPopup>* popups,
-    AudioManager* audioManager
+// Decodes the theme's effects in the background so applyGameTheme finds
+// them already cached when the game starts.
+void prefetchGameTheme(
+    AudioManager& audioManager,
+    GameModeOption mode,
+    ClassicDifficulty classicDiff,
+    ChallengeMode challengeMode,
+    GameThemeChoice themeChoice
 ) {
-    if (tryUnlockAchievement(saveData, ach)) {
-        saveGameData(saveData);
-        
-        if (popups) {
-            AchievementInfo info = getAchievementInfo(ach);
-            popups->emplace_back(ach, info.title);
-        }
-        
-        if (audioManager) {
-            audioManager->playAchievementSound();
-        }
-    }
+    GameModeTheme theme = GameThemes::getThemeForGameMode(mode, classicDiff, challengeMode, themeChoice);
+    audioManager.prefetchSound(theme.lineClearSoundPath);
+    audioManager.prefetchSound(theme.dropSoundPath);
 }
@@ -73,16 +73,12 @@ void applyGameTheme(
     GameThemeChoice themeChoice = GameThemeChoice::Classic
 );
 
-
-
-
-
-
-void unlockAchievement(
-    SaveData& saveData,
-    Achievement ach,
-    std::vector<AchievementPopup>* popups = nullptr,
-    AudioManager* audioManager = nullptr
+void prefetchGameTheme(
+    AudioManager& audioManager,
+    GameModeOption mode,
+    ClassicDifficulty classicDiff,
+    ChallengeMode challengeMode,
+    GameThemeChoice themeChoice
 );
 
 #endif
@@ -0,0 +1,607 @@
+﻿#include "pc_solver.h"
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+
+
+
+
+
+namespace {
+
+constexpr int BASIC_TYPE_COUNT = 7;
+constexpr int MAX_SOLVER_HEIGHT = 6;
+constexpr int MAX_KNOWN_PIECES = 15;
+constexpr int NODE_FLUSH_INTERVAL = 256;
+constexpr int MAX_SEARCH_DEPTH = MAX_SOLVER_HEIGHT * GRID_WIDTH / 4 + 2;
+
+using BagCounts = std::array<std::uint8_t, BASIC_TYPE_COUNT>;
+
+struct SolverKey {
+    std::uint64_t rows = 0;
+    std::uint64_t meta = 0;
+
+    bool operator==(const SolverKey& other) const {
+        return rows == other.rows && meta == other.meta;
+    }
+};
+
+struct SolverKeyHash {
+    size_t operator()(const SolverKey& key) const {
+        std::uint64_t h = key.rows * 0x9E3779B97F4A7C15ull;
+        h ^= key.meta + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+struct SolverNode {
+    BoardRows board{};
+    int height = 0;
+    int knownIndex = 0;
+    bool hasHold = false;
+    PieceType hold = PieceType::I_Basic;
+    bool canHold = true;
+    BagCounts bag{};
+};
+
+struct SharedSearch {
+    const PcQuery* query = nullptr;
+    std::vector<PieceType> known;
+    BagCounts freshBag{};
+    int freshBagSize = 0;
+    bool speculate = true;
+    std::atomic<long long> nodes{0};
+    std::atomic<int> bestTask{INT_MAX};
+    std::atomic<bool> budgetExhausted{false};
+};
+
+enum class RootMove {
+    Place,
+    SwapHold,
+    StashHold
+};
+
+struct RootTask {
+    RootMove move = RootMove::Place;
+    Placement placement;
+};
+
+int typeIndex(PieceType type) {
+    return static_cast<int>(type);
+}
+
+int bagTotal(const BagCounts& bag) {
+    int total = 0;
+    for (std::uint8_t count : bag) total += count;
+    return total;
+}
+
+int popcount16(std::uint16_t bits) {
+    int count = 0;
+    for (; bits; bits &= static_cast<std::uint16_t>(bits - 1)) count++;
+    return count;
+}
+
+// Column parity is used instead of the checkerboard colouring because it is
+// unaffected by rows shifting down after a mid-solution line clear.
+int columnImbalanceOf(PieceType type) {
+    switch (type) {
+        case PieceType::I_Basic: return 4;
+        case PieceType::T_Basic:
+        case PieceType::L_Basic:
+        case PieceType::J_Basic: return 2;
+        default: return 0;
+    }
+}
+
+void collectPlacements(const BoardRows& board, int height, PieceType type, std::vector<Placement>& out) {
+    findRegionPlacements(board, type, GRID_HEIGHT - height, out);
+    std::sort(out.begin(), out.end(), [](const Placement& a, const Placement& b) {
+        return a.y + getPieceMask(a.type, a.rotation).maxRow > b.y + getPieceMask(b.type, b.rotation).maxRow;
+    });
+}
+
+SolverNode applyPlacement(const SolverNode& node, const Placement& placement) {
+    SolverNode child = node;
+    placeMask(child.board, getPieceMask(placement.type, placement.rotation), placement.x, placement.y);
+    child.height -= clearFullBoardRows(child.board);
+    child.canHold = true;
+    return child;
+}
+
+class SolverWorker {
+private:
+    SharedSearch& shared;
+    int taskIndex = 0;
+    long long localNodes = 0;
+    bool stopped = false;
+    int depth = 0;
+    std::unordered_set<SolverKey, SolverKeyHash> failed;
+    std::vector<std::vector<Placement>> placementScratch;
+
+    bool shouldStop() {
+        if (stopped) return true;
+        if (++localNodes % NODE_FLUSH_INTERVAL != 0) return false;
+        long long total = shared.nodes.fetch_add(NODE_FLUSH_INTERVAL) + NODE_FLUSH_INTERVAL;
+        if (total > shared.query->nodeBudget) {
+            shared.budgetExhausted = true;
+            stopped = true;
+        } else if (taskIndex > shared.bestTask.load()) {
+            stopped = true;
+        } else if (shared.query->cancel && shared.query->cancel->load()) {
+            stopped = true;
+        }
+        return stopped;
+    }
+
+    SolverKey makeKey(const SolverNode& node) const {
+        SolverKey key;
+        int packedRows = std::min(node.height, 5);
+        for (int i = 0; i < packedRows; ++i) {
+            key.rows |= static_cast<std::uint64_t>(node.board[GRID_HEIGHT - 1 - i]) << (GRID_WIDTH * i);
+        }
+        if (node.height > 5) key.meta = node.board[GRID_HEIGHT - 6];
+        key.meta |= static_cast<std::uint64_t>(node.height) << 11;
+        key.meta |= static_cast<std::uint64_t>(node.hasHold) << 14;
+        key.meta |= static_cast<std::uint64_t>(node.hasHold ? typeIndex(node.hold) : 0) << 15;
+        key.meta |= static_cast<std::uint64_t>(node.canHold) << 18;
+        key.meta |= static_cast<std::uint64_t>(node.knownIndex) << 19;
+        for (int t = 0; t < BASIC_TYPE_COUNT; ++t) {
+            key.meta |= static_cast<std::uint64_t>(node.bag[t] & 7) << (23 + 3 * t);
+        }
+        return key;
+    }
+
+    bool passesPrunes(const SolverNode& node) const {
+        int regionTop = GRID_HEIGHT - node.height;
+        std::uint16_t fullColumns = FULL_ROW_MASK;
+        std::array<int, GRID_WIDTH> columnEmpty{};
+        int empty = 0;
+        for (int y = regionTop; y < GRID_HEIGHT; ++y) {
+            fullColumns &= node.board[y];
+            std::uint16_t holes = static_cast<std::uint16_t>(~node.board[y] & FULL_ROW_MASK);
+            empty += popcount16(holes);
+            for (int x = 0; x < GRID_WIDTH; ++x) {
+                if (holes & (1u << x)) columnEmpty[x]++;
+            }
+        }
+        if (empty % 4 != 0) return false;
+
+        int runEmpty = 0;
+        for (int x = 0; x <= GRID_WIDTH; ++x) {
+            if (x == GRID_WIDTH || (fullColumns & (1u << x))) {
+                if (runEmpty % 4 != 0) return false;
+                runEmpty = 0;
+            } else {
+                runEmpty += columnEmpty[x];
+            }
+        }
+
+        int needed = empty / 4;
+        int supply = 0;
+        int imbalanceSupply = 0;
+        if (node.hasHold) {
+            supply++;
+            imbalanceSupply += columnImbalanceOf(node.hold);
+        }
+        for (size_t i = node.knownIndex; i < shared.known.size(); ++i) {
+            supply++;
+            imbalanceSupply += columnImbalanceOf(shared.known[i]);
+        }
+        for (int t = 0; t < BASIC_TYPE_COUNT; ++t) {
+            supply += node.bag[t];
+            imbalanceSupply += node.bag[t] * columnImbalanceOf(static_cast<PieceType>(t));
+        }
+        if (needed > supply) {
+            if (shared.freshBagSize == 0) return false;
+            int freshBags = (needed - supply + shared.freshBagSize - 1) / shared.freshBagSize;
+            for (int t = 0; t < BASIC_TYPE_COUNT; ++t) {
+                imbalanceSupply += freshBags * shared.freshBag[t] * columnImbalanceOf(static_cast<PieceType>(t));
+            }
+        }
+
+        int evenEmpty = 0;
+        int oddEmpty = 0;
+        for (int x = 0; x < GRID_WIDTH; ++x) {
+            (x % 2 == 0 ? evenEmpty : oddEmpty) += columnEmpty[x];
+        }
+        return std::abs(evenEmpty - oddEmpty) <= imbalanceSupply;
+    }
+
+    bool placeAll(const SolverNode& base, PieceType type, bool useHold, std::vector<PcStep>* path) {
+        if (depth >= MAX_SEARCH_DEPTH) return false;
+        std::vector<Placement>& placements = placementScratch[depth];
+        collectPlacements(base.board, base.height, type, placements);
+
+        depth++;
+        bool found = false;
+        for (size_t i = 0; i < placements.size() && !found; ++i) {
+            const Placement placement = placements[i];
+            SolverNode child = applyPlacement(base, placement);
+            if (solve(child, path)) {
+                if (path) path->push_back({placement, useHold});
+                found = true;
+            }
+            if (stopped) break;
+        }
+        depth--;
+        return found;
+    }
+
+public:
+    SolverWorker(SharedSearch& search, int task) : shared(search), taskIndex(task), placementScratch(MAX_SEARCH_DEPTH) {}
+
+    bool isStopped() const { return stopped; }
+
+    void flushNodes() {
+        shared.nodes.fetch_add(localNodes % NODE_FLUSH_INTERVAL);
+    }
+
+    bool solve(const SolverNode& node, std::vector<PcStep>* path) {
+        if (node.height == 0) return true;
+        if (shouldStop()) return false;
+        if (!passesPrunes(node)) return false;
+
+        SolverKey key = makeKey(node);
+        if (failed.count(key)) return false;
+
+        bool result = false;
+        if (node.knownIndex < static_cast<int>(shared.known.size())) {
+            result = tryPiece(node, shared.known[node.knownIndex], true, path);
+        } else {
+            BagCounts bag = node.bag;
+            if (bagTotal(bag) == 0) bag = shared.freshBag;
+            if (bagTotal(bag) > 0) {
+                result = shared.speculate;
+                for (int t = 0; t < BASIC_TYPE_COUNT; ++t) {
+                    if (bag[t] == 0) continue;
+                    SolverNode drawn = node;
+                    drawn.bag = bag;
+                    drawn.bag[t]--;
+                    bool success = tryPiece(drawn, static_cast<PieceType>(t), false, nullptr);
+                    if (shared.speculate && !success) {
+                        result = false;
+                        break;
+                    }
+                    if (!shared.speculate && success) {
+                        result = true;
+                        break;
+                    }
+                    if (stopped) break;
+                }
+            }
+        }
+
+        if (!result && !stopped) failed.insert(key);
+        return result;
+    }
+
+    bool tryPiece(const SolverNode& node, PieceType active, bool activeKnown, std::vector<PcStep>* path) {
+        SolverNode base = node;
+        if (activeKnown) base.knownIndex++;
+
+        if (placeAll(base, active, false, path)) return true;
+        if (stopped || !node.canHold) return false;
+
+        if (node.hasHold) {
+            if (node.hold == active) return false;
+            SolverNode swapped = base;
+            swapped.hold = active;
+            return placeAll(swapped, node.hold, true, path);
+        }
+
+        SolverNode stashed = base;
+        stashed.hasHold = true;
+        stashed.hold = active;
+        stashed.canHold = false;
+        size_t pathSize = path ? path->size() : 0;
+        if (!solve(stashed, path)) return false;
+        if (path && path->size() > pathSize) path->back().useHold = true;
+        return true;
+    }
+
+    bool runRootTask(const SolverNode& root, const RootTask& task, std::vector<PcStep>& path) {
+        SolverNode base = root;
+        base.knownIndex = 1;
+        PieceType current = shared.known[0];
+        switch (task.move) {
+            case RootMove::Place: {
+                SolverNode child = applyPlacement(base, task.placement);
+                if (!solve(child, &path)) return false;
+                path.push_back({task.placement, false});
+                return true;
+            }
+            case RootMove::SwapHold: {
+                base.hold = current;
+                SolverNode child = applyPlacement(base, task.placement);
+                if (!solve(child, &path)) return false;
+                path.push_back({task.placement, true});
+                return true;
+            }
+            case RootMove::StashHold: {
+                base.hasHold = true;
+                base.hold = current;
+                base.canHold = false;
+                if (!solve(base, &path)) return false;
+                if (!path.empty()) path.back().useHold = true;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+std::vector<RootTask> buildRootTasks(const SolverNode& root, PieceType current) {
+    std::vector<RootTask> tasks;
+    std::vector<Placement> placements;
+    collectPlacements(root.board, root.height, current, placements);
+    for (const Placement& placement : placements) {
+        tasks.push_back({RootMove::Place, placement});
+    }
+    if (!root.canHold) return tasks;
+    if (root.hasHold) {
+        if (root.hold != current) {
+            collectPlacements(root.board, root.height, root.hold, placements);
+            for (const Placement& placement : placements) {
+                tasks.push_back({RootMove::SwapHold, placement});
+            }
+        }
+    } else {
+        tasks.push_back({RootMove::StashHold, Placement{}});
+    }
+    return tasks;
+}
+
+bool runSearch(SharedSearch& shared, const SolverNode& root, std::vector<PcStep>& steps) {
+    std::vector<RootTask> tasks = buildRootTasks(root, shared.known[0]);
+    if (tasks.empty()) return false;
+
+    int threadCount = shared.query->threadCount;
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    threadCount = std::min(threadCount, static_cast<int>(tasks.size()));
+
+    std::atomic<int> nextTask{0};
+    std::mutex resultMutex;
+    std::vector<PcStep> bestPath;
+
+    auto worker = [&]() {
+        for (;;) {
+            int index = nextTask.fetch_add(1);
+            if (index >= static_cast<int>(tasks.size()) || index > shared.bestTask.load()) break;
+            if (shared.budgetExhausted || (shared.query->cancel && shared.query->cancel->load())) break;
+
+            SolverWorker solver(shared, index);
+            std::vector<PcStep> path;
+            bool found = solver.runRootTask(root, tasks[index], path);
+            solver.flushNodes();
+            if (found) {
+                std::lock_guard<std::mutex> lock(resultMutex);
+                if (index < shared.bestTask.load()) {
+                    shared.bestTask = index;
+                    bestPath = path;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    if (shared.bestTask.load() == INT_MAX) return false;
+    steps.assign(bestPath.rbegin(), bestPath.rend());
+    return true;
+}
+
+bool allTetrominoes(const std::vector<PieceType>& pieces) {
+    return std::all_of(pieces.begin(), pieces.end(), isTetromino);
+}
+
+BagCounts countPieces(const std::vector<PieceType>& pieces) {
+    BagCounts counts{};
+    if (!allTetrominoes(pieces)) return counts;
+    for (PieceType piece : pieces) {
+        counts[typeIndex(piece)]++;
+    }
+    return counts;
+}
+
+}
+
+PcQuery makePcQuery(
+    const std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid,
+    PieceType current,
+    bool hasHold,
+    PieceType hold,
+    bool canHold,
+    const PieceBag& bag
+) {
+    PcQuery query;
+    query.board = gridToBoardRows(grid);
+    query.current = current;
+    query.hasHold = hasHold;
+    query.hold = hold;
+    query.canHold = canHold;
+    query.queue = bag.getNextQueue();
+
+    const std::vector<PieceType>& currentBag = bag.getCurrentBag();
+    int visibleEnd = bag.getBagIndex() + static_cast<int>(query.queue.size());
+    if (visibleEnd < static_cast<int>(currentBag.size())) {
+        query.unseenBagPieces.assign(currentBag.begin() + visibleEnd, currentBag.end());
+    } else if (bag.isNextBagReady()) {
+        const std::vector<PieceType>& nextBag = bag.getNextBag();
+        int nextVisible = visibleEnd - static_cast<int>(currentBag.size());
+        if (nextVisible < static_cast<int>(nextBag.size())) {
+            query.unseenBagPieces.assign(nextBag.begin() + nextVisible, nextBag.end());
+        }
+    }
+    std::sort(query.unseenBagPieces.begin(), query.unseenBagPieces.end());
+
+    if (allTetrominoes(currentBag)) {
+        query.freshBag = currentBag;
+        std::sort(query.freshBag.begin(), query.freshBag.end());
+    }
+    return query;
+}
+
+PcSolution solvePerfectClear(const PcQuery& query) {
+    PcSolution solution;
+
+    std::vector<PieceType> known;
+    known.push_back(query.current);
+    for (PieceType piece : query.queue) {
+        if (static_cast<int>(known.size()) >= MAX_KNOWN_PIECES) break;
+        known.push_back(piece);
+    }
+    if (!allTetrominoes(known) || (query.hasHold && !isTetromino(query.hold))) {
+        return solution;
+    }
+    solution.supported = true;
+
+    int cells = countBoardCells(query.board);
+    int stackHeight = 0;
+    for (int y = 0; y < GRID_HEIGHT; ++y) {
+        if (query.board[y]) {
+            stackHeight = GRID_HEIGHT - y;
+            break;
+        }
+    }
+
+    SolverNode root;
+    root.board = query.board;
+    root.hasHold = query.hasHold;
+    root.hold = query.hold;
+    root.canHold = query.canHold;
+    if (allTetrominoes(query.unseenBagPieces)) {
+        root.bag = countPieces(query.unseenBagPieces);
+    }
+
+    int maxHeight = std::min(query.maxHeight, MAX_SOLVER_HEIGHT);
+    for (int height = std::max(stackHeight, 1); height <= maxHeight; ++height) {
+        if ((height * GRID_WIDTH - cells) % 4 != 0) continue;
+        root.height = height;
+
+        for (bool speculate : {true, false}) {
+            SharedSearch shared;
+            shared.query = &query;
+            shared.known = known;
+            shared.freshBag = countPieces(query.freshBag);
+            shared.freshBagSize = bagTotal(shared.freshBag);
+            shared.speculate = speculate;
+
+            std::vector<PcStep> steps;
+            bool found = runSearch(shared, root, steps);
+            solution.nodesSearched += shared.nodes.load();
+            solution.budgetExhausted = solution.budgetExhausted || shared.budgetExhausted;
+            if (found) {
+                solution.found = true;
+                solution.guaranteed = speculate;
+                solution.height = height;
+                solution.piecesNeeded = (height * GRID_WIDTH - cells) / 4;
+                solution.steps = steps;
+                std::cout << "[PC SOLVER] Found " << (speculate ? "guaranteed" : "possible")
+                          << " perfect clear in " << height << " rows (" << solution.piecesNeeded
+                          << " pieces, " << solution.nodesSearched << " nodes)" << std::endl;
+                return solution;
+            }
+            if (query.cancel && query.cancel->load()) return solution;
+        }
+    }
+
+    std::cout << "[PC SOLVER] No perfect clear found (" << solution.nodesSearched << " nodes)" << std::endl;
+    return solution;
+}
+
+
+
+
+
+PerfectClearTrainer::~PerfectClearTrainer() {
+    cancelFlag = true;
+}
+
+void PerfectClearTrainer::setEnabled(bool value) {
+    enabled = value;
+    if (!enabled) {
+        cancelFlag = pending;
+        solution = PcSolution();
+        solvedKey = 0;
+        stepsFollowed = 0;
+    }
+}
+
+void PerfectClearTrainer::reset() {
+    cancelFlag = pending;
+    solution = PcSolution();
+    solvedKey = 0;
+    stepsFollowed = 0;
+}
+
+void PerfectClearTrainer::update(const PcQuery& query) {
+    std::uint64_t key = 1469598103934665603ull;
+    auto mix = [&key](std::uint64_t value) {
+        key ^= value;
+        key *= 1099511628211ull;
+    };
+    for (std::uint16_t row : query.board) mix(row);
+    mix(static_cast<std::uint64_t>(query.current));
+    mix(query.hasHold ? static_cast<std::uint64_t>(query.hold) + 1 : 0);
+    mix(query.canHold);
+    for (PieceType piece : query.queue) mix(static_cast<std::uint64_t>(piece));
+
+    if (pending && solveFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        PcSolution result = solveFuture.get();
+        pending = false;
+        if (!cancelFlag && pendingKey == key) {
+            solution = result;
+            solvedKey = key;
+        }
+        cancelFlag = false;
+    }
+
+    if (!enabled) return;
+
+    if (solvedKey != key) {
+        solution = PcSolution();
+        solution.supported = true;
+    }
+
+    if (pending) {
+        if (pendingKey != key) cancelFlag = true;
+        return;
+    }
+
+    if (solvedKey != key) {
+        pendingKey = key;
+        pending = true;
+        PcQuery request = query;
+        request.cancel = &cancelFlag;
+        solveFuture = std::async(std::launch::async, solvePerfectClear, request);
+    }
+}
+
+void PerfectClearTrainer::onPieceLocked(const Placement& placed) {
+    if (!enabled) return;
+    PcStep target;
+    if (getTarget(target) && samePlacementCells(placed, target.placement)) {
+        stepsFollowed++;
+    } else {
+        stepsFollowed = 0;
+    }
+}
+
+bool PerfectClearTrainer::getTarget(PcStep& step) const {
+    if (!enabled || pending || !solution.found || solution.steps.empty()) return false;
+    step = solution.steps.front();
+    return true;
+}
@@ -0,0 +1,93 @@
+﻿#ifndef PC_SOLVER_H
+#define PC_SOLVER_H
+
+#include "types.h"
+#include "bitboard.h"
+#include "placement_search.h"
+#include <vector>
+#include <future>
+#include <atomic>
+
+
+
+
+struct PcQuery {
+    BoardRows board{};
+    PieceType current = PieceType::I_Basic;
+    bool hasHold = false;
+    PieceType hold = PieceType::I_Basic;
+    bool canHold = true;
+    std::vector<PieceType> queue;
+
+    std::vector<PieceType> unseenBagPieces;
+    std::vector<PieceType> freshBag;
+    int maxHeight = 6;
+    long long nodeBudget = 4000000;
+    int threadCount = 0;
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+
+struct PcStep {
+    Placement placement;
+    bool useHold = false;
+};
+
+
+struct PcSolution {
+    bool supported = false;
+    bool found = false;
+    bool guaranteed = false;
+    bool budgetExhausted = false;
+    int height = 0;
+    int piecesNeeded = 0;
+    std::vector<PcStep> steps;
+    long long nodesSearched = 0;
+};
+
+
+
+
+
+PcQuery makePcQuery(
+    const std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid,
+    PieceType current,
+    bool hasHold,
+    PieceType hold,
+    bool canHold,
+    const PieceBag& bag
+);
+
+
+PcSolution solvePerfectClear(const PcQuery& query);
+
+
+
+
+
+class PerfectClearTrainer {
+private:
+    bool enabled = false;
+    bool pending = false;
+    std::uint64_t pendingKey = 0;
+    std::uint64_t solvedKey = 0;
+    std::atomic<bool> cancelFlag{false};
+    std::future<PcSolution> solveFuture;
+    PcSolution solution;
+    int stepsFollowed = 0;
+
+public:
+    ~PerfectClearTrainer();
+    bool isEnabled() const { return enabled; }
+    bool isSearching() const { return pending; }
+    const PcSolution& getSolution() const { return solution; }
+    int getStepsFollowed() const { return stepsFollowed; }
+
+    void setEnabled(bool value);
+    void reset();
+    void update(const PcQuery& query);
+    void onPieceLocked(const Placement& placed);
+    bool getTarget(PcStep& step) const;
+};
+
+#endif
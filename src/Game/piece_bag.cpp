@@ -0,0 +1,299 @@
+﻿#include "types.h"
+#include "difficulty_config.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+
+
+
+
+std::vector<PieceType> PieceBag::createNewBag(int level) {
+    if (logging) std::cout << "Creating bag for level: " << level << std::endl;
+    std::vector<PieceType> newBag;
+    
+
+    std::vector<PieceType> basicTypes = {
+        PieceType::I_Basic, PieceType::T_Basic, PieceType::L_Basic, 
+        PieceType::J_Basic, PieceType::O_Basic, PieceType::S_Basic, PieceType::Z_Basic,
+    };
+    
+
+    if (difficultyConfig && difficultyConfig->useCustomPieceFilter && !difficultyConfig->allowedBasicPieces.empty()) {
+        basicTypes = difficultyConfig->allowedBasicPieces;
+        if (logging) std::cout << "Using custom basic pieces filter (" << basicTypes.size() << " pieces)" << std::endl;
+    }
+    
+
+    if (!difficultyConfig) {
+        if (logging) std::cout << "WARNING: No difficulty config set, using fallback" << std::endl;
+
+        if (level < 1) {
+            newBag = basicTypes;
+        } else if (level <= 5) {
+            newBag = basicTypes;
+            for (int i = 0; i < std::min(level, 2); i++) {
+                if (mediumBagIndex >= mediumBag.size()) refillMediumBag();
+                newBag.push_back(mediumBag[mediumBagIndex++]);
+            }
+            if (level >= 2) {
+                for (int i = 0; i < std::min(level - 2, 2); i++) {
+                    if (hardBagIndex >= hardBag.size()) refillHardBag();
+                    newBag.push_back(hardBag[hardBagIndex++]);
+                }
+            }
+        }
+        shuffleBag(newBag);
+        return newBag;
+    }
+    
+
+    BagLevelConfig bagConfig = {7, 0, 0};
+    
+    for (const auto& threshold : difficultyConfig->levelThresholds) {
+        if (level >= threshold.lines / 10) {
+            bagConfig = threshold.bagConfig;
+        }
+    }
+    
+
+    int bestThreshold = 0;
+    for (size_t i = 0; i < difficultyConfig->levelThresholds.size(); i++) {
+        if (level >= static_cast<int>(i)) {
+            bagConfig = difficultyConfig->levelThresholds[i].bagConfig;
+        }
+    }
+    
+    if (logging) std::cout << "Bag config for level " << level << ": " 
+              << bagConfig.basicPieces << " basic, " 
+              << bagConfig.mediumPieces << " medium, " 
+              << bagConfig.hardPieces << " hard" << std::endl;
+    
+
+    for (int i = 0; i < bagConfig.basicPieces; i++) {
+        newBag.push_back(basicTypes[i % basicTypes.size()]);
+    }
+    
+
+    for (int i = 0; i < bagConfig.mediumPieces; i++) {
+        if (mediumBagIndex >= mediumBag.size()) refillMediumBag();
+        newBag.push_back(mediumBag[mediumBagIndex++]);
+    }
+    
+
+    for (int i = 0; i < bagConfig.hardPieces; i++) {
+        if (hardBagIndex >= hardBag.size()) refillHardBag();
+        newBag.push_back(hardBag[hardBagIndex++]);
+    }
+    
+    shuffleBag(newBag);
+    return newBag;
+}
+
+void PieceBag::shuffleBag(std::vector<PieceType>& bag) {
+    std::seed_seq shuffleSeed{seed, static_cast<std::uint32_t>(shuffleCount), static_cast<std::uint32_t>(shuffleCount >> 32)};
+    rng.seed(shuffleSeed);
+    shuffleCount++;
+    for (size_t i = bag.size(); i > 1; --i) {
+        size_t j = static_cast<size_t>(rng() % i);
+        std::swap(bag[i - 1], bag[j]);
+    }
+}
+
+void PieceBag::ensureNextBagReady() {
+    if (!nextBagReady) {
+        nextBag = createNewBag(currentLevel);
+        nextBagReady = true;
+    }
+}
+
+void PieceBag::fillNextQueue() {
+    nextQueue.clear();
+    int tempBagIndex = bagIndex;
+    
+    for (int i = 0; i < 3; ++i) {
+        if (tempBagIndex >= currentBag.size()) {
+            ensureNextBagReady();
+            int nextBagIdx = tempBagIndex - currentBag.size();
+            nextQueue.push_back(nextBag[nextBagIdx]);
+            tempBagIndex++;
+        } else {
+            nextQueue.push_back(currentBag[tempBagIndex++]);
+        }
+    }
+}
+
+void PieceBag::refillMediumBag() {
+
+    std::vector<PieceType> defaultMediumTypes = {
+        PieceType::I_Medium, PieceType::T_Medium, PieceType::L_Medium, 
+        PieceType::J_Medium, PieceType::O_Medium, PieceType::S_Medium, PieceType::Z_Medium
+    };
+    
+
+    if (difficultyConfig && difficultyConfig->useCustomPieceFilter && !difficultyConfig->allowedMediumPieces.empty()) {
+        mediumBag = difficultyConfig->allowedMediumPieces;
+    } else {
+        mediumBag = defaultMediumTypes;
+    }
+    
+    shuffleBag(mediumBag);
+    mediumBagIndex = 0;
+    if (logging) std::cout << "Medium bag refilled and shuffled (" << mediumBag.size() << " pieces)" << std::endl;
+}
+
+void PieceBag::refillHardBag() {
+
+    std::vector<PieceType> defaultHardTypes = {
+        PieceType::I_Hard, PieceType::T_Hard, PieceType::L_Hard, 
+        PieceType::J_Hard, PieceType::O_Hard, PieceType::S_Hard, PieceType::Z_Hard
+    };
+    
+
+    if (difficultyConfig && difficultyConfig->useCustomPieceFilter && !difficultyConfig->allowedHardPieces.empty()) {
+        hardBag = difficultyConfig->allowedHardPieces;
+    } else {
+        hardBag = defaultHardTypes;
+    }
+    
+    shuffleBag(hardBag);
+    hardBagIndex = 0;
+    if (logging) std::cout << "Hard bag refilled and shuffled (" << hardBag.size() << " pieces)" << std::endl;
+}
+
+PieceBag::PieceBag() : PieceBag(std::random_device{}()) {
+}
+
+PieceBag::PieceBag(std::uint32_t seed, bool logging) : seed(seed), currentLevel(0), logging(logging) {
+    if (logging) std::cout << "PieceBag constructor: currentLevel = " << currentLevel << std::endl;
+    refillMediumBag();
+    refillHardBag();
+    currentBag = createNewBag(currentLevel);
+    bagIndex = 0;
+    fillNextQueue();
+}
+
+PieceType PieceBag::getNextPiece() {
+    if (bagIndex >= currentBag.size()) {
+        ensureNextBagReady();
+        currentBag = nextBag;
+        bagIndex = 0;
+        nextBagReady = false;
+    }
+    
+    PieceType piece = currentBag[bagIndex++];
+    fillNextQueue();
+    return piece;
+}
+
+void PieceBag::reseed(std::uint32_t newSeed) {
+    seed = newSeed;
+    shuffleCount = 0;
+}
+
+std::uint32_t PieceBag::getSeed() const {
+    return seed;
+}
+
+PieceBagState PieceBag::captureState() const {
+    PieceBagState state;
+    state.currentBag = currentBag;
+    state.nextBag = nextBag;
+    state.nextQueue = nextQueue;
+    state.mediumBag = mediumBag;
+    state.hardBag = hardBag;
+    state.bagIndex = bagIndex;
+    state.mediumBagIndex = mediumBagIndex;
+    state.hardBagIndex = hardBagIndex;
+    state.currentLevel = currentLevel;
+    state.nextBagReady = nextBagReady;
+    state.seed = seed;
+    state.shuffleCount = shuffleCount;
+    return state;
+}
+
+void PieceBag::restoreState(const PieceBagState& state) {
+    currentBag = state.currentBag;
+    nextBag = state.nextBag;
+    nextQueue = state.nextQueue;
+    mediumBag = state.mediumBag;
+    hardBag = state.hardBag;
+    bagIndex = state.bagIndex;
+    mediumBagIndex = state.mediumBagIndex;
+    hardBagIndex = state.hardBagIndex;
+    currentLevel = state.currentLevel;
+    nextBagReady = state.nextBagReady;
+    seed = state.seed;
+    shuffleCount = state.shuffleCount;
+}
+
+void PieceBag::updateLevel(int newLevel) {
+    if (newLevel != currentLevel) {
+        currentLevel = newLevel;
+        if (logging) std::cout << "Bag difficulty updated to level " << currentLevel << "!" << std::endl;
+    }
+}
+
+const std::vector<PieceType>& PieceBag::getNextQueue() const {
+    return nextQueue;
+}
+
+const std::vector<PieceType>& PieceBag::getCurrentBag() const {
+    return currentBag;
+}
+
+const std::vector<PieceType>& PieceBag::getNextBag() const {
+    return nextBag;
+}
+
+int PieceBag::getBagIndex() const {
+    return bagIndex;
+}
+
+bool PieceBag::isNextBagReady() const {
+    return nextBagReady;
+}
+
+void PieceBag::reset() {
+    reset(0);
+}
+
+void PieceBag::reset(int startLevel) {
+    currentLevel = startLevel;
+    bagIndex = 0;
+    nextBagReady = false;
+    refillMediumBag();
+    refillHardBag();
+    currentBag = createNewBag(currentLevel);
+    nextBag.clear();
+    nextQueue.clear();
+    fillNextQueue();
+    if (logging) std::cout << "Bag system reset to level " << currentLevel << "!" << std::endl;
+}
+
+void PieceBag::setDifficultyConfig(const DifficultyConfig* config) {
+    difficultyConfig = config;
+    if (logging) std::cout << "Difficulty config set to: " << (config ? config->modeName : "nullptr") << std::endl;
+    if (logging && config) {
+        std::cout << "  Max Levels: " << config->maxLevels << std::endl;
+        std::cout << "  Line Goal: " << (config->hasLineGoal ? std::to_string(config->lineGoal) : "None") << std::endl;
+        std::cout << "  Bomb: " << (config->bombEnabled ? "Yes" : "No") << std::endl;
+        std::cout << "  Hold: " << (config->holdEnabled ? "Yes" : "No") << std::endl;
+    }
+}
+
+void PieceBag::returnPieceToBag(PieceType piece) {
+    if (logging) std::cout << "[DEBUG] Returning piece to bag at position " << bagIndex << " (will be next piece)" << std::endl;
+    currentBag.insert(currentBag.begin() + bagIndex, piece);
+    fillNextQueue();
+    if (logging) std::cout << "[DEBUG] Bag size after return: " << currentBag.size() << std::endl;
+}
+
+void PieceBag::insertPiecesToQueue(PieceType piece, int count) {
+    if (logging) std::cout << "[DEBUG] Inserting " << count << " pieces into queue at position " << bagIndex << std::endl;
+    for (int i = 0; i < count; i++) {
+        currentBag.insert(currentBag.begin() + bagIndex + i, piece);
+    }
+    fillNextQueue();
+    if (logging) std::cout << "[DEBUG] Bag size after insert: " << currentBag.size() << std::endl;
+}
@@ -0,0 +1,113 @@
+﻿#include "piece_mask.h"
+#include <algorithm>
+
+
+
+
+
+namespace {
+
+PieceBlocks rotateRight(const PieceBlocks& original) {
+    int height = static_cast<int>(original.size());
+    int width = height > 0 ? static_cast<int>(original[0].size()) : 0;
+    PieceBlocks rotated(width, std::vector<bool>(height, false));
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            if (original[i][j]) {
+                rotated[j][height - 1 - i] = true;
+            }
+        }
+    }
+    return rotated;
+}
+
+constexpr int PIECE_TYPE_COUNT = static_cast<int>(PieceType::A_Stomp) + 1;
+
+struct PieceMaskTable {
+    std::array<std::array<PieceMask, PIECE_ROTATIONS>, PIECE_TYPE_COUNT> masks;
+
+    PieceMaskTable() {
+        for (int t = 0; t < PIECE_TYPE_COUNT; ++t) {
+            PieceBlocks blocks = getPieceBlocks(static_cast<PieceType>(t));
+            for (int r = 0; r < PIECE_ROTATIONS; ++r) {
+                masks[t][r] = buildPieceMask(blocks);
+                blocks = rotateRight(blocks);
+            }
+        }
+    }
+};
+
+}
+
+PieceMask buildPieceMask(const PieceBlocks& blocks) {
+    PieceMask mask;
+    mask.height = static_cast<int>(blocks.size());
+    mask.width = mask.height > 0 ? static_cast<int>(blocks[0].size()) : 0;
+    mask.minCol = mask.width;
+    mask.maxCol = -1;
+    mask.minRow = mask.height;
+    mask.maxRow = -1;
+    for (int i = 0; i < mask.height && i < MAX_PIECE_SPAN; ++i) {
+        for (int j = 0; j < mask.width && j < MAX_PIECE_SPAN; ++j) {
+            if (!blocks[i][j]) continue;
+            mask.rows[i] |= static_cast<std::uint16_t>(1u << j);
+            mask.minCol = std::min(mask.minCol, j);
+            mask.maxCol = std::max(mask.maxCol, j);
+            mask.minRow = std::min(mask.minRow, i);
+            mask.maxRow = std::max(mask.maxRow, i);
+            mask.cellCount++;
+        }
+    }
+    return mask;
+}
+
+const PieceMask& getPieceMask(PieceType type, int rotation) {
+    static const PieceMaskTable table;
+    return table.masks[static_cast<int>(type)][rotation & (PIECE_ROTATIONS - 1)];
+}
+
+bool isTetromino(PieceType type) {
+    return type >= PieceType::I_Basic && type <= PieceType::Z_Basic;
+}
+
+int getSpawnX(PieceType type) {
+    return (GRID_WIDTH - getPieceMask(type, 0).width) / 2;
+}
+
+int getSpawnY(PieceType type) {
+    return -getPieceMask(type, 0).minRow;
+}
+
+void placeMask(BoardRows& board, const PieceMask& mask, int x, int y) {
+    for (int i = mask.minRow; i <= mask.maxRow; ++i) {
+        int gy = y + i;
+        if (gy < 0 || gy >= GRID_HEIGHT) continue;
+        board[gy] |= shiftMaskRow(mask.rows[i], x);
+    }
+}
+
+int clearFullBoardRows(BoardRows& board) {
+    int cleared = 0;
+    int writeRow = GRID_HEIGHT - 1;
+    for (int readRow = GRID_HEIGHT - 1; readRow >= 0; --readRow) {
+        if (board[readRow] == FULL_ROW_MASK) {
+            cleared++;
+            continue;
+        }
+        board[writeRow--] = board[readRow];
+    }
+    while (writeRow >= 0) {
+        board[writeRow--] = 0;
+    }
+    return cleared;
+}
+
+int countBoardCells(const BoardRows& board) {
+    int count = 0;
+    for (std::uint16_t row : board) {
+        for (std::uint16_t bits = row; bits; bits &= static_cast<std::uint16_t>(bits - 1)) {
+            count++;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,71 @@
+﻿#ifndef PIECE_MASK_H
+#define PIECE_MASK_H
+
+#include "board_types.h"
+#include "piece_blocks.h"
+#include <array>
+#include <cstdint>
+
+
+
+
+using BoardRows = std::array<std::uint16_t, GRID_HEIGHT>;
+
+constexpr std::uint16_t FULL_ROW_MASK = static_cast<std::uint16_t>((1u << GRID_WIDTH) - 1);
+constexpr int PIECE_ROTATIONS = 4;
+constexpr int MAX_PIECE_SPAN = 5;
+
+
+// Rotation r is the spawn shape rotated right r times, laid out exactly like
+// Piece::getShape() so (x, y) here is the same origin the Piece class uses.
+struct PieceMask {
+    int width = 0;
+    int height = 0;
+    int minCol = 0;
+    int maxCol = 0;
+    int minRow = 0;
+    int maxRow = 0;
+    int cellCount = 0;
+    std::uint16_t rows[MAX_PIECE_SPAN] = {};
+};
+
+
+PieceMask buildPieceMask(const PieceBlocks& blocks);
+
+
+const PieceMask& getPieceMask(PieceType type, int rotation);
+
+
+bool isTetromino(PieceType type);
+
+
+int getSpawnX(PieceType type);
+int getSpawnY(PieceType type);
+
+
+inline std::uint16_t shiftMaskRow(std::uint16_t row, int x) {
+    return static_cast<std::uint16_t>(x >= 0 ? (row << x) : (row >> -x));
+}
+
+
+inline bool maskCollides(const BoardRows& board, const PieceMask& mask, int x, int y) {
+    if (x + mask.minCol < 0 || x + mask.maxCol >= GRID_WIDTH) return true;
+    for (int i = mask.minRow; i <= mask.maxRow; ++i) {
+        int gy = y + i;
+        if (gy >= GRID_HEIGHT) return true;
+        if (gy < 0) continue;
+        if (board[gy] & shiftMaskRow(mask.rows[i], x)) return true;
+    }
+    return false;
+}
+
+
+void placeMask(BoardRows& board, const PieceMask& mask, int x, int y);
+
+
+int clearFullBoardRows(BoardRows& board);
+
+
+int countBoardCells(const BoardRows& board);
+
+#endif
@@ -0,0 +1,298 @@
+﻿#include "placement_search.h"
+#include <array>
+#include <algorithm>
+
+
+
+
+
+namespace {
+
+constexpr int X_OFFSET = MAX_PIECE_SPAN;
+constexpr int Y_OFFSET = MAX_PIECE_SPAN;
+constexpr int X_RANGE = GRID_WIDTH + MAX_PIECE_SPAN;
+constexpr int Y_RANGE = GRID_HEIGHT + MAX_PIECE_SPAN;
+constexpr int STATE_COUNT = PIECE_ROTATIONS * X_RANGE * Y_RANGE;
+constexpr int INPUT_COUNT = 8;
+
+constexpr int KICK_OFFSETS[][2] = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {-2, 0}, {2, 0}};
+
+struct SearchState {
+    int rotation;
+    int x;
+    int y;
+};
+
+inline int stateIndex(int rotation, int x, int y) {
+    return (rotation * Y_RANGE + (y + Y_OFFSET)) * X_RANGE + (x + X_OFFSET);
+}
+
+inline bool inRange(int x, int y) {
+    return x + X_OFFSET >= 0 && x + X_OFFSET < X_RANGE && y + Y_OFFSET >= 0 && y + Y_OFFSET < Y_RANGE;
+}
+
+int dropDistance(const BoardRows& board, const PieceMask& mask, int x, int y) {
+    int drop = 0;
+    while (!maskCollides(board, mask, x, y + drop + 1)) {
+        drop++;
+    }
+    return drop;
+}
+
+bool applyInput(const BoardRows& board, PieceType type, PlacementInput input, const SearchState& from, SearchState& to) {
+    const PieceMask& mask = getPieceMask(type, from.rotation);
+    to = from;
+    switch (input) {
+        case PlacementInput::Left:
+            to.x--;
+            return !maskCollides(board, mask, to.x, to.y);
+        case PlacementInput::Right:
+            to.x++;
+            return !maskCollides(board, mask, to.x, to.y);
+        case PlacementInput::DasLeft:
+            while (!maskCollides(board, mask, to.x - 1, to.y)) to.x--;
+            return to.x != from.x;
+        case PlacementInput::DasRight:
+            while (!maskCollides(board, mask, to.x + 1, to.y)) to.x++;
+            return to.x != from.x;
+        case PlacementInput::SoftDrop:
+            to.y++;
+            return !maskCollides(board, mask, to.x, to.y);
+        case PlacementInput::SonicDrop:
+            to.y += dropDistance(board, mask, to.x, to.y);
+            return to.y != from.y;
+        case PlacementInput::RotateRight:
+        case PlacementInput::RotateLeft: {
+            int rotation = (from.rotation + (input == PlacementInput::RotateRight ? 1 : PIECE_ROTATIONS - 1)) % PIECE_ROTATIONS;
+            const PieceMask& rotated = getPieceMask(type, rotation);
+            for (const auto& kick : KICK_OFFSETS) {
+                int testX = from.x + kick[0];
+                int testY = from.y + kick[1];
+                if (!maskCollides(board, rotated, testX, testY)) {
+                    to.rotation = rotation;
+                    to.x = testX;
+                    to.y = testY;
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+    return false;
+}
+
+struct SearchResult {
+    std::array<std::int16_t, STATE_COUNT> dist;
+    std::array<std::int16_t, STATE_COUNT> parent;
+    std::array<std::uint8_t, STATE_COUNT> parentInput;
+    std::vector<int> order;
+};
+
+std::uint64_t columnKey(PieceType type, int rotation, int x) {
+    const PieceMask& mask = getPieceMask(type, rotation);
+    std::uint64_t key = static_cast<std::uint64_t>(x + mask.minCol + X_OFFSET);
+    key = (key << 3) | static_cast<std::uint64_t>(mask.maxRow - mask.minRow);
+    for (int i = mask.minRow; i <= mask.maxRow; ++i) {
+        key = (key << MAX_PIECE_SPAN) | static_cast<std::uint64_t>(mask.rows[i] >> mask.minCol);
+    }
+    return key;
+}
+
+// Returns the index of the first dequeued state whose hard drop lands on
+// target, or -1. Without a target the whole reachable space is explored.
+int runSearch(const BoardRows& board, PieceType type, const Placement& start, SearchResult& result, const Placement* target = nullptr) {
+    result.dist.fill(-1);
+    result.order.clear();
+    const PieceMask& startMask = getPieceMask(type, start.rotation);
+    if (!inRange(start.x, start.y) || maskCollides(board, startMask, start.x, start.y)) return -1;
+
+    std::uint64_t targetColumn = 0;
+    int targetTop = 0;
+    if (target) {
+        const PieceMask& targetMask = getPieceMask(target->type, target->rotation);
+        targetColumn = columnKey(target->type, target->rotation, target->x);
+        targetTop = target->y + targetMask.minRow;
+    }
+
+    int startIndex = stateIndex(start.rotation, start.x, start.y);
+    result.dist[startIndex] = 0;
+    result.parent[startIndex] = -1;
+    result.order.push_back(startIndex);
+
+    for (size_t head = 0; head < result.order.size(); ++head) {
+        int index = result.order[head];
+        SearchState state;
+        state.x = index % X_RANGE - X_OFFSET;
+        state.y = (index / X_RANGE) % Y_RANGE - Y_OFFSET;
+        state.rotation = index / (X_RANGE * Y_RANGE);
+
+        if (target && columnKey(type, state.rotation, state.x) == targetColumn) {
+            const PieceMask& mask = getPieceMask(type, state.rotation);
+            if (state.y + dropDistance(board, mask, state.x, state.y) + mask.minRow == targetTop) {
+                return index;
+            }
+        }
+
+        for (int i = 0; i < INPUT_COUNT; ++i) {
+            SearchState next;
+            if (!applyInput(board, type, static_cast<PlacementInput>(i), state, next)) continue;
+            if (!inRange(next.x, next.y)) continue;
+            int nextIndex = stateIndex(next.rotation, next.x, next.y);
+            if (result.dist[nextIndex] >= 0) continue;
+            result.dist[nextIndex] = static_cast<std::int16_t>(result.dist[index] + 1);
+            result.parent[nextIndex] = static_cast<std::int16_t>(index);
+            result.parentInput[nextIndex] = static_cast<std::uint8_t>(i);
+            result.order.push_back(nextIndex);
+        }
+    }
+    return -1;
+}
+
+std::uint64_t footprintKey(const Placement& placement) {
+    const PieceMask& mask = getPieceMask(placement.type, placement.rotation);
+    std::uint64_t key = static_cast<std::uint64_t>(placement.y + mask.minRow + Y_OFFSET);
+    key = (key << 5) | static_cast<std::uint64_t>(placement.x + mask.minCol + X_OFFSET);
+    key = (key << 3) | static_cast<std::uint64_t>(mask.maxRow - mask.minRow);
+    for (int i = mask.minRow; i <= mask.maxRow; ++i) {
+        key = (key << MAX_PIECE_SPAN) | static_cast<std::uint64_t>(mask.rows[i] >> mask.minCol);
+    }
+    return key;
+}
+
+}
+
+void findReachablePlacements(const BoardRows& board, PieceType type, std::vector<ReachablePlacement>& out) {
+    Placement start;
+    start.type = type;
+    start.rotation = 0;
+    start.x = getSpawnX(type);
+    start.y = getSpawnY(type);
+    findReachablePlacementsFrom(board, start, out);
+}
+
+void findReachablePlacementsFrom(const BoardRows& board, const Placement& start, std::vector<ReachablePlacement>& out) {
+    out.clear();
+    thread_local SearchResult result;
+    runSearch(board, start.type, start, result);
+
+    std::vector<std::uint64_t> keys;
+    for (int index : result.order) {
+        Placement placement;
+        placement.type = start.type;
+        placement.x = index % X_RANGE - X_OFFSET;
+        placement.y = (index / X_RANGE) % Y_RANGE - Y_OFFSET;
+        placement.rotation = index / (X_RANGE * Y_RANGE);
+        const PieceMask& mask = getPieceMask(start.type, placement.rotation);
+
+        int cost = result.dist[index];
+        int drop = dropDistance(board, mask, placement.x, placement.y);
+        placement.y += drop;
+
+        std::uint64_t key = footprintKey(placement);
+        auto it = std::find(keys.begin(), keys.end(), key);
+        if (it == keys.end()) {
+            keys.push_back(key);
+            out.push_back({placement, cost});
+        } else {
+            ReachablePlacement& existing = out[it - keys.begin()];
+            if (cost < existing.inputCount) {
+                existing.placement = placement;
+                existing.inputCount = cost;
+            }
+        }
+    }
+}
+
+void findRegionPlacements(const BoardRows& board, PieceType type, int regionTop, std::vector<Placement>& out) {
+    out.clear();
+    thread_local std::array<bool, STATE_COUNT> visited;
+    thread_local std::vector<int> order;
+    visited.fill(false);
+    order.clear();
+
+    for (int rotation = 0; rotation < PIECE_ROTATIONS; ++rotation) {
+        const PieceMask& mask = getPieceMask(type, rotation);
+        int seedY = regionTop - 1 - mask.maxRow;
+        for (int x = -mask.minCol; x + mask.maxCol < GRID_WIDTH; ++x) {
+            if (!inRange(x, seedY)) continue;
+            int index = stateIndex(rotation, x, seedY);
+            visited[index] = true;
+            order.push_back(index);
+        }
+    }
+
+    constexpr PlacementInput moves[] = {
+        PlacementInput::SoftDrop, PlacementInput::Left, PlacementInput::Right,
+        PlacementInput::RotateRight, PlacementInput::RotateLeft
+    };
+    std::vector<std::uint64_t> keys;
+    for (size_t head = 0; head < order.size(); ++head) {
+        int index = order[head];
+        SearchState state;
+        state.x = index % X_RANGE - X_OFFSET;
+        state.y = (index / X_RANGE) % Y_RANGE - Y_OFFSET;
+        state.rotation = index / (X_RANGE * Y_RANGE);
+        const PieceMask& mask = getPieceMask(type, state.rotation);
+
+        if (maskCollides(board, mask, state.x, state.y + 1) && state.y + mask.minRow >= regionTop) {
+            Placement placement;
+            placement.type = type;
+            placement.rotation = state.rotation;
+            placement.x = state.x;
+            placement.y = state.y;
+            std::uint64_t key = footprintKey(placement);
+            if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+                keys.push_back(key);
+                out.push_back(placement);
+            }
+        }
+
+        for (PlacementInput input : moves) {
+            SearchState next;
+            if (!applyInput(board, type, input, state, next)) continue;
+            if (next.y + getPieceMask(type, next.rotation).maxRow < regionTop - 1) continue;
+            if (!inRange(next.x, next.y)) continue;
+            int nextIndex = stateIndex(next.rotation, next.x, next.y);
+            if (visited[nextIndex]) continue;
+            visited[nextIndex] = true;
+            order.push_back(nextIndex);
+        }
+    }
+}
+
+bool findInputPath(const BoardRows& board, const Placement& target, std::vector<PlacementInput>& path) {
+    path.clear();
+    Placement start;
+    start.type = target.type;
+    start.rotation = 0;
+    start.x = getSpawnX(target.type);
+    start.y = getSpawnY(target.type);
+
+    thread_local SearchResult result;
+    int best = runSearch(board, target.type, start, result, &target);
+    if (best < 0) return false;
+
+    for (int index = best; result.parent[index] >= 0 && result.dist[index] > 0; index = result.parent[index]) {
+        path.push_back(static_cast<PlacementInput>(result.parentInput[index]));
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+bool samePlacementCells(const Placement& a, const Placement& b) {
+    return a.type == b.type && footprintKey(a) == footprintKey(b);
+}
+
+const char* placementInputToString(PlacementInput input) {
+    switch (input) {
+        case PlacementInput::Left: return "LEFT";
+        case PlacementInput::Right: return "RIGHT";
+        case PlacementInput::DasLeft: return "DAS LEFT";
+        case PlacementInput::DasRight: return "DAS RIGHT";
+        case PlacementInput::RotateRight: return "ROTATE R";
+        case PlacementInput::RotateLeft: return "ROTATE L";
+        case PlacementInput::SoftDrop: return "SOFT DROP";
+        case PlacementInput::SonicDrop: return "DROP";
+    }
+    return "";
+}
@@ -0,0 +1,78 @@
+﻿#ifndef PLACEMENT_SEARCH_H
+#define PLACEMENT_SEARCH_H
+
+#include "bitboard.h"
+#include <vector>
+#include <cstdint>
+
+
+
+
+enum class PlacementInput : std::uint8_t {
+    Left,
+    Right,
+    DasLeft,
+    DasRight,
+    RotateRight,
+    RotateLeft,
+    SoftDrop,
+    SonicDrop
+};
+
+
+struct Placement {
+    PieceType type = PieceType::I_Basic;
+    int rotation = 0;
+    int x = 0;
+    int y = 0;
+};
+
+
+struct ReachablePlacement {
+    Placement placement;
+    int inputCount = 0;
+};
+
+
+// Breadth-first search over (rotation, x, y) using the same kick table as
+// Piece::rotateRight/rotateLeft. Every input costs one; hard drop is free.
+// Placements that cover the same cells are reported once, with the cheapest
+// input count.
+void findReachablePlacements(
+    const BoardRows& board,
+    PieceType type,
+    std::vector<ReachablePlacement>& out
+);
+
+
+void findReachablePlacementsFrom(
+    const BoardRows& board,
+    const Placement& start,
+    std::vector<ReachablePlacement>& out
+);
+
+
+// Faster variant for solvers: assumes every row above regionTop is empty, so
+// any rotation and column is reachable in the open air above the stack.
+// Only placements lying entirely inside the region are reported.
+void findRegionPlacements(
+    const BoardRows& board,
+    PieceType type,
+    int regionTop,
+    std::vector<Placement>& out
+);
+
+
+bool findInputPath(
+    const BoardRows& board,
+    const Placement& target,
+    std::vector<PlacementInput>& path
+);
+
+
+bool samePlacementCells(const Placement& a, const Placement& b);
+
+
+const char* placementInputToString(PlacementInput input);
+
+#endif
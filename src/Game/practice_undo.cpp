@@ -0,0 +1,69 @@
+﻿#include "practice_undo.h"
+#include <iostream>
+
+
+PracticeUndoHistory::PracticeUndoHistory() : entries(PRACTICE_UNDO_MAX_ENTRIES) {}
+
+std::string& PracticeUndoHistory::entryAt(int offset) {
+    return entries[(oldest + offset) % PRACTICE_UNDO_MAX_ENTRIES];
+}
+
+void PracticeUndoHistory::dropOldest() {
+    std::string& entry = entryAt(0);
+    storedBytes -= entry.size();
+    entry.clear();
+    oldest = (oldest + 1) % PRACTICE_UNDO_MAX_ENTRIES;
+    --count;
+    --cursor;
+}
+
+void PracticeUndoHistory::clear() {
+    for (std::string& entry : entries) {
+        entry.clear();
+    }
+    oldest = 0;
+    count = 0;
+    cursor = -1;
+    storedBytes = 0;
+}
+
+
+// Recording after an undo discards the redo branch, like any editor.
+void PracticeUndoHistory::record(const GameSnapshot& snapshot) {
+    while (count > cursor + 1) {
+        std::string& entry = entryAt(count - 1);
+        storedBytes -= entry.size();
+        entry.clear();
+        --count;
+    }
+
+    std::string packed = encodeGameSnapshot(snapshot);
+    while (count > 0 && (count == PRACTICE_UNDO_MAX_ENTRIES || storedBytes + packed.size() > PRACTICE_UNDO_MEMORY_BUDGET)) {
+        dropOldest();
+    }
+
+    storedBytes += packed.size();
+    entryAt(count) = std::move(packed);
+    ++count;
+    cursor = count - 1;
+}
+
+bool PracticeUndoHistory::undo(GameSnapshot& snapshot) {
+    if (!canUndo()) return false;
+    if (!decodeGameSnapshot(entryAt(cursor - 1), snapshot)) {
+        std::cout << "Undo snapshot could not be decoded" << std::endl;
+        return false;
+    }
+    --cursor;
+    return true;
+}
+
+bool PracticeUndoHistory::redo(GameSnapshot& snapshot) {
+    if (!canRedo()) return false;
+    if (!decodeGameSnapshot(entryAt(cursor + 1), snapshot)) {
+        std::cout << "Redo snapshot could not be decoded" << std::endl;
+        return false;
+    }
+    ++cursor;
+    return true;
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include "game_snapshot.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+constexpr int PRACTICE_UNDO_MAX_ENTRIES = 4096;
+constexpr std::size_t PRACTICE_UNDO_MEMORY_BUDGET = 2 * 1024 * 1024;
+
+
+// Placement history for practice mode. Every entry is the packed snapshot
+// taken right after a piece spawned, stored in a ring so the oldest entries
+// are dropped once either the entry count or the byte budget is exceeded.
+// The entry under the cursor is the current piece; undo/redo step the cursor
+// and hand back the neighbouring snapshot.
+class PracticeUndoHistory {
+private:
+    std::vector<std::string> entries;
+    int oldest = 0;
+    int count = 0;
+    int cursor = -1;
+    std::size_t storedBytes = 0;
+
+    std::string& entryAt(int offset);
+    void dropOldest();
+
+public:
+    PracticeUndoHistory();
+
+    void clear();
+    bool isEmpty() const { return count == 0; }
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor >= 0 && cursor < count - 1; }
+    int getUndoDepth() const { return cursor > 0 ? cursor : 0; }
+
+    void record(const GameSnapshot& snapshot);
+    bool undo(GameSnapshot& snapshot);
+    bool redo(GameSnapshot& snapshot);
+};
@@ -3,6 +3,11 @@
 
 #include <SFML/Window/Keyboard.hpp>
 #include "types.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
 
 
 
@@ -11,48 +16,173 @@
 struct DASConfig {
     float delay = 0.2f;
     float repeat = 0.04f;
+    float softDropInterval = 0.03f;
 };
 
 
 
 
 
-struct InputState {
+enum class InputAction : std::uint8_t {
+    MoveLeft,
+    MoveRight,
+    SoftDrop,
+    RotateLeft,
+    RotateRight,
+    Hold,
+    HardDrop
+};
+
+struct InputStep {
+    InputAction action;
+    double time;
+};
+
+
+// Shift and soft-drop keys as a timeline rather than a per-frame snapshot.
+// Key transitions are stamped with a high-resolution clock as they are read
+// from the window; each simulation step maps them onto game time and
+// yields every move at the instant it is due: the press itself, the DAS
+// shift at press + delay, then one shift per repeat interval, plus soft-drop
+// rows. Timers carry their remainders, so auto-shift neither snaps to frame
+// boundaries nor drifts with frame rate. Game time only advances while the
+// game is stepped, so a pause freezes a half-charged DAS. Rotations, holds
+// and hard drops are one-shot inputs on the same timeline, yielded at the
+// instant they were pressed.
+class InputTimeline {
+private:
+    struct TimedInput {
+        InputAction action;
+        bool pressed;
+        double time;
+    };
+
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::deque<TimedInput> incoming;
+    std::deque<TimedInput> pending;
+    bool queuedHeld[3] = {false, false, false};
+
+    bool leftHeld = false;
+    bool rightHeld = false;
+    bool softDropHeld = false;
+    int shiftDirection = 0;
+    double nextShiftTime = 0.0;
+    double nextSoftDropTime = 0.0;
+    bool initialShiftDue = false;
+
+    double cursor = 0.0;
+    double stepStart = 0.0;
+    double stepEnd = 0.0;
+    double lastStepWall = -1.0;
+
+    void push(InputAction action, bool pressed, double wallTime) {
+        int index = static_cast<int>(action);
+        if (queuedHeld[index] == pressed) return;
+        queuedHeld[index] = pressed;
+        incoming.push_back({action, pressed, wallTime});
+    }
+
+    void apply(const TimedInput& input, const DASConfig& config) {
+        if (input.action == InputAction::SoftDrop) {
+            softDropHeld = input.pressed;
+            if (softDropHeld) {
+                nextSoftDropTime = input.time;
+            }
+            return;
+        }
 
-    bool leftPressed = false;
-    bool rightPressed = false;
-    bool downPressed = false;
-    
+        (input.action == InputAction::MoveLeft ? leftHeld : rightHeld) = input.pressed;
 
-    float leftHoldTime = 0.0f;
-    float rightHoldTime = 0.0f;
-    float dasTimer = 0.0f;
-    
+        // Only a lone held direction shifts. A fresh press moves at once;
+        // a direction uncovered by releasing the other one only charges.
+        int direction = leftHeld != rightHeld ? (leftHeld ? -1 : 1) : 0;
+        if (direction == shiftDirection) return;
+        shiftDirection = direction;
+        initialShiftDue = direction != 0 && input.pressed;
+        nextShiftTime = input.pressed ? input.time : input.time + config.delay;
+    }
+
+public:
+    double now() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    void press(InputAction action, double wallTime) { push(action, true, wallTime); }
+    void release(InputAction action, double wallTime) { push(action, false, wallTime); }
+    void trigger(InputAction action, double wallTime) { incoming.push_back({action, true, wallTime}); }
 
-    bool fastFallActive = false;
-    
+    // Catches transitions the window never reported, such as a key let go
+    // while the game was out of focus.
+    void sync(bool leftDown, bool rightDown, bool softDropDown, double wallTime) {
+        push(InputAction::MoveLeft, leftDown, wallTime);
+        push(InputAction::MoveRight, rightDown, wallTime);
+        push(InputAction::SoftDrop, softDropDown, wallTime);
+    }
+
+    // Keys still held afterwards count as fresh presses at the next sync.
     void reset() {
-        leftPressed = false;
-        rightPressed = false;
-        downPressed = false;
-        leftHoldTime = 0.0f;
-        rightHoldTime = 0.0f;
-        dasTimer = 0.0f;
-        fastFallActive = false;
+        incoming.clear();
+        pending.clear();
+        queuedHeld[0] = queuedHeld[1] = queuedHeld[2] = false;
+        leftHeld = rightHeld = softDropHeld = false;
+        shiftDirection = 0;
+        initialShiftDue = false;
     }
-    
-    void update(float deltaTime, const DASConfig& config) {
 
-        if (leftPressed) {
-            leftHoldTime += deltaTime;
-        } else {
-            leftHoldTime = 0.0f;
+    void beginStep(double wallNow, float deltaTime) {
+        stepStart = cursor;
+        stepEnd = cursor + deltaTime;
+        for (const TimedInput& input : incoming) {
+            double offset = lastStepWall < 0.0 ? deltaTime : input.time - lastStepWall;
+            double time = stepStart + std::max(0.0, std::min(offset, static_cast<double>(deltaTime)));
+            pending.push_back({input.action, input.pressed, time});
         }
-        
-        if (rightPressed) {
-            rightHoldTime += deltaTime;
-        } else {
-            rightHoldTime = 0.0f;
+        incoming.clear();
+        lastStepWall = wallNow;
+    }
+
+    double getStepStart() const { return stepStart; }
+    double getStepEnd() const { return stepEnd; }
+    bool isSoftDropHeld() const { return softDropHeld; }
+
+    // Yields the next due action up to the end of the step, in time order.
+    bool next(const DASConfig& config, InputStep& step) {
+        const double never = std::numeric_limits<double>::infinity();
+        double repeat = std::max(static_cast<double>(config.repeat), 0.001);
+        double softDropInterval = std::max(static_cast<double>(config.softDropInterval), 0.001);
+
+        while (true) {
+            double shiftTime = shiftDirection != 0 ? nextShiftTime : never;
+            double softDropTime = softDropHeld ? nextSoftDropTime : never;
+            double inputTime = pending.empty() ? never : std::max(pending.front().time, cursor);
+            double due = std::min(inputTime, std::min(shiftTime, softDropTime));
+            if (due > stepEnd) {
+                cursor = stepEnd;
+                return false;
+            }
+            cursor = due;
+
+            if (inputTime <= std::min(shiftTime, softDropTime)) {
+                TimedInput input = pending.front();
+                pending.pop_front();
+                input.time = inputTime;
+                if (input.action > InputAction::SoftDrop) {
+                    step = {input.action, inputTime};
+                    return true;
+                }
+                apply(input, config);
+                continue;
+            }
+
+            if (shiftTime <= softDropTime) {
+                step = {shiftDirection < 0 ? InputAction::MoveLeft : InputAction::MoveRight, shiftTime};
+                nextShiftTime = initialShiftDue ? shiftTime + config.delay : shiftTime + repeat;
+                initialShiftDue = false;
+            } else {
+                step = {InputAction::SoftDrop, softDropTime};
+                nextSoftDropTime = softDropTime + softDropInterval;
+            }
+            return true;
         }
     }
 };
@@ -0,0 +1,65 @@
+﻿#include "analytics_log.h"
+#include "save_system.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+namespace {
+
+constexpr char ANALYTICS_MAGIC[4] = {'T', 'S', 'A', 'N'};
+constexpr std::uint16_t ANALYTICS_VERSION = 1;
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeRecord(std::ofstream& file, const GameAnalytics& analytics) {
+    writeValue(file, analytics.timestamp);
+    writeValue(file, analytics.mode);
+    writeValue(file, analytics.subMode);
+    writeValue(file, analytics.durationMs);
+    writeValue(file, analytics.piecesPlaced);
+    writeValue(file, analytics.totalInputs);
+    writeValue(file, analytics.totalRotations);
+    writeValue(file, analytics.holdsUsed);
+    writeValue(file, analytics.linesCleared);
+    writeValue(file, analytics.maxCombo);
+    writeValue(file, analytics.finesseFaults);
+    writeValue(file, analytics.piecesPerSecond);
+    writeValue(file, analytics.keysPerPiece);
+    writeValue(file, analytics.averagePlaceTime);
+    writeValue(file, analytics.medianPlaceTime);
+    for (std::uint32_t bucket : analytics.placeTimeHistogram) {
+        writeValue(file, bucket);
+    }
+}
+
+}
+
+std::string getAnalyticsFilePath() {
+    return (std::filesystem::path(getSaveFilePath()).parent_path() / "analytics.bin").string();
+}
+
+bool appendAnalyticsRecord(const GameAnalytics& analytics) {
+    std::string filePath = getAnalyticsFilePath();
+    std::error_code error;
+    bool needsHeader = !std::filesystem::exists(filePath, error) || std::filesystem::file_size(filePath, error) == 0;
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::app);
+    if (!file.is_open()) {
+        std::cout << "Failed to open analytics log: " << filePath << std::endl;
+        return false;
+    }
+
+    if (needsHeader) {
+        file.write(ANALYTICS_MAGIC, sizeof(ANALYTICS_MAGIC));
+        writeValue(file, ANALYTICS_VERSION);
+    }
+    writeRecord(file, analytics);
+
+    std::cout << "Analytics recorded: " << analytics.piecesPlaced << " pieces, "
+              << analytics.piecesPerSecond << " PPS, " << analytics.keysPerPiece << " KPP" << std::endl;
+    return static_cast<bool>(file);
+}
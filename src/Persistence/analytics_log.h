@@ -0,0 +1,10 @@
+﻿#pragma once
+
+#include "game_analytics.h"
+#include <string>
+
+
+std::string getAnalyticsFilePath();
+
+
+bool appendAnalyticsRecord(const GameAnalytics& analytics);
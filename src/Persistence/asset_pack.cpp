@@ -0,0 +1,269 @@
+﻿#include "asset_pack.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char* const ASSET_PACK_FILE = "Assets.pak";
+
+namespace {
+
+constexpr char PACK_MAGIC[4] = {'T', 'S', 'P', 'K'};
+
+struct PackFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t indexSize;
+    std::uint8_t reserved[16];
+};
+
+// Index entries follow the header back to back: offset, size, path length,
+// then the path bytes without a terminator.
+struct PackIndexEntry {
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint32_t pathLength;
+};
+
+static_assert(sizeof(PackFileHeader) == 32, "PackFileHeader layout is part of the file format");
+
+constexpr std::size_t INDEX_ENTRY_BYTES = sizeof(std::uint64_t) * 2 + sizeof(std::uint32_t);
+
+std::size_t alignUp(std::size_t value) {
+    return (value + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+}
+
+} // namespace
+
+
+AssetPack::~AssetPack() {
+    close();
+}
+
+bool AssetPack::open(const std::string& packPath) {
+    close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(packPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        return false;
+    }
+    LARGE_INTEGER length;
+    std::size_t size = GetFileSizeEx(fileHandle, &length) ? static_cast<std::size_t>(length.QuadPart) : 0;
+    if (size < sizeof(PackFileHeader)) {
+        close();
+        return false;
+    }
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle) {
+        mapped = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    fileDescriptor = ::open(packPath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+    struct stat info;
+    std::size_t size = fstat(fileDescriptor, &info) == 0 ? static_cast<std::size_t>(info.st_size) : 0;
+    if (size < sizeof(PackFileHeader)) {
+        close();
+        return false;
+    }
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    if (view != MAP_FAILED) {
+        mapped = static_cast<const char*>(view);
+    }
+#endif
+    if (!mapped) {
+        std::cout << "Failed to map asset pack: " << packPath << std::endl;
+        close();
+        return false;
+    }
+    mappedSize = size;
+
+    if (!readIndex()) {
+        std::cout << "Asset pack has an unknown or damaged layout, using loose files: " << packPath << std::endl;
+        close();
+        return false;
+    }
+    std::cout << "Asset pack opened: " << entries.size() << " files" << std::endl;
+    return true;
+}
+
+bool AssetPack::readIndex() {
+    PackFileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    if (std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header.version != ASSET_PACK_VERSION) {
+        return false;
+    }
+    if (header.indexSize > mappedSize - sizeof(PackFileHeader)) {
+        return false;
+    }
+
+    const char* cursor = mapped + sizeof(PackFileHeader);
+    const char* indexEnd = cursor + header.indexSize;
+    entries.reserve(header.entryCount);
+    for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+        if (static_cast<std::size_t>(indexEnd - cursor) < INDEX_ENTRY_BYTES) {
+            return false;
+        }
+        PackIndexEntry entry;
+        std::memcpy(&entry.offset, cursor, sizeof(entry.offset));
+        std::memcpy(&entry.size, cursor + 8, sizeof(entry.size));
+        std::memcpy(&entry.pathLength, cursor + 16, sizeof(entry.pathLength));
+        cursor += INDEX_ENTRY_BYTES;
+        if (static_cast<std::size_t>(indexEnd - cursor) < entry.pathLength
+            || entry.offset > mappedSize || entry.size > mappedSize - entry.offset) {
+            return false;
+        }
+        std::string path(cursor, entry.pathLength);
+        cursor += entry.pathLength;
+        entries[path] = {mapped + entry.offset, static_cast<std::size_t>(entry.size)};
+    }
+    return true;
+}
+
+void AssetPack::close() {
+    entries.clear();
+#ifdef _WIN32
+    if (mapped) {
+        UnmapViewOfFile(mapped);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+#else
+    if (mapped) {
+        munmap(const_cast<char*>(mapped), mappedSize);
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+}
+
+AssetBlob AssetPack::find(const std::string& assetPath) const {
+    auto it = entries.find(assetPath);
+    return it != entries.end() ? it->second : AssetBlob{};
+}
+
+
+AssetPack& getAssetPack() {
+    static AssetPack pack;
+    return pack;
+}
+
+bool assetExists(const std::string& assetPath) {
+    if (getAssetPack().find(assetPath)) {
+        return true;
+    }
+    std::error_code error;
+    return std::filesystem::exists(assetPath, error);
+}
+
+
+bool writeAssetPack(const std::string& assetDirectory, const std::string& packPath) {
+    std::filesystem::path root(assetDirectory);
+    std::error_code error;
+    if (!std::filesystem::is_directory(root, error)) {
+        std::cout << "Not a directory: " << assetDirectory << std::endl;
+        return false;
+    }
+
+    struct PackedFile {
+        std::filesystem::path source;
+        std::string key;
+        std::uint64_t size = 0;
+        std::uint64_t offset = 0;
+    };
+    std::vector<PackedFile> files;
+    std::filesystem::path keyBase = std::filesystem::absolute(root).lexically_normal().parent_path();
+    for (const auto& item : std::filesystem::recursive_directory_iterator(root, error)) {
+        if (!item.is_regular_file()) continue;
+        PackedFile file;
+        file.source = item.path();
+        file.key = std::filesystem::absolute(item.path()).lexically_normal().lexically_relative(keyBase).generic_string();
+        file.size = static_cast<std::uint64_t>(item.file_size());
+        files.push_back(file);
+    }
+    if (error) {
+        std::cout << "Failed to list " << assetDirectory << ": " << error.message() << std::endl;
+        return false;
+    }
+    std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) { return a.key < b.key; });
+
+    std::size_t indexSize = 0;
+    for (const PackedFile& file : files) {
+        indexSize += INDEX_ENTRY_BYTES + file.key.size();
+    }
+    std::size_t offset = alignUp(sizeof(PackFileHeader) + indexSize);
+    for (PackedFile& file : files) {
+        file.offset = offset;
+        offset = alignUp(offset + static_cast<std::size_t>(file.size));
+    }
+
+    std::ofstream out(packPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cout << "Failed to create " << packPath << std::endl;
+        return false;
+    }
+
+    PackFileHeader header = {};
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = static_cast<std::uint32_t>(files.size());
+    header.indexSize = static_cast<std::uint32_t>(indexSize);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const PackedFile& file : files) {
+        std::uint32_t pathLength = static_cast<std::uint32_t>(file.key.size());
+        out.write(reinterpret_cast<const char*>(&file.offset), sizeof(file.offset));
+        out.write(reinterpret_cast<const char*>(&file.size), sizeof(file.size));
+        out.write(reinterpret_cast<const char*>(&pathLength), sizeof(pathLength));
+        out.write(file.key.data(), file.key.size());
+    }
+
+    std::vector<char> buffer;
+    for (const PackedFile& file : files) {
+        std::size_t padding = static_cast<std::size_t>(file.offset) - static_cast<std::size_t>(out.tellp());
+        out.write(std::string(padding, '\0').data(), padding);
+
+        std::ifstream in(file.source, std::ios::binary);
+        buffer.resize(static_cast<std::size_t>(file.size));
+        if (!in || !in.read(buffer.data(), buffer.size())) {
+            std::cout << "Failed to read " << file.source.string() << std::endl;
+            return false;
+        }
+        out.write(buffer.data(), buffer.size());
+    }
+
+    std::streamoff packSize = out.tellp();
+    if (!out.flush()) {
+        std::cout << "Failed to write " << packPath << std::endl;
+        return false;
+    }
+    std::cout << "Packed " << files.size() << " files into " << packPath << " (" << packSize << " bytes)" << std::endl;
+    return true;
+}
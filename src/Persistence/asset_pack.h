@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+
+constexpr std::uint32_t ASSET_PACK_VERSION = 1;
+constexpr std::size_t ASSET_PACK_ALIGNMENT = 64;
+extern const char* const ASSET_PACK_FILE;
+
+
+struct AssetBlob {
+    const void* data = nullptr;
+    std::size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+
+// Read-only archive of the Assets/ tree built by Tools/asset_packer: a
+// header, an index of relative paths, then every file's bytes at an aligned
+// offset. The whole archive is memory-mapped once, so loading an asset is
+// a hash lookup and a pointer handed to SFML's loadFromMemory/openFromMemory
+// instead of an open and a series of reads. Blobs stay valid until close().
+class AssetPack {
+private:
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+    const char* mapped = nullptr;
+    std::size_t mappedSize = 0;
+    std::unordered_map<std::string, AssetBlob> entries;
+
+    bool readIndex();
+
+public:
+    AssetPack() = default;
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& packPath);
+    void close();
+    bool isOpen() const { return mapped != nullptr; }
+
+    AssetBlob find(const std::string& assetPath) const;
+    std::size_t getEntryCount() const { return entries.size(); }
+};
+
+
+// The archive the game reads from. It is opened once at startup, before any
+// loader thread starts, and only read afterwards. When it is missing, or a
+// path is not in it, callers fall back to the loose file on disk.
+AssetPack& getAssetPack();
+bool assetExists(const std::string& assetPath);
+
+// Packs every file under assetDirectory, keyed by its path relative to the
+// directory's parent ("Assets/Sound/SFX/laser.ogg").
+bool writeAssetPack(const std::string& assetDirectory, const std::string& packPath);
@@ -0,0 +1,443 @@
+﻿#include "game_history.h"
+#include "save_system.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+struct HistoryModeSlot {
+    std::uint32_t used;
+    std::uint32_t key;
+    std::uint32_t gameCount;
+    std::uint32_t completedCount;
+    std::uint32_t topScoreCount;
+    std::uint32_t bestTimeCount;
+    std::int64_t totalScore;
+    std::int64_t totalLines;
+    double totalSeconds;
+    std::uint32_t topScores[HISTORY_TOP_KEPT];
+    std::uint32_t bestTimes[HISTORY_TOP_KEPT];
+    std::uint32_t recent[HISTORY_RECENT_KEPT];
+};
+
+static_assert(sizeof(HistoryModeSlot) == 384, "HistoryModeSlot layout is part of the file format");
+
+namespace {
+
+constexpr char HISTORY_MAGIC[4] = {'T', 'S', 'H', 'G'};
+
+// indexedCount trails recordCount only if a crash lands between the two
+// writes in append; open indexes that short tail and nothing else.
+struct HistoryFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint32_t recordCount;
+    std::uint32_t indexedCount;
+    std::uint32_t indexSlots;
+    std::uint8_t reserved[40];
+};
+
+static_assert(sizeof(HistoryFileHeader) == 64, "HistoryFileHeader layout is part of the file format");
+
+constexpr std::size_t HISTORY_RECORDS_OFFSET = sizeof(HistoryFileHeader) + HISTORY_INDEX_SLOTS * sizeof(HistoryModeSlot);
+
+std::uint32_t makeIndexKey(GameModeOption mode, int config) {
+    return (static_cast<std::uint32_t>(mode) << 16) | (static_cast<std::uint32_t>(config) & 0xFFFFu);
+}
+
+std::uint32_t makeIndexKey(const GameHistoryRecord& record) {
+    return makeIndexKey(static_cast<GameModeOption>(record.mode), record.config);
+}
+
+std::size_t fileSizeFor(std::uint32_t capacity) {
+    return HISTORY_RECORDS_OFFSET + static_cast<std::size_t>(capacity) * sizeof(GameHistoryRecord);
+}
+
+bool scoreBetter(const GameHistoryRecord& a, const GameHistoryRecord& b) {
+    return a.score > b.score;
+}
+
+bool timeBetter(const GameHistoryRecord& a, const GameHistoryRecord& b) {
+    return a.timeSeconds < b.timeSeconds;
+}
+
+bool hasBestTime(const GameHistoryRecord& record) {
+    return record.completed && record.timeSeconds > 0.0f;
+}
+
+}
+
+std::string getHistoryFilePath() {
+    return getHistoryFilePath(getSaveFilePath());
+}
+
+std::string getHistoryFilePath(const std::string& saveFilePath) {
+    return (std::filesystem::path(saveFilePath).parent_path() / "history.bin").string();
+}
+
+GameHistory::~GameHistory() {
+    close();
+}
+
+bool GameHistory::mapFile(std::size_t size) {
+#ifdef _WIN32
+    LARGE_INTEGER length;
+    length.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(fileHandle, length, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle)) return false;
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    if (!mappingHandle) return false;
+    mapped = static_cast<char*>(MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    if (!mapped) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+        return false;
+    }
+#else
+    if (ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0) return false;
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (view == MAP_FAILED) return false;
+    mapped = static_cast<char*>(view);
+#endif
+    mappedSize = size;
+    capacity = static_cast<std::uint32_t>((size - HISTORY_RECORDS_OFFSET) / sizeof(GameHistoryRecord));
+    return true;
+}
+
+void GameHistory::unmapFile() {
+    if (!mapped) return;
+#ifdef _WIN32
+    FlushViewOfFile(mapped, 0);
+    UnmapViewOfFile(mapped);
+    CloseHandle(mappingHandle);
+    mappingHandle = nullptr;
+#else
+    msync(mapped, mappedSize, MS_ASYNC);
+    munmap(mapped, mappedSize);
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+}
+
+void GameHistory::flushView() {
+#ifdef _WIN32
+    FlushViewOfFile(mapped, 0);
+#else
+    msync(mapped, mappedSize, MS_ASYNC);
+#endif
+}
+
+bool GameHistory::open(const std::string& filePath) {
+    close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        std::cout << "Failed to open game history: " << filePath << std::endl;
+        return false;
+    }
+    LARGE_INTEGER existing;
+    std::size_t existingSize = GetFileSizeEx(fileHandle, &existing) ? static_cast<std::size_t>(existing.QuadPart) : 0;
+#else
+    fileDescriptor = ::open(filePath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fileDescriptor < 0) {
+        std::cout << "Failed to open game history: " << filePath << std::endl;
+        return false;
+    }
+    struct stat info;
+    std::size_t existingSize = fstat(fileDescriptor, &info) == 0 ? static_cast<std::size_t>(info.st_size) : 0;
+#endif
+
+    bool fresh = existingSize < sizeof(HistoryFileHeader);
+    bool tooSmall = !fresh && existingSize < HISTORY_RECORDS_OFFSET;
+    std::size_t size = fresh || tooSmall ? fileSizeFor(HISTORY_GROWTH_RECORDS) : existingSize;
+    if (!mapFile(size)) {
+        std::cout << "Failed to map game history: " << filePath << std::endl;
+        close();
+        return false;
+    }
+
+    HistoryFileHeader* header = reinterpret_cast<HistoryFileHeader*>(mapped);
+    bool valid = !fresh && !tooSmall
+        && std::memcmp(header->magic, HISTORY_MAGIC, sizeof(HISTORY_MAGIC)) == 0
+        && header->version == HISTORY_VERSION
+        && header->recordSize == sizeof(GameHistoryRecord)
+        && header->indexSlots == HISTORY_INDEX_SLOTS;
+    if (!valid) {
+        if (!fresh) {
+            std::cout << "Game history has an unknown layout, starting a new one" << std::endl;
+            close();
+            std::error_code error;
+            std::filesystem::rename(filePath, filePath + ".old", error);
+            if (error) {
+                std::cout << "Failed to move old game history aside: " << error.message() << std::endl;
+                return false;
+            }
+            // The path is free now, so the reopen takes the fresh branch.
+            return open(filePath);
+        }
+        std::memset(mapped, 0, HISTORY_RECORDS_OFFSET);
+        std::memcpy(header->magic, HISTORY_MAGIC, sizeof(HISTORY_MAGIC));
+        header->version = HISTORY_VERSION;
+        header->recordSize = sizeof(GameHistoryRecord);
+        header->indexSlots = HISTORY_INDEX_SLOTS;
+    }
+    header->recordCount = std::min(header->recordCount, capacity);
+    header->indexedCount = std::min(header->indexedCount, header->recordCount);
+
+    while (header->indexedCount < header->recordCount) {
+        indexRecord(header->indexedCount);
+    }
+    std::cout << "Game history opened: " << header->recordCount << " games" << std::endl;
+    return true;
+}
+
+void GameHistory::close() {
+    unmapFile();
+#ifdef _WIN32
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+#else
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+    capacity = 0;
+}
+
+// Lets a history opened on a worker thread take over from the one in use.
+void GameHistory::swap(GameHistory& other) {
+#ifdef _WIN32
+    std::swap(fileHandle, other.fileHandle);
+    std::swap(mappingHandle, other.mappingHandle);
+#else
+    std::swap(fileDescriptor, other.fileDescriptor);
+#endif
+    std::swap(mapped, other.mapped);
+    std::swap(mappedSize, other.mappedSize);
+    std::swap(capacity, other.capacity);
+}
+
+// The record is copied in before the header count moves past it, so a crash
+// mid-append can only lose the game being written, never corrupt older ones.
+bool GameHistory::append(const GameHistoryRecord& record) {
+    if (!mapped) return false;
+
+    std::uint32_t count = getRecordCount();
+    if (count >= capacity) {
+        std::size_t grownSize = fileSizeFor(capacity + HISTORY_GROWTH_RECORDS);
+        unmapFile();
+        if (!mapFile(grownSize)) {
+            std::cout << "Failed to grow game history" << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    char* slot = mapped + fileSizeFor(count);
+    std::memcpy(slot, &record, sizeof(GameHistoryRecord));
+    reinterpret_cast<HistoryFileHeader*>(mapped)->recordCount = count + 1;
+    indexRecord(count);
+    flushView();
+    return true;
+}
+
+// Shrinks the file back to its initial size and drops every record and the
+// index, keeping the header so the file stays valid for the next append.
+bool GameHistory::clear() {
+    if (!mapped) return false;
+
+    unmapFile();
+    if (!mapFile(fileSizeFor(HISTORY_GROWTH_RECORDS))) {
+        std::cout << "Failed to clear game history" << std::endl;
+        close();
+        return false;
+    }
+    std::memset(mapped + sizeof(HistoryFileHeader), 0, mappedSize - sizeof(HistoryFileHeader));
+    HistoryFileHeader* header = reinterpret_cast<HistoryFileHeader*>(mapped);
+    header->recordCount = 0;
+    header->indexedCount = 0;
+    flushView();
+    return true;
+}
+
+std::uint32_t GameHistory::getRecordCount() const {
+    return mapped ? reinterpret_cast<const HistoryFileHeader*>(mapped)->recordCount : 0;
+}
+
+const GameHistoryRecord& GameHistory::getRecord(std::uint32_t index) const {
+    return *reinterpret_cast<const GameHistoryRecord*>(mapped + fileSizeFor(index));
+}
+
+HistoryModeSlot* GameHistory::getSlots() const {
+    return reinterpret_cast<HistoryModeSlot*>(mapped + sizeof(HistoryFileHeader));
+}
+
+void GameHistory::indexRecord(std::uint32_t recordIndex) {
+    HistoryFileHeader* header = reinterpret_cast<HistoryFileHeader*>(mapped);
+    header->indexedCount = recordIndex + 1;
+
+    const GameHistoryRecord& record = getRecord(recordIndex);
+    std::uint32_t key = makeIndexKey(record);
+    HistoryModeSlot* slots = getSlots();
+    HistoryModeSlot* slot = nullptr;
+    for (int i = 0; i < HISTORY_INDEX_SLOTS && !slot; ++i) {
+        if (!slots[i].used) {
+            slot = &slots[i];
+            slot->used = 1;
+            slot->key = key;
+        } else if (slots[i].key == key) {
+            slot = &slots[i];
+        }
+    }
+    if (!slot) {
+        std::cout << "Game history index is full, game " << recordIndex << " is not indexed" << std::endl;
+        return;
+    }
+
+    slot->recent[slot->gameCount % HISTORY_RECENT_KEPT] = recordIndex;
+    slot->gameCount++;
+    if (record.completed) slot->completedCount++;
+    slot->totalScore += record.score;
+    slot->totalLines += record.lines;
+    slot->totalSeconds += record.timeSeconds;
+
+    auto insertRanked = [&](std::uint32_t* ranked, std::uint32_t& rankedCount, bool (*better)(const GameHistoryRecord&, const GameHistoryRecord&)) {
+        std::uint32_t position = 0;
+        while (position < rankedCount && !better(record, getRecord(ranked[position]))) ++position;
+        if (position >= static_cast<std::uint32_t>(HISTORY_TOP_KEPT)) return;
+        rankedCount = std::min<std::uint32_t>(rankedCount + 1, HISTORY_TOP_KEPT);
+        std::memmove(ranked + position + 1, ranked + position, (rankedCount - 1 - position) * sizeof(std::uint32_t));
+        ranked[position] = recordIndex;
+    };
+    insertRanked(slot->topScores, slot->topScoreCount, scoreBetter);
+    if (hasBestTime(record)) insertRanked(slot->bestTimes, slot->bestTimeCount, timeBetter);
+}
+
+const HistoryModeSlot* GameHistory::findSlot(GameModeOption mode, int config) const {
+    if (!mapped) return nullptr;
+    std::uint32_t key = makeIndexKey(mode, config);
+    const HistoryModeSlot* slots = getSlots();
+    for (int i = 0; i < HISTORY_INDEX_SLOTS && slots[i].used; ++i) {
+        if (slots[i].key == key) return &slots[i];
+    }
+    return nullptr;
+}
+
+// Only requests deeper than the kept ranks or recent games come here.
+void GameHistory::scanRecords(GameModeOption mode, int config, std::vector<const GameHistoryRecord*>& out) const {
+    std::uint32_t key = makeIndexKey(mode, config);
+    for (std::uint32_t i = 0; i < getRecordCount(); ++i) {
+        const GameHistoryRecord& record = getRecord(i);
+        if (makeIndexKey(record) == key) out.push_back(&record);
+    }
+}
+
+int GameHistory::countGames(GameModeOption mode, int config) const {
+    const HistoryModeSlot* slot = findSlot(mode, config);
+    return slot ? static_cast<int>(slot->gameCount) : 0;
+}
+
+HistoryModeTotals GameHistory::getModeTotals(GameModeOption mode, int config) const {
+    HistoryModeTotals totals;
+    const HistoryModeSlot* slot = findSlot(mode, config);
+    if (!slot) return totals;
+    totals.games = static_cast<int>(slot->gameCount);
+    totals.completed = static_cast<int>(slot->completedCount);
+    totals.totalScore = slot->totalScore;
+    totals.totalLines = slot->totalLines;
+    totals.totalSeconds = slot->totalSeconds;
+    return totals;
+}
+
+void GameHistory::queryTopScores(GameModeOption mode, int config, int count, std::vector<const GameHistoryRecord*>& out) const {
+    out.clear();
+    const HistoryModeSlot* slot = findSlot(mode, config);
+    if (!slot || count <= 0) return;
+
+    if (count <= HISTORY_TOP_KEPT) {
+        for (std::uint32_t i = 0; i < slot->topScoreCount && static_cast<int>(out.size()) < count; ++i) {
+            out.push_back(&getRecord(slot->topScores[i]));
+        }
+        return;
+    }
+
+    scanRecords(mode, config, out);
+    std::size_t kept = std::min(out.size(), static_cast<std::size_t>(count));
+    std::partial_sort(out.begin(), out.begin() + kept, out.end(), [](const GameHistoryRecord* a, const GameHistoryRecord* b) {
+        return scoreBetter(*a, *b);
+    });
+    out.resize(kept);
+}
+
+void GameHistory::queryBestTimes(GameModeOption mode, int config, int count, std::vector<const GameHistoryRecord*>& out) const {
+    out.clear();
+    const HistoryModeSlot* slot = findSlot(mode, config);
+    if (!slot || count <= 0) return;
+
+    if (count <= HISTORY_TOP_KEPT) {
+        for (std::uint32_t i = 0; i < slot->bestTimeCount && static_cast<int>(out.size()) < count; ++i) {
+            out.push_back(&getRecord(slot->bestTimes[i]));
+        }
+        return;
+    }
+
+    scanRecords(mode, config, out);
+    out.erase(std::remove_if(out.begin(), out.end(), [](const GameHistoryRecord* record) {
+        return !hasBestTime(*record);
+    }), out.end());
+    std::size_t kept = std::min(out.size(), static_cast<std::size_t>(count));
+    std::partial_sort(out.begin(), out.begin() + kept, out.end(), [](const GameHistoryRecord* a, const GameHistoryRecord* b) {
+        return timeBetter(*a, *b);
+    });
+    out.resize(kept);
+}
+
+// Newest first.
+void GameHistory::queryRecent(GameModeOption mode, int config, int count, std::vector<const GameHistoryRecord*>& out) const {
+    out.clear();
+    const HistoryModeSlot* slot = findSlot(mode, config);
+    if (!slot || count <= 0) return;
+
+    if (count <= HISTORY_RECENT_KEPT) {
+        std::uint32_t available = std::min<std::uint32_t>(slot->gameCount, HISTORY_RECENT_KEPT);
+        for (std::uint32_t i = 0; i < available && static_cast<int>(out.size()) < count; ++i) {
+            out.push_back(&getRecord(slot->recent[(slot->gameCount - 1 - i) % HISTORY_RECENT_KEPT]));
+        }
+        return;
+    }
+
+    scanRecords(mode, config, out);
+    std::reverse(out.begin(), out.end());
+    if (static_cast<int>(out.size()) > count) out.resize(count);
+}
+
+float GameHistory::getAverageScore(GameModeOption mode, int config, int skipNewest, int count) const {
+    if (count <= 0) return 0.0f;
+    std::vector<const GameHistoryRecord*> newest;
+    queryRecent(mode, config, skipNewest + count, newest);
+    if (static_cast<int>(newest.size()) <= skipNewest) return 0.0f;
+
+    long long total = 0;
+    for (std::size_t i = skipNewest; i < newest.size(); ++i) {
+        total += newest[i]->score;
+    }
+    return static_cast<float>(total) / static_cast<float>(newest.size() - skipNewest);
+}
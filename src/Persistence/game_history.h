@@ -0,0 +1,102 @@
+﻿#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+constexpr std::uint32_t HISTORY_VERSION = 1;
+constexpr std::uint32_t HISTORY_GROWTH_RECORDS = 1024;
+constexpr int HISTORY_TOP_KEPT = 10;
+constexpr int HISTORY_RECENT_KEPT = 64;
+constexpr int HISTORY_INDEX_SLOTS = 64;
+
+
+#pragma pack(push, 1)
+struct GameHistoryRecord {
+    std::int64_t timestamp = 0;
+    std::uint32_t seed = 0;
+    std::int32_t score = 0;
+    std::int32_t lines = 0;
+    std::int32_t level = 0;
+    float timeSeconds = 0.0f;
+    std::uint8_t mode = 0;
+    std::uint8_t completed = 0;
+    std::uint16_t config = 0;
+    std::uint16_t boardRows[GRID_HEIGHT] = {};
+    std::uint8_t reserved[4] = {};
+};
+#pragma pack(pop)
+
+static_assert(sizeof(GameHistoryRecord) == 80, "GameHistoryRecord layout is part of the file format");
+
+
+// Lifetime sums for one (mode, config) pair, kept up to date on append.
+struct HistoryModeTotals {
+    int games = 0;
+    int completed = 0;
+    long long totalScore = 0;
+    long long totalLines = 0;
+    double totalSeconds = 0.0;
+};
+
+
+std::string getHistoryFilePath();
+std::string getHistoryFilePath(const std::string& saveFilePath);
+
+
+struct HistoryModeSlot;
+
+
+// Append-only store of every finished game, memory-mapped so queries only
+// touch the pages they read. The file also carries a fixed table with one
+// slot per (mode, config) pair: game counts, running sums, the best few
+// scores and times, and the newest games. append keeps it current, so
+// opening the file and answering the menu screens never scans the records.
+class GameHistory {
+private:
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+    char* mapped = nullptr;
+    std::size_t mappedSize = 0;
+    std::uint32_t capacity = 0;
+
+    bool mapFile(std::size_t size);
+    void unmapFile();
+    void flushView();
+    void indexRecord(std::uint32_t recordIndex);
+    HistoryModeSlot* getSlots() const;
+    const HistoryModeSlot* findSlot(GameModeOption mode, int config) const;
+    void scanRecords(GameModeOption mode, int config, std::vector<const GameHistoryRecord*>& out) const;
+
+public:
+    GameHistory() = default;
+    ~GameHistory();
+
+    GameHistory(const GameHistory&) = delete;
+    GameHistory& operator=(const GameHistory&) = delete;
+
+    bool open(const std::string& filePath);
+    void close();
+    void swap(GameHistory& other);
+    bool isOpen() const { return mapped != nullptr; }
+
+    bool append(const GameHistoryRecord& record);
+    bool clear();
+
+    std::uint32_t getRecordCount() const;
+    const GameHistoryRecord& getRecord(std::uint32_t index) const;
+
+    int countGames(GameModeOption mode, int config) const;
+    HistoryModeTotals getModeTotals(GameModeOption mode, int config) const;
+    void queryTopScores(GameModeOption mode, int config, int count, std::vector<const GameHistoryRecord*>& out) const;
+    void queryBestTimes(GameModeOption mode, int config, int count, std::vector<const GameHistoryRecord*>& out) const;
+    void queryRecent(GameModeOption mode, int config, int count, std::vector<const GameHistoryRecord*>& out) const;
+    float getAverageScore(GameModeOption mode, int config, int skipNewest, int count) const;
+};
@@ -0,0 +1,470 @@
+﻿#include "game_snapshot.h"
+#include "save_system.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+constexpr char GAME_SNAPSHOT_MAGIC[4] = {'T', 'S', 'G', 'S'};
+
+#pragma pack(push, 1)
+struct GameSnapshotHeader {
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t reserved;
+    std::uint32_t bodySize;
+    std::uint32_t checksum;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(GameSnapshotHeader) == 16, "GameSnapshotHeader layout is part of the file format");
+
+
+// Empty cells are a single flag byte; only cells that differ from Cell()
+// carry their colour, texture and challenge timers.
+constexpr std::uint8_t CELL_OCCUPIED = 1u << 0;
+constexpr std::uint8_t CELL_VANISHING = 1u << 1;
+constexpr std::uint8_t CELL_PETRIFIED = 1u << 2;
+constexpr std::uint8_t CELL_HAS_PAYLOAD = 1u << 7;
+
+
+std::uint32_t floatBits(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+
+class SnapshotWriter {
+public:
+    std::string bytes;
+
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_arithmetic<T>::value, "snapshot fields are plain numbers");
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename E>
+    void putEnum(E value) {
+        put(static_cast<std::uint8_t>(value));
+    }
+
+    void putBool(bool value) {
+        put(static_cast<std::uint8_t>(value ? 1 : 0));
+    }
+
+    void putColor(const sf::Color& color) {
+        put(color.r);
+        put(color.g);
+        put(color.b);
+        put(color.a);
+    }
+
+    void putPieces(const std::vector<PieceType>& pieces) {
+        put(static_cast<std::uint16_t>(pieces.size()));
+        for (PieceType piece : pieces) {
+            putEnum(piece);
+        }
+    }
+};
+
+
+class SnapshotReader {
+private:
+    const std::string& bytes;
+    std::size_t offset;
+
+public:
+    bool ok = true;
+
+    SnapshotReader(const std::string& source, std::size_t start) : bytes(source), offset(start) {}
+
+    bool atEnd() const { return offset == bytes.size(); }
+
+    template <typename T>
+    void get(T& value) {
+        static_assert(std::is_arithmetic<T>::value, "snapshot fields are plain numbers");
+        if (!ok || bytes.size() - offset < sizeof(T)) {
+            ok = false;
+            return;
+        }
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        offset += sizeof(T);
+    }
+
+    template <typename E>
+    void getEnum(E& value) {
+        std::uint8_t raw = 0;
+        get(raw);
+        value = static_cast<E>(raw);
+    }
+
+    void getBool(bool& value) {
+        std::uint8_t raw = 0;
+        get(raw);
+        value = raw != 0;
+    }
+
+    void getColor(sf::Color& color) {
+        get(color.r);
+        get(color.g);
+        get(color.b);
+        get(color.a);
+    }
+
+    void getPieces(std::vector<PieceType>& pieces) {
+        std::uint16_t count = 0;
+        get(count);
+        pieces.assign(ok ? count : 0, PieceType::I_Basic);
+        for (PieceType& piece : pieces) {
+            getEnum(piece);
+        }
+    }
+};
+
+
+void writeCell(SnapshotWriter& out, const Cell& cell) {
+    const Cell empty;
+    bool hasPayload = cell.color != empty.color || cell.textureType != empty.textureType ||
+                      floatBits(cell.vanishTimer) != floatBits(empty.vanishTimer) ||
+                      cell.petrifyCounter != empty.petrifyCounter;
+
+    std::uint8_t flags = 0;
+    if (cell.occupied) flags |= CELL_OCCUPIED;
+    if (cell.isVanishing) flags |= CELL_VANISHING;
+    if (cell.isPetrified) flags |= CELL_PETRIFIED;
+    if (hasPayload) flags |= CELL_HAS_PAYLOAD;
+    out.put(flags);
+
+    if (hasPayload) {
+        out.putColor(cell.color);
+        out.putEnum(cell.textureType);
+        out.put(cell.vanishTimer);
+        out.put(static_cast<std::int32_t>(cell.petrifyCounter));
+    }
+}
+
+void readCell(SnapshotReader& in, Cell& cell) {
+    std::uint8_t flags = 0;
+    in.get(flags);
+    cell = Cell();
+    cell.occupied = (flags & CELL_OCCUPIED) != 0;
+    cell.isVanishing = (flags & CELL_VANISHING) != 0;
+    cell.isPetrified = (flags & CELL_PETRIFIED) != 0;
+
+    if (flags & CELL_HAS_PAYLOAD) {
+        std::int32_t petrifyCounter = 0;
+        in.getColor(cell.color);
+        in.getEnum(cell.textureType);
+        in.get(cell.vanishTimer);
+        in.get(petrifyCounter);
+        cell.petrifyCounter = petrifyCounter;
+    }
+}
+
+
+void writeShape(SnapshotWriter& out, const PieceShape& shape) {
+    out.put(static_cast<std::uint8_t>(shape.width));
+    out.put(static_cast<std::uint8_t>(shape.height));
+    out.putColor(shape.color);
+
+    std::uint8_t packed = 0;
+    int bit = 0;
+    for (int i = 0; i < shape.height; ++i) {
+        for (int j = 0; j < shape.width; ++j) {
+            if (shape.blocks[i][j]) packed |= static_cast<std::uint8_t>(1u << bit);
+            if (++bit == 8) {
+                out.put(packed);
+                packed = 0;
+                bit = 0;
+            }
+        }
+    }
+    if (bit > 0) out.put(packed);
+}
+
+void readShape(SnapshotReader& in, PieceShape& shape) {
+    std::uint8_t width = 0;
+    std::uint8_t height = 0;
+    in.get(width);
+    in.get(height);
+    in.getColor(shape.color);
+    shape.width = width;
+    shape.height = height;
+    shape.blocks.assign(height, std::vector<bool>(width, false));
+
+    std::uint8_t packed = 0;
+    int bit = 8;
+    for (int i = 0; i < shape.height; ++i) {
+        for (int j = 0; j < shape.width; ++j) {
+            if (bit == 8) {
+                in.get(packed);
+                bit = 0;
+            }
+            shape.blocks[i][j] = (packed >> bit++) & 1u;
+        }
+    }
+}
+
+
+void writeBag(SnapshotWriter& out, const PieceBagState& bag) {
+    out.putPieces(bag.currentBag);
+    out.putPieces(bag.nextBag);
+    out.putPieces(bag.nextQueue);
+    out.putPieces(bag.mediumBag);
+    out.putPieces(bag.hardBag);
+    out.put(static_cast<std::int32_t>(bag.bagIndex));
+    out.put(static_cast<std::int32_t>(bag.mediumBagIndex));
+    out.put(static_cast<std::int32_t>(bag.hardBagIndex));
+    out.put(static_cast<std::int32_t>(bag.currentLevel));
+    out.putBool(bag.nextBagReady);
+    out.put(bag.seed);
+    out.put(bag.shuffleCount);
+}
+
+void readBag(SnapshotReader& in, PieceBagState& bag) {
+    std::int32_t bagIndex = 0, mediumBagIndex = 0, hardBagIndex = 0, currentLevel = 0;
+    in.getPieces(bag.currentBag);
+    in.getPieces(bag.nextBag);
+    in.getPieces(bag.nextQueue);
+    in.getPieces(bag.mediumBag);
+    in.getPieces(bag.hardBag);
+    in.get(bagIndex);
+    in.get(mediumBagIndex);
+    in.get(hardBagIndex);
+    in.get(currentLevel);
+    in.getBool(bag.nextBagReady);
+    in.get(bag.seed);
+    in.get(bag.shuffleCount);
+    bag.bagIndex = bagIndex;
+    bag.mediumBagIndex = mediumBagIndex;
+    bag.hardBagIndex = hardBagIndex;
+    bag.currentLevel = currentLevel;
+}
+
+
+void writePiece(SnapshotWriter& out, const ActivePieceState& piece) {
+    out.putEnum(piece.type);
+    out.putEnum(piece.ability);
+    writeShape(out, piece.shape);
+    out.put(static_cast<std::int32_t>(piece.x));
+    out.put(static_cast<std::int32_t>(piece.y));
+    out.putBool(piece.isStatic);
+    out.put(piece.fallTimer);
+    out.putBool(piece.touchingGround);
+    out.put(piece.lockDelayTimer);
+    out.put(static_cast<std::int32_t>(piece.lockResetCount));
+    out.put(static_cast<std::int32_t>(piece.lowestY));
+    out.put(static_cast<std::int32_t>(piece.highestY));
+}
+
+void readPiece(SnapshotReader& in, ActivePieceState& piece) {
+    std::int32_t x = 0, y = 0, lockResetCount = 0, lowestY = 0, highestY = 0;
+    in.getEnum(piece.type);
+    in.getEnum(piece.ability);
+    readShape(in, piece.shape);
+    in.get(x);
+    in.get(y);
+    in.getBool(piece.isStatic);
+    in.get(piece.fallTimer);
+    in.getBool(piece.touchingGround);
+    in.get(piece.lockDelayTimer);
+    in.get(lockResetCount);
+    in.get(lowestY);
+    in.get(highestY);
+    piece.x = x;
+    piece.y = y;
+    piece.lockResetCount = lockResetCount;
+    piece.lowestY = lowestY;
+    piece.highestY = highestY;
+}
+
+
+bool isBagConsistent(const PieceBagState& bag) {
+    return bag.bagIndex >= 0 && bag.bagIndex <= static_cast<int>(bag.currentBag.size()) &&
+           bag.mediumBagIndex >= 0 && bag.mediumBagIndex <= static_cast<int>(bag.mediumBag.size()) &&
+           bag.hardBagIndex >= 0 && bag.hardBagIndex <= static_cast<int>(bag.hardBag.size());
+}
+
+}
+
+
+std::string getGameSnapshotFilePath() {
+    return (std::filesystem::path(getSaveFilePath()).parent_path() / "suspended_game.bin").string();
+}
+
+
+std::string encodeGameSnapshot(const GameSnapshot& snapshot) {
+    SnapshotWriter out;
+    out.putEnum(snapshot.mode);
+    out.putEnum(snapshot.classicDifficulty);
+    out.putEnum(snapshot.sprintLines);
+    out.putEnum(snapshot.challengeMode);
+    out.putEnum(snapshot.practiceDifficulty);
+    out.putEnum(snapshot.practiceLineGoal);
+    out.putBool(snapshot.practiceInfiniteBombs);
+    out.putEnum(snapshot.themeChoice);
+    out.putBool(snapshot.sprintModeActive);
+    out.putBool(snapshot.challengeModeActive);
+    out.putBool(snapshot.practiceModeActive);
+
+    for (const auto& row : snapshot.grid) {
+        for (const Cell& cell : row) {
+            writeCell(out, cell);
+        }
+    }
+    writeBag(out, snapshot.bag);
+    writePiece(out, snapshot.piece);
+    out.putEnum(snapshot.heldPiece);
+    out.putBool(snapshot.hasHeldPiece);
+    out.putBool(snapshot.canUseHold);
+    out.put(static_cast<std::int32_t>(snapshot.currentPieceRotations));
+
+    out.put(static_cast<std::int32_t>(snapshot.totalLinesCleared));
+    out.put(static_cast<std::int32_t>(snapshot.currentLevel));
+    out.put(static_cast<std::int32_t>(snapshot.totalScore));
+    out.put(static_cast<std::int32_t>(snapshot.currentCombo));
+    out.put(static_cast<std::int32_t>(snapshot.maxComboThisGame));
+    out.put(static_cast<std::int32_t>(snapshot.lastMoveScore));
+    out.put(static_cast<std::int32_t>(snapshot.totalHardDropScore));
+    out.put(static_cast<std::int32_t>(snapshot.totalLineScore));
+    out.put(static_cast<std::int32_t>(snapshot.totalComboScore));
+    out.putBool(snapshot.bombUsedThisGame);
+    out.put(static_cast<std::int32_t>(snapshot.consecutiveBombsUsed));
+
+    out.put(static_cast<std::int32_t>(snapshot.linesSinceLastAbility));
+    out.putBool(snapshot.bombAbilityAvailable);
+    out.putBool(snapshot.deliveryAbilityAvailable);
+    out.putBool(snapshot.stompAbilityAvailable);
+    out.put(static_cast<std::int32_t>(snapshot.lastCreamBlockX));
+
+    out.put(snapshot.sprintTimer);
+    out.put(static_cast<std::int32_t>(snapshot.sprintTargetLines));
+    out.put(snapshot.autoDropTimer);
+    out.putBool(snapshot.gravityFlipped);
+    out.put(static_cast<std::int32_t>(snapshot.gravityFlipPieceCount));
+
+    out.put(snapshot.sessionPlayTime);
+    out.put(static_cast<std::int32_t>(snapshot.sessionPiecesPlaced));
+
+    GameSnapshotHeader header{};
+    std::memcpy(header.magic, GAME_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = GAME_SNAPSHOT_VERSION;
+    header.bodySize = static_cast<std::uint32_t>(out.bytes.size());
+    header.checksum = computeSaveChecksum(out.bytes.data(), out.bytes.size());
+
+    std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+    contents += out.bytes;
+    return contents;
+}
+
+bool decodeGameSnapshot(const std::string& contents, GameSnapshot& snapshot) {
+    if (contents.size() < sizeof(GameSnapshotHeader)) return false;
+    GameSnapshotHeader header;
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, GAME_SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version != GAME_SNAPSHOT_VERSION) {
+        std::cout << "Suspended game has version " << header.version << ", expected " << GAME_SNAPSHOT_VERSION << std::endl;
+        return false;
+    }
+    if (header.bodySize != contents.size() - sizeof(header)) return false;
+    if (header.checksum != computeSaveChecksum(contents.data() + sizeof(header), header.bodySize)) {
+        std::cout << "Suspended game checksum mismatch" << std::endl;
+        return false;
+    }
+
+    GameSnapshot decoded;
+    std::int32_t value = 0;
+    SnapshotReader in(contents, sizeof(header));
+    in.getEnum(decoded.mode);
+    in.getEnum(decoded.classicDifficulty);
+    in.getEnum(decoded.sprintLines);
+    in.getEnum(decoded.challengeMode);
+    in.getEnum(decoded.practiceDifficulty);
+    in.getEnum(decoded.practiceLineGoal);
+    in.getBool(decoded.practiceInfiniteBombs);
+    in.getEnum(decoded.themeChoice);
+    in.getBool(decoded.sprintModeActive);
+    in.getBool(decoded.challengeModeActive);
+    in.getBool(decoded.practiceModeActive);
+
+    for (auto& row : decoded.grid) {
+        for (Cell& cell : row) {
+            readCell(in, cell);
+        }
+    }
+    readBag(in, decoded.bag);
+    readPiece(in, decoded.piece);
+    in.getEnum(decoded.heldPiece);
+    in.getBool(decoded.hasHeldPiece);
+    in.getBool(decoded.canUseHold);
+    in.get(value); decoded.currentPieceRotations = value;
+
+    in.get(value); decoded.totalLinesCleared = value;
+    in.get(value); decoded.currentLevel = value;
+    in.get(value); decoded.totalScore = value;
+    in.get(value); decoded.currentCombo = value;
+    in.get(value); decoded.maxComboThisGame = value;
+    in.get(value); decoded.lastMoveScore = value;
+    in.get(value); decoded.totalHardDropScore = value;
+    in.get(value); decoded.totalLineScore = value;
+    in.get(value); decoded.totalComboScore = value;
+    in.getBool(decoded.bombUsedThisGame);
+    in.get(value); decoded.consecutiveBombsUsed = value;
+
+    in.get(value); decoded.linesSinceLastAbility = value;
+    in.getBool(decoded.bombAbilityAvailable);
+    in.getBool(decoded.deliveryAbilityAvailable);
+    in.getBool(decoded.stompAbilityAvailable);
+    in.get(value); decoded.lastCreamBlockX = value;
+
+    in.get(decoded.sprintTimer);
+    in.get(value); decoded.sprintTargetLines = value;
+    in.get(decoded.autoDropTimer);
+    in.getBool(decoded.gravityFlipped);
+    in.get(value); decoded.gravityFlipPieceCount = value;
+
+    in.get(decoded.sessionPlayTime);
+    in.get(value); decoded.sessionPiecesPlaced = value;
+
+    if (!in.ok || !in.atEnd() || !isBagConsistent(decoded.bag) || decoded.piece.shape.height == 0) {
+        std::cout << "Suspended game is malformed" << std::endl;
+        return false;
+    }
+    snapshot = std::move(decoded);
+    return true;
+}
+
+
+bool writeGameSnapshot(const GameSnapshot& snapshot) {
+    std::string contents = encodeGameSnapshot(snapshot);
+    if (!replaceFileDurably(getGameSnapshotFilePath(), contents)) {
+        std::cout << "Failed to suspend game" << std::endl;
+        return false;
+    }
+    std::cout << "Game suspended (" << contents.size() << " bytes)" << std::endl;
+    return true;
+}
+
+void queueGameSnapshot(const GameSnapshot& snapshot) {
+    std::string contents = encodeGameSnapshot(snapshot);
+    std::cout << "Game suspended (" << contents.size() << " bytes)" << std::endl;
+    replaceFileInBackground(getGameSnapshotFilePath(), std::move(contents));
+}
+
+bool loadGameSnapshot(GameSnapshot& snapshot) {
+    std::string contents;
+    if (!readWholeFile(getGameSnapshotFilePath(), contents)) return false;
+    return decodeGameSnapshot(contents, snapshot);
+}
+
+// Queued behind any pending suspend write of the same file.
+void deleteGameSnapshot() {
+    removeFileInBackground(getGameSnapshotFilePath());
+}
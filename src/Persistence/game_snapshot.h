@@ -0,0 +1,92 @@
+﻿#pragma once
+
+#include "types.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+
+constexpr std::uint16_t GAME_SNAPSHOT_VERSION = 1;
+
+
+struct ActivePieceState {
+    PieceType type = PieceType::I_Basic;
+    AbilityType ability = AbilityType::None;
+    PieceShape shape;
+    int x = 0;
+    int y = 0;
+    bool isStatic = false;
+    float fallTimer = 0.0f;
+    bool touchingGround = false;
+    float lockDelayTimer = 0.0f;
+    int lockResetCount = 0;
+    int lowestY = 0;
+    int highestY = GRID_HEIGHT;
+};
+
+
+// A suspended game: the mode it was started with plus every piece of live
+// state the game loop reads, so resuming continues exactly where it stopped.
+struct GameSnapshot {
+    GameModeOption mode = GameModeOption::Classic;
+    ClassicDifficulty classicDifficulty = ClassicDifficulty::Normal;
+    SprintLines sprintLines = SprintLines::Lines24;
+    ChallengeMode challengeMode = ChallengeMode::Debug;
+    PracticeDifficulty practiceDifficulty = PracticeDifficulty::Easy;
+    PracticeLineGoal practiceLineGoal = PracticeLineGoal::Infinite;
+    bool practiceInfiniteBombs = false;
+    GameThemeChoice themeChoice = GameThemeChoice::Classic;
+    bool sprintModeActive = false;
+    bool challengeModeActive = false;
+    bool practiceModeActive = false;
+
+    std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT> grid;
+    PieceBagState bag;
+    ActivePieceState piece;
+    PieceType heldPiece = PieceType::I_Basic;
+    bool hasHeldPiece = false;
+    bool canUseHold = true;
+    int currentPieceRotations = 0;
+
+    int totalLinesCleared = 0;
+    int currentLevel = 0;
+    int totalScore = 0;
+    int currentCombo = 0;
+    int maxComboThisGame = 0;
+    int lastMoveScore = 0;
+    int totalHardDropScore = 0;
+    int totalLineScore = 0;
+    int totalComboScore = 0;
+    bool bombUsedThisGame = false;
+    int consecutiveBombsUsed = 0;
+
+    int linesSinceLastAbility = 0;
+    bool bombAbilityAvailable = false;
+    bool deliveryAbilityAvailable = false;
+    bool stompAbilityAvailable = false;
+    int lastCreamBlockX = -1;
+
+    float sprintTimer = 0.0f;
+    int sprintTargetLines = 0;
+    float autoDropTimer = 0.0f;
+    bool gravityFlipped = false;
+    int gravityFlipPieceCount = 0;
+
+    float sessionPlayTime = 0.0f;
+    int sessionPiecesPlaced = 0;
+};
+
+
+std::string getGameSnapshotFilePath();
+
+
+std::string encodeGameSnapshot(const GameSnapshot& snapshot);
+bool decodeGameSnapshot(const std::string& contents, GameSnapshot& snapshot);
+
+
+// writeGameSnapshot blocks until the file is synced; queueGameSnapshot only
+// encodes and leaves the write to the save writer thread.
+bool writeGameSnapshot(const GameSnapshot& snapshot);
+void queueGameSnapshot(const GameSnapshot& snapshot);
+bool loadGameSnapshot(GameSnapshot& snapshot);
+void deleteGameSnapshot();
@@ -0,0 +1,111 @@
+﻿#include "mode_stats.h"
+#include <algorithm>
+
+
+namespace {
+
+constexpr int CLASSIC_SLOT_BASE = 0;
+constexpr int SPRINT_SLOT_BASE = 2;
+constexpr int CHALLENGE_SLOT_BASE = 6;
+constexpr int PRACTICE_SLOT_BASE = 16;
+
+constexpr int SPRINT_LENGTHS[4] = {1, 24, 48, 96};
+
+const char* const MODE_STATS_LABELS[MODE_STATS_SLOTS] = {
+    "Classic Normal", "Classic Hard",
+    "Blitz 1", "Blitz 24", "Blitz 48", "Blitz 96",
+    "Debug", "The Forest", "Randomness", "Non-Straight", "One Rotation",
+    "The Curse", "Vanishing", "Auto Drop", "Gravity Flip", "Petrify",
+    "Practice Very Easy", "Practice Easy", "Practice Medium", "Practice Hard"
+};
+
+float blendRecent(float average, float sample, int gamesPlayed) {
+    if (gamesPlayed <= 1) return sample;
+    return average + (sample - average) * MODE_STATS_RECENT_WEIGHT;
+}
+
+}
+
+
+int getModeStatsSlot(GameModeOption mode, int subMode) {
+    switch (mode) {
+        case GameModeOption::Classic:
+            return (subMode >= 0 && subMode < 2) ? CLASSIC_SLOT_BASE + subMode : -1;
+        case GameModeOption::Sprint:
+            for (int i = 0; i < 4; ++i) {
+                if (SPRINT_LENGTHS[i] == subMode) return SPRINT_SLOT_BASE + i;
+            }
+            return -1;
+        case GameModeOption::Challenge:
+            return (subMode >= 0 && subMode < 10) ? CHALLENGE_SLOT_BASE + subMode : -1;
+        case GameModeOption::Practice:
+            return (subMode >= 0 && subMode < 4) ? PRACTICE_SLOT_BASE + subMode : -1;
+    }
+    return -1;
+}
+
+bool getModeStatsKey(int slot, GameModeOption& mode, int& subMode) {
+    if (slot < 0 || slot >= MODE_STATS_SLOTS) return false;
+    if (slot >= PRACTICE_SLOT_BASE) {
+        mode = GameModeOption::Practice;
+        subMode = slot - PRACTICE_SLOT_BASE;
+    } else if (slot >= CHALLENGE_SLOT_BASE) {
+        mode = GameModeOption::Challenge;
+        subMode = slot - CHALLENGE_SLOT_BASE;
+    } else if (slot >= SPRINT_SLOT_BASE) {
+        mode = GameModeOption::Sprint;
+        subMode = SPRINT_LENGTHS[slot - SPRINT_SLOT_BASE];
+    } else {
+        mode = GameModeOption::Classic;
+        subMode = slot - CLASSIC_SLOT_BASE;
+    }
+    return true;
+}
+
+std::string getModeStatsLabel(int slot) {
+    if (slot < 0 || slot >= MODE_STATS_SLOTS) return "";
+    return MODE_STATS_LABELS[slot];
+}
+
+bool isTimedMode(GameModeOption mode) {
+    return mode == GameModeOption::Sprint || mode == GameModeOption::Challenge;
+}
+
+
+int getClearTypeIndex(int linesCleared) {
+    if (linesCleared <= 0) return -1;
+    return std::min(linesCleared, STATS_CLEAR_TYPES) - 1;
+}
+
+void recordModeStatsGame(ModeStats& stats, const ModeGameResult& result) {
+    stats.gamesPlayed++;
+    if (result.completed) stats.gamesCompleted++;
+    stats.totalScore += result.score;
+    stats.bestScore = std::max(stats.bestScore, result.score);
+    stats.totalLines += result.lines;
+    stats.totalPieces += result.pieces;
+    stats.totalPlayTimeSeconds += result.playTimeSeconds;
+    for (int i = 0; i < STATS_CLEAR_TYPES; ++i) {
+        stats.clearCounts[i] += result.clears[i];
+    }
+
+    float minutes = result.playTimeSeconds / 60.0f;
+    float linesPerMinute = minutes > 0.0f ? result.lines / minutes : 0.0f;
+    float piecesPerSecond = result.playTimeSeconds > 0.0f ? result.pieces / result.playTimeSeconds : 0.0f;
+    stats.recentScore = blendRecent(stats.recentScore, static_cast<float>(result.score), stats.gamesPlayed);
+    stats.recentLinesPerMinute = blendRecent(stats.recentLinesPerMinute, linesPerMinute, stats.gamesPlayed);
+    stats.recentPiecesPerSecond = blendRecent(stats.recentPiecesPerSecond, piecesPerSecond, stats.gamesPlayed);
+}
+
+
+float getModeAverageScore(const ModeStats& stats) {
+    return stats.gamesPlayed > 0 ? static_cast<float>(stats.totalScore) / stats.gamesPlayed : 0.0f;
+}
+
+float getModeLinesPerMinute(const ModeStats& stats) {
+    return stats.totalPlayTimeSeconds > 0.0f ? stats.totalLines * 60.0f / stats.totalPlayTimeSeconds : 0.0f;
+}
+
+float getModePiecesPerSecond(const ModeStats& stats) {
+    return stats.totalPlayTimeSeconds > 0.0f ? stats.totalPieces / stats.totalPlayTimeSeconds : 0.0f;
+}
@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include "types.h"
+#include <array>
+#include <string>
+
+
+constexpr float MODE_STATS_RECENT_WEIGHT = 0.2f;
+
+
+struct ModeGameResult {
+    int score = 0;
+    int lines = 0;
+    int pieces = 0;
+    float playTimeSeconds = 0.0f;
+    bool completed = false;
+    std::array<int, STATS_CLEAR_TYPES> clears{};
+};
+
+
+// Classic difficulties, sprint lengths, challenges and practice difficulties
+// each get a fixed slot; returns -1 for anything outside that table.
+int getModeStatsSlot(GameModeOption mode, int subMode);
+bool getModeStatsKey(int slot, GameModeOption& mode, int& subMode);
+std::string getModeStatsLabel(int slot);
+bool isTimedMode(GameModeOption mode);
+
+
+int getClearTypeIndex(int linesCleared);
+void recordModeStatsGame(ModeStats& stats, const ModeGameResult& result);
+
+
+float getModeAverageScore(const ModeStats& stats);
+float getModeLinesPerMinute(const ModeStats& stats);
+float getModePiecesPerSecond(const ModeStats& stats);
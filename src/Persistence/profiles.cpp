@@ -0,0 +1,167 @@
+﻿#include "profiles.h"
+#include "save_system.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+
+namespace {
+
+constexpr char PROFILE_INDEX_MAGIC[4] = {'T', 'S', 'P', 'F'};
+
+#pragma pack(push, 1)
+struct ProfileIndexHeader {
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t count;
+    std::uint32_t activeId;
+    std::uint32_t nextId;
+    std::uint32_t checksum;
+};
+
+struct ProfileIndexEntry {
+    std::uint32_t id;
+    char name[PROFILE_NAME_LENGTH];
+};
+#pragma pack(pop)
+
+
+std::string encodeProfileIndex(const std::vector<PlayerProfile>& profiles, std::uint32_t activeId, std::uint32_t nextId) {
+    std::string body;
+    for (const PlayerProfile& profile : profiles) {
+        ProfileIndexEntry entry{};
+        entry.id = profile.id;
+        std::strncpy(entry.name, profile.name.c_str(), PROFILE_NAME_LENGTH - 1);
+        body.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+
+    ProfileIndexHeader header{};
+    std::memcpy(header.magic, PROFILE_INDEX_MAGIC, sizeof(header.magic));
+    header.version = PROFILE_INDEX_VERSION;
+    header.count = static_cast<std::uint16_t>(profiles.size());
+    header.activeId = activeId;
+    header.nextId = nextId;
+    header.checksum = computeSaveChecksum(body.data(), body.size());
+
+    std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+    contents += body;
+    return contents;
+}
+
+bool decodeProfileIndex(const std::string& contents, std::vector<PlayerProfile>& profiles, std::uint32_t& activeId, std::uint32_t& nextId) {
+    ProfileIndexHeader header;
+    if (contents.size() < sizeof(header)) return false;
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, PROFILE_INDEX_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version != PROFILE_INDEX_VERSION || header.count == 0) return false;
+    if (contents.size() != sizeof(header) + header.count * sizeof(ProfileIndexEntry)) return false;
+    const char* body = contents.data() + sizeof(header);
+    if (computeSaveChecksum(body, contents.size() - sizeof(header)) != header.checksum) return false;
+
+    profiles.clear();
+    for (int i = 0; i < header.count; ++i) {
+        ProfileIndexEntry entry;
+        std::memcpy(&entry, body + i * sizeof(entry), sizeof(entry));
+        entry.name[PROFILE_NAME_LENGTH - 1] = '\0';
+        profiles.push_back({entry.id, entry.name});
+    }
+    activeId = header.activeId;
+    nextId = header.nextId;
+    return true;
+}
+
+}
+
+
+std::string getProfileIndexPath() {
+    return (std::filesystem::path(getSaveRootDirectory()) / "profiles.bin").string();
+}
+
+// Profile 0 keeps the original save location so existing players become it.
+std::string getProfileSaveFilePath(std::uint32_t id) {
+    std::filesystem::path root(getSaveRootDirectory());
+    if (id == 0) return (root / "save_data.bin").string();
+    return (root / "profiles" / std::to_string(id) / "save_data.bin").string();
+}
+
+
+ProfileManager::~ProfileManager() {
+    if (worker.joinable()) worker.join();
+}
+
+int ProfileManager::findProfile(std::uint32_t id) const {
+    for (size_t i = 0; i < profiles.size(); ++i) {
+        if (profiles[i].id == id) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void ProfileManager::loadIndex() {
+    std::string contents;
+    if (!readWholeFile(getProfileIndexPath(), contents) || !decodeProfileIndex(contents, profiles, activeId, nextId)) {
+        profiles = {{0, "Player 1"}};
+        activeId = 0;
+        nextId = 1;
+    }
+    if (findProfile(activeId) < 0) activeId = profiles.front().id;
+    for (const PlayerProfile& profile : profiles) {
+        nextId = std::max(nextId, profile.id + 1);
+    }
+
+    setSaveFilePath(getProfileSaveFilePath(activeId));
+    std::cout << "Active profile: " << getActiveProfile().name << " (" << profiles.size() << " profiles)" << std::endl;
+}
+
+const PlayerProfile& ProfileManager::getActiveProfile() const {
+    int index = findProfile(activeId);
+    return profiles[index >= 0 ? index : 0];
+}
+
+
+void ProfileManager::startSwitch(std::uint32_t id) {
+    if (worker.joinable()) worker.join();
+    switching = true;
+    switchTargetId = id;
+    workerDone.store(false);
+
+    std::string indexContents = encodeProfileIndex(profiles, id, nextId);
+    std::string savePath = getProfileSaveFilePath(id);
+    worker = std::thread([this, indexContents, savePath] {
+        flushSaveData();
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(savePath).parent_path(), error);
+        replaceFileDurably(getProfileIndexPath(), indexContents);
+        loadedData = loadGameData(savePath);
+        loadedHistory.open(getHistoryFilePath(savePath));
+        workerDone.store(true, std::memory_order_release);
+    });
+}
+
+bool ProfileManager::requestNextProfile() {
+    if (switching || profiles.size() < 2) return false;
+    int index = findProfile(activeId);
+    startSwitch(profiles[(index + 1) % profiles.size()].id);
+    return true;
+}
+
+bool ProfileManager::requestNewProfile() {
+    if (switching || static_cast<int>(profiles.size()) >= MAX_PROFILES) return false;
+    std::uint32_t id = nextId++;
+    profiles.push_back({id, "Player " + std::to_string(profiles.size() + 1)});
+    startSwitch(id);
+    return true;
+}
+
+bool ProfileManager::pollSwitch(SaveData& data, GameHistory& history) {
+    if (!switching || !workerDone.load(std::memory_order_acquire)) return false;
+    worker.join();
+    switching = false;
+    activeId = switchTargetId;
+    setSaveFilePath(getProfileSaveFilePath(activeId));
+    data = loadedData;
+    history.swap(loadedHistory);
+    loadedHistory.close();
+    std::cout << "Switched to profile: " << getActiveProfile().name << std::endl;
+    return true;
+}
@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include "types.h"
+#include "game_history.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+constexpr std::uint16_t PROFILE_INDEX_VERSION = 1;
+constexpr int PROFILE_NAME_LENGTH = 24;
+constexpr int MAX_PROFILES = 16;
+
+
+struct PlayerProfile {
+    std::uint32_t id = 0;
+    std::string name;
+};
+
+
+std::string getProfileIndexPath();
+std::string getProfileSaveFilePath(std::uint32_t id);
+
+
+// The index (names plus the active id) is read at startup; a profile's own
+// save is only read when it is switched to. Switching runs on a worker
+// thread that flushes the outgoing save, rewrites the index, loads the
+// incoming save and opens its game history, and the frame loop picks the
+// result up via pollSwitch().
+class ProfileManager {
+private:
+    std::vector<PlayerProfile> profiles;
+    std::uint32_t activeId = 0;
+    std::uint32_t nextId = 1;
+
+    std::thread worker;
+    std::atomic<bool> workerDone{false};
+    bool switching = false;
+    std::uint32_t switchTargetId = 0;
+    SaveData loadedData;
+    GameHistory loadedHistory;
+
+    int findProfile(std::uint32_t id) const;
+    void startSwitch(std::uint32_t id);
+
+public:
+    ~ProfileManager();
+
+    void loadIndex();
+
+    const std::vector<PlayerProfile>& getProfiles() const { return profiles; }
+    const PlayerProfile& getActiveProfile() const;
+    bool isSwitching() const { return switching; }
+
+    bool requestNextProfile();
+    bool requestNewProfile();
+
+    bool pollSwitch(SaveData& data, GameHistory& history);
+};
@@ -1,9 +1,30 @@
 ﻿#include "save_system.h"
+#include "achievements.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
 
-std::string getSaveFilePath() {
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string resolveSaveFilePath() {
     
     std::filesystem::path saveDataPath;
     
@@ -27,111 +48,762 @@ std::string getSaveFilePath() {
     
     
     std::filesystem::path gameFolder = saveDataPath;
-    if (!std::filesystem::exists(gameFolder)) {
-        std::filesystem::create_directories(gameFolder);
+    std::error_code error;
+    if (!std::filesystem::exists(gameFolder, error)) {
+        std::filesystem::create_directories(gameFolder, error);
     }
     
-    return (gameFolder / "save_data.txt").string();
+    return (gameFolder / "save_data.bin").string();
 }
 
-void saveGameData(const SaveData& data) {
-    std::string filePath = getSaveFilePath();
-    std::ofstream file(filePath);
-    
-    if (file.is_open()) {
-        file << "HIGH_SCORE=" << data.highScore << std::endl;
-        file << "HIGH_SCORE_CLASSIC_NORMAL=" << data.highScoreClassicNormal << std::endl;
-        file << "HIGH_SCORE_CLASSIC_HARD=" << data.highScoreClassicHard << std::endl;
-        file << "BEST_TIME_SPRINT_1=" << data.bestTimeSprint1 << std::endl;
-        file << "BEST_TIME_SPRINT_24=" << data.bestTimeSprint24 << std::endl;
-        file << "BEST_TIME_SPRINT_48=" << data.bestTimeSprint48 << std::endl;
-        file << "BEST_TIME_SPRINT_96=" << data.bestTimeSprint96 << std::endl;
-        file << "BEST_TIME_CHALLENGE_DEBUG=" << data.bestTimeChallengeDebug << std::endl;
-        file << "BEST_TIME_CHALLENGE_THE_FOREST=" << data.bestTimeChallengeTheForest << std::endl;
-        file << "BEST_TIME_CHALLENGE_RANDOMNESS=" << data.bestTimeChallengeRandomness << std::endl;
-        file << "BEST_TIME_CHALLENGE_NON_STRAIGHT=" << data.bestTimeChallengeNonStraight << std::endl;
-        file << "BEST_TIME_CHALLENGE_ONE_ROT=" << data.bestTimeChallengeOneRot << std::endl;
-        file << "BEST_TIME_CHALLENGE_CHRISTOPHER_CURSE=" << data.bestTimeChallengeChristopherCurse << std::endl;
-        file << "BEST_TIME_CHALLENGE_VANISHING=" << data.bestTimeChallengeVanishing << std::endl;
-        file << "BEST_TIME_CHALLENGE_AUTO_DROP=" << data.bestTimeChallengeAutoDrop << std::endl;
-        file << "BEST_TIME_CHALLENGE_GRAVITY_FLIP=" << data.bestTimeChallengeGravityFlip << std::endl;
-        file << "BEST_TIME_CHALLENGE_PETRIFY=" << data.bestTimeChallengePetrify << std::endl;
-        file << "BEST_LINES=" << data.bestLines << std::endl;
-        file << "BEST_LEVEL=" << data.bestLevel << std::endl;
-        
+std::string getLegacySaveFilePath(const std::string& saveFilePath) {
+    return (std::filesystem::path(saveFilePath).parent_path() / "save_data.txt").string();
+}
 
-        file << "STAT_TOTAL_LINES=" << data.totalLinesCleared << std::endl;
-        file << "STAT_TOTAL_PIECES=" << data.totalPiecesPlaced << std::endl;
-        file << "STAT_TOTAL_GAMES=" << data.totalGamesPlayed << std::endl;
-        file << "STAT_TOTAL_SCORE=" << data.totalScore << std::endl;
-        file << "STAT_MAX_COMBO=" << data.maxComboEver << std::endl;
-        file << "STAT_TOTAL_BOMBS=" << data.totalBombsUsed << std::endl;
-        file << "STAT_TOTAL_PLAYTIME=" << data.totalPlayTimeSeconds << std::endl;
-        file << "STAT_TOTAL_ROTATIONS=" << data.totalRotations << std::endl;
-        file << "STAT_TOTAL_HOLDS=" << data.totalHolds << std::endl;
-        file << "STAT_TOTAL_PERFECT_CLEARS=" << data.totalPerfectClears << std::endl;
-        
-        file << "MASTER_VOLUME=" << data.masterVolume << std::endl;
-        file << "MUSIC_VOLUME=" << data.musicVolume << std::endl;
-        file << "SFX_VOLUME=" << data.sfxVolume << std::endl;
-        file << "IS_MUTED=" << (data.isMuted ? 1 : 0) << std::endl;
-        file << "SETUP_VERSION=" << data.setupVersion << std::endl;
-        file << "SELECTED_THEME=" << data.selectedTheme << std::endl;
-        
+// Profiles repoint the save at runtime while the writer thread may be
+// reading it, so the path lives behind its own lock.
+struct ActiveSavePath {
+    std::mutex mutex;
+    std::string path = resolveSaveFilePath();
+};
 
-        for (int i = 0; i < 3; i++) {
-            file << "TOP" << (i+1) << "_SCORE=" << data.topScores[i].score << std::endl;
-            file << "TOP" << (i+1) << "_LINES=" << data.topScores[i].lines << std::endl;
-            file << "TOP" << (i+1) << "_LEVEL=" << data.topScores[i].level << std::endl;
+ActiveSavePath& getActiveSavePath() {
+    static ActiveSavePath active;
+    return active;
+}
+
+}
+
+std::uint32_t computeSaveChecksum(const char* bytes, std::size_t size) {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> entries{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1u) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+            }
+            entries[i] = value;
         }
-        
+        return entries;
+    }();
+
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<unsigned char>(bytes[i])) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+namespace {
+
+std::string getBackupPath(const std::string& filePath, int index) {
+    return filePath + ".bak" + std::to_string(index);
+}
+
+bool writeFileDurably(const std::string& path, const std::string& contents) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = std::fflush(file) == 0 && ok;
+#ifdef _WIN32
+    ok = _commit(_fileno(file)) == 0 && ok;
+#else
+    ok = fsync(fileno(file)) == 0 && ok;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+void syncDirectory(const std::filesystem::path& directory) {
+#ifndef _WIN32
+    int fd = open(directory.string().c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)directory;
+#endif
+}
+
+// The new contents are fully on disk under a temp name before anything is
+// renamed, so a power cut leaves either the old file, the new file, or a
+// backup that loadGameData can fall back to.
+bool commitSaveFile(const std::string& filePath, const std::string& contents) {
+    std::filesystem::path path(filePath);
+    std::string tempPath = filePath + ".tmp";
+    if (!writeFileDurably(tempPath, contents)) {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        if (!writeFileDurably(tempPath, contents)) return false;
+    }
 
-        for (int i = 0; i < 3; i++) {
-            file << "TOP_NORMAL_" << (i+1) << "_SCORE=" << data.topScoresNormal[i].score << std::endl;
-            file << "TOP_NORMAL_" << (i+1) << "_LINES=" << data.topScoresNormal[i].lines << std::endl;
-            file << "TOP_NORMAL_" << (i+1) << "_LEVEL=" << data.topScoresNormal[i].level << std::endl;
+    std::error_code error;
+    if (std::filesystem::exists(filePath, error)) {
+        for (int i = SAVE_BACKUP_COUNT; i > 1; --i) {
+            std::string older = getBackupPath(filePath, i - 1);
+            if (std::filesystem::exists(older, error)) {
+                std::filesystem::rename(older, getBackupPath(filePath, i), error);
+            }
         }
-        
+        std::filesystem::rename(filePath, getBackupPath(filePath, 1), error);
+    }
+
+    std::filesystem::rename(tempPath, filePath, error);
+    if (error) {
+        std::cout << "Failed to replace save file: " << error.message() << std::endl;
+        return false;
+    }
+    syncDirectory(path.parent_path());
+    return true;
+}
+
+#pragma pack(push, 1)
+struct SaveFileHeader {
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t blockCount;
+    std::uint32_t bodySize;
+    std::uint32_t checksum;
+};
+
+struct SaveBlockHeader {
+    std::uint16_t id;
+    std::uint16_t reserved;
+    std::uint32_t size;
+};
+
+struct ScoreEntryBlock {
+    std::int32_t score;
+    std::int32_t lines;
+    std::int32_t level;
+};
+
+struct ScoresBlock {
+    std::int32_t highScore;
+    std::int32_t highScoreClassicNormal;
+    std::int32_t highScoreClassicHard;
+    std::int32_t bestLines;
+    std::int32_t bestLevel;
+    ScoreEntryBlock topScores[3];
+    ScoreEntryBlock topScoresNormal[3];
+    ScoreEntryBlock topScoresHard[3];
+};
+
+struct BestTimesBlock {
+    float sprint1;
+    float sprint24;
+    float sprint48;
+    float sprint96;
+    float challengeDebug;
+    float challengeTheForest;
+    float challengeRandomness;
+    float challengeNonStraight;
+    float challengeOneRot;
+    float challengeChristopherCurse;
+    float challengeVanishing;
+    float challengeAutoDrop;
+    float challengeGravityFlip;
+    float challengePetrify;
+};
+
+struct AchievementsBlock {
+    std::uint8_t unlocked[TOTAL_ACHIEVEMENTS];
+};
+
+static_assert(sizeof(AchievementsBlock) == TOTAL_ACHIEVEMENTS, "one byte per achievement, in id order");
+static_assert(sizeof(SaveData::achievements) == TOTAL_ACHIEVEMENTS, "SaveData tracks every achievement");
+
+struct StatisticsBlock {
+    std::int32_t totalLinesCleared;
+    std::int32_t totalPiecesPlaced;
+    std::int32_t totalGamesPlayed;
+    std::int32_t totalScore;
+    std::int32_t maxComboEver;
+    std::int32_t totalBombsUsed;
+    float totalPlayTimeSeconds;
+    std::int32_t totalRotations;
+    std::int32_t totalHolds;
+    std::int32_t totalPerfectClears;
+};
+
+struct ModeStatsEntryBlock {
+    std::int32_t gamesPlayed;
+    std::int32_t gamesCompleted;
+    std::int64_t totalScore;
+    std::int32_t bestScore;
+    std::int32_t totalLines;
+    std::int32_t totalPieces;
+    float totalPlayTimeSeconds;
+    std::int32_t clearCounts[STATS_CLEAR_TYPES];
+    float recentScore;
+    float recentLinesPerMinute;
+    float recentPiecesPerSecond;
+};
+
+struct ModeStatsBlock {
+    ModeStatsEntryBlock slots[MODE_STATS_SLOTS];
+};
+
+struct SettingsBlock {
+    float masterVolume;
+    float musicVolume;
+    float sfxVolume;
+    std::uint8_t isMuted;
+    std::int32_t setupVersion;
+    std::int32_t selectedTheme;
+};
 
-        for (int i = 0; i < 3; i++) {
-            file << "TOP_HARD_" << (i+1) << "_SCORE=" << data.topScoresHard[i].score << std::endl;
-            file << "TOP_HARD_" << (i+1) << "_LINES=" << data.topScoresHard[i].lines << std::endl;
-            file << "TOP_HARD_" << (i+1) << "_LEVEL=" << data.topScoresHard[i].level << std::endl;
+struct BindingsBlock {
+    std::int32_t moveLeft;
+    std::int32_t moveRight;
+    std::int32_t rotateLeft;
+    std::int32_t rotateRight;
+    std::int32_t quickFall;
+    std::int32_t drop;
+    std::int32_t hold;
+    std::int32_t bomb;
+    std::int32_t restart;
+    std::int32_t mute;
+    std::int32_t volumeDown;
+    std::int32_t volumeUp;
+    std::int32_t menu;
+};
+#pragma pack(pop)
+
+enum class SaveBlockId : std::uint16_t {
+    Scores = 1,
+    BestTimes = 2,
+    Achievements = 3,
+    Statistics = 4,
+    Settings = 5,
+    Bindings = 6,
+    ModeStats = 7
+};
+
+constexpr char SAVE_MAGIC[4] = {'T', 'S', 'S', 'V'};
+constexpr const char* LEGACY_SAVE_HEADER_MAGIC = "TESSERA_SAVE";
+
+
+void packBlock(const SaveData& data, ScoresBlock& block) {
+    block.highScore = data.highScore;
+    block.highScoreClassicNormal = data.highScoreClassicNormal;
+    block.highScoreClassicHard = data.highScoreClassicHard;
+    block.bestLines = data.bestLines;
+    block.bestLevel = data.bestLevel;
+    for (int i = 0; i < 3; i++) {
+        block.topScores[i] = {data.topScores[i].score, data.topScores[i].lines, data.topScores[i].level};
+        block.topScoresNormal[i] = {data.topScoresNormal[i].score, data.topScoresNormal[i].lines, data.topScoresNormal[i].level};
+        block.topScoresHard[i] = {data.topScoresHard[i].score, data.topScoresHard[i].lines, data.topScoresHard[i].level};
+    }
+}
+
+void unpackBlock(const ScoresBlock& block, SaveData& data) {
+    data.highScore = block.highScore;
+    data.highScoreClassicNormal = block.highScoreClassicNormal;
+    data.highScoreClassicHard = block.highScoreClassicHard;
+    data.bestLines = block.bestLines;
+    data.bestLevel = block.bestLevel;
+    for (int i = 0; i < 3; i++) {
+        data.topScores[i] = {block.topScores[i].score, block.topScores[i].lines, block.topScores[i].level};
+        data.topScoresNormal[i] = {block.topScoresNormal[i].score, block.topScoresNormal[i].lines, block.topScoresNormal[i].level};
+        data.topScoresHard[i] = {block.topScoresHard[i].score, block.topScoresHard[i].lines, block.topScoresHard[i].level};
+    }
+}
+
+void packBlock(const SaveData& data, BestTimesBlock& block) {
+    block.sprint1 = data.bestTimeSprint1;
+    block.sprint24 = data.bestTimeSprint24;
+    block.sprint48 = data.bestTimeSprint48;
+    block.sprint96 = data.bestTimeSprint96;
+    block.challengeDebug = data.bestTimeChallengeDebug;
+    block.challengeTheForest = data.bestTimeChallengeTheForest;
+    block.challengeRandomness = data.bestTimeChallengeRandomness;
+    block.challengeNonStraight = data.bestTimeChallengeNonStraight;
+    block.challengeOneRot = data.bestTimeChallengeOneRot;
+    block.challengeChristopherCurse = data.bestTimeChallengeChristopherCurse;
+    block.challengeVanishing = data.bestTimeChallengeVanishing;
+    block.challengeAutoDrop = data.bestTimeChallengeAutoDrop;
+    block.challengeGravityFlip = data.bestTimeChallengeGravityFlip;
+    block.challengePetrify = data.bestTimeChallengePetrify;
+}
+
+void unpackBlock(const BestTimesBlock& block, SaveData& data) {
+    data.bestTimeSprint1 = block.sprint1;
+    data.bestTimeSprint24 = block.sprint24;
+    data.bestTimeSprint48 = block.sprint48;
+    data.bestTimeSprint96 = block.sprint96;
+    data.bestTimeChallengeDebug = block.challengeDebug;
+    data.bestTimeChallengeTheForest = block.challengeTheForest;
+    data.bestTimeChallengeRandomness = block.challengeRandomness;
+    data.bestTimeChallengeNonStraight = block.challengeNonStraight;
+    data.bestTimeChallengeOneRot = block.challengeOneRot;
+    data.bestTimeChallengeChristopherCurse = block.challengeChristopherCurse;
+    data.bestTimeChallengeVanishing = block.challengeVanishing;
+    data.bestTimeChallengeAutoDrop = block.challengeAutoDrop;
+    data.bestTimeChallengeGravityFlip = block.challengeGravityFlip;
+    data.bestTimeChallengePetrify = block.challengePetrify;
+}
+
+void packBlock(const SaveData& data, AchievementsBlock& block) {
+    for (int i = 0; i < TOTAL_ACHIEVEMENTS; i++) {
+        block.unlocked[i] = data.achievements[i] ? 1 : 0;
+    }
+}
+
+void unpackBlock(const AchievementsBlock& block, SaveData& data) {
+    for (int i = 0; i < TOTAL_ACHIEVEMENTS; i++) {
+        data.achievements[i] = block.unlocked[i] != 0;
+    }
+}
+
+void packBlock(const SaveData& data, StatisticsBlock& block) {
+    block.totalLinesCleared = data.totalLinesCleared;
+    block.totalPiecesPlaced = data.totalPiecesPlaced;
+    block.totalGamesPlayed = data.totalGamesPlayed;
+    block.totalScore = data.totalScore;
+    block.maxComboEver = data.maxComboEver;
+    block.totalBombsUsed = data.totalBombsUsed;
+    block.totalPlayTimeSeconds = data.totalPlayTimeSeconds;
+    block.totalRotations = data.totalRotations;
+    block.totalHolds = data.totalHolds;
+    block.totalPerfectClears = data.totalPerfectClears;
+}
+
+void unpackBlock(const StatisticsBlock& block, SaveData& data) {
+    data.totalLinesCleared = block.totalLinesCleared;
+    data.totalPiecesPlaced = block.totalPiecesPlaced;
+    data.totalGamesPlayed = block.totalGamesPlayed;
+    data.totalScore = block.totalScore;
+    data.maxComboEver = block.maxComboEver;
+    data.totalBombsUsed = block.totalBombsUsed;
+    data.totalPlayTimeSeconds = block.totalPlayTimeSeconds;
+    data.totalRotations = block.totalRotations;
+    data.totalHolds = block.totalHolds;
+    data.totalPerfectClears = block.totalPerfectClears;
+}
+
+void packBlock(const SaveData& data, ModeStatsBlock& block) {
+    for (int i = 0; i < MODE_STATS_SLOTS; i++) {
+        const ModeStats& stats = data.modeStats[i];
+        ModeStatsEntryBlock& entry = block.slots[i];
+        entry.gamesPlayed = stats.gamesPlayed;
+        entry.gamesCompleted = stats.gamesCompleted;
+        entry.totalScore = stats.totalScore;
+        entry.bestScore = stats.bestScore;
+        entry.totalLines = stats.totalLines;
+        entry.totalPieces = stats.totalPieces;
+        entry.totalPlayTimeSeconds = stats.totalPlayTimeSeconds;
+        for (int c = 0; c < STATS_CLEAR_TYPES; c++) {
+            entry.clearCounts[c] = stats.clearCounts[c];
         }
-        
+        entry.recentScore = stats.recentScore;
+        entry.recentLinesPerMinute = stats.recentLinesPerMinute;
+        entry.recentPiecesPerSecond = stats.recentPiecesPerSecond;
+    }
+}
 
-        for (int i = 0; i < 25; i++) {
-            file << "ACHIEVEMENT_" << i << "=" << (data.achievements[i] ? 1 : 0) << std::endl;
+void unpackBlock(const ModeStatsBlock& block, SaveData& data) {
+    for (int i = 0; i < MODE_STATS_SLOTS; i++) {
+        const ModeStatsEntryBlock& entry = block.slots[i];
+        ModeStats& stats = data.modeStats[i];
+        stats.gamesPlayed = entry.gamesPlayed;
+        stats.gamesCompleted = entry.gamesCompleted;
+        stats.totalScore = entry.totalScore;
+        stats.bestScore = entry.bestScore;
+        stats.totalLines = entry.totalLines;
+        stats.totalPieces = entry.totalPieces;
+        stats.totalPlayTimeSeconds = entry.totalPlayTimeSeconds;
+        for (int c = 0; c < STATS_CLEAR_TYPES; c++) {
+            stats.clearCounts[c] = entry.clearCounts[c];
         }
-        
+        stats.recentScore = entry.recentScore;
+        stats.recentLinesPerMinute = entry.recentLinesPerMinute;
+        stats.recentPiecesPerSecond = entry.recentPiecesPerSecond;
+    }
+}
 
-        file << "KEY_MOVE_LEFT=" << data.moveLeft << std::endl;
-        file << "KEY_MOVE_RIGHT=" << data.moveRight << std::endl;
-        file << "KEY_ROTATE_LEFT=" << data.rotateLeft << std::endl;
-        file << "KEY_ROTATE_RIGHT=" << data.rotateRight << std::endl;
-        file << "KEY_QUICK_FALL=" << data.quickFall << std::endl;
-        file << "KEY_DROP=" << data.drop << std::endl;
-        file << "KEY_HOLD=" << data.hold << std::endl;
-        file << "KEY_BOMB=" << data.bomb << std::endl;
-        file << "KEY_RESTART=" << data.restart << std::endl;
-        file << "KEY_MUTE=" << data.mute << std::endl;
-        file << "KEY_VOLUME_DOWN=" << data.volumeDown << std::endl;
-        file << "KEY_VOLUME_UP=" << data.volumeUp << std::endl;
-        file << "KEY_MENU=" << data.menu << std::endl;
-        
-        file.close();
+void packBlock(const SaveData& data, SettingsBlock& block) {
+    block.masterVolume = data.masterVolume;
+    block.musicVolume = data.musicVolume;
+    block.sfxVolume = data.sfxVolume;
+    block.isMuted = data.isMuted ? 1 : 0;
+    block.setupVersion = data.setupVersion;
+    block.selectedTheme = data.selectedTheme;
+}
+
+void unpackBlock(const SettingsBlock& block, SaveData& data) {
+    data.masterVolume = block.masterVolume;
+    data.musicVolume = block.musicVolume;
+    data.sfxVolume = block.sfxVolume;
+    data.isMuted = block.isMuted != 0;
+    data.setupVersion = block.setupVersion;
+    data.selectedTheme = block.selectedTheme;
+}
+
+void packBlock(const SaveData& data, BindingsBlock& block) {
+    block.moveLeft = data.moveLeft;
+    block.moveRight = data.moveRight;
+    block.rotateLeft = data.rotateLeft;
+    block.rotateRight = data.rotateRight;
+    block.quickFall = data.quickFall;
+    block.drop = data.drop;
+    block.hold = data.hold;
+    block.bomb = data.bomb;
+    block.restart = data.restart;
+    block.mute = data.mute;
+    block.volumeDown = data.volumeDown;
+    block.volumeUp = data.volumeUp;
+    block.menu = data.menu;
+}
+
+void unpackBlock(const BindingsBlock& block, SaveData& data) {
+    data.moveLeft = block.moveLeft;
+    data.moveRight = block.moveRight;
+    data.rotateLeft = block.rotateLeft;
+    data.rotateRight = block.rotateRight;
+    data.quickFall = block.quickFall;
+    data.drop = block.drop;
+    data.hold = block.hold;
+    data.bomb = block.bomb;
+    data.restart = block.restart;
+    data.mute = block.mute;
+    data.volumeDown = block.volumeDown;
+    data.volumeUp = block.volumeUp;
+    data.menu = block.menu;
+}
+
+
+template <typename Block>
+void appendBlock(std::string& out, std::uint16_t& blockCount, SaveBlockId id, const SaveData& data) {
+    Block block{};
+    packBlock(data, block);
+    SaveBlockHeader header{static_cast<std::uint16_t>(id), 0, static_cast<std::uint32_t>(sizeof(Block))};
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(&block), sizeof(block));
+    ++blockCount;
+}
+
+// A block shorter than the current layout came from an older version: the
+// fields it does not cover keep whatever data already holds (the defaults).
+template <typename Block>
+void readBlock(const char* payload, std::uint32_t size, SaveData& data) {
+    Block block{};
+    packBlock(data, block);
+    std::memcpy(&block, payload, std::min<std::size_t>(size, sizeof(Block)));
+    unpackBlock(block, data);
+}
+
+// Blocks are raw little-endian structs, which is the byte order of every
+// platform the game ships on.
+std::string encodeSaveData(const SaveData& data) {
+    std::string body;
+    std::uint16_t blockCount = 0;
+    appendBlock<ScoresBlock>(body, blockCount, SaveBlockId::Scores, data);
+    appendBlock<BestTimesBlock>(body, blockCount, SaveBlockId::BestTimes, data);
+    appendBlock<AchievementsBlock>(body, blockCount, SaveBlockId::Achievements, data);
+    appendBlock<StatisticsBlock>(body, blockCount, SaveBlockId::Statistics, data);
+    appendBlock<SettingsBlock>(body, blockCount, SaveBlockId::Settings, data);
+    appendBlock<BindingsBlock>(body, blockCount, SaveBlockId::Bindings, data);
+    appendBlock<ModeStatsBlock>(body, blockCount, SaveBlockId::ModeStats, data);
+
+    SaveFileHeader header{};
+    std::memcpy(header.magic, SAVE_MAGIC, sizeof(header.magic));
+    header.version = static_cast<std::uint16_t>(SAVE_FORMAT_VERSION);
+    header.blockCount = blockCount;
+    header.bodySize = static_cast<std::uint32_t>(body.size());
+    header.checksum = computeSaveChecksum(body.data(), body.size());
+
+    std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+    contents += body;
+    return contents;
+}
+
+bool decodeSaveData(const std::string& contents, SaveData& data) {
+    SaveFileHeader header;
+    if (contents.size() < sizeof(header)) return false;
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, SAVE_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version > SAVE_FORMAT_VERSION) return false;
+
+    const char* body = contents.data() + sizeof(header);
+    if (contents.size() - sizeof(header) != header.bodySize) return false;
+    if (computeSaveChecksum(body, header.bodySize) != header.checksum) return false;
+
+    std::size_t offset = 0;
+    for (int i = 0; i < header.blockCount; ++i) {
+        SaveBlockHeader block;
+        if (header.bodySize - offset < sizeof(block)) return false;
+        std::memcpy(&block, body + offset, sizeof(block));
+        offset += sizeof(block);
+        if (header.bodySize - offset < block.size) return false;
+        const char* payload = body + offset;
+        offset += block.size;
+
+        switch (static_cast<SaveBlockId>(block.id)) {
+            case SaveBlockId::Scores: readBlock<ScoresBlock>(payload, block.size, data); break;
+            case SaveBlockId::BestTimes: readBlock<BestTimesBlock>(payload, block.size, data); break;
+            case SaveBlockId::Achievements: readBlock<AchievementsBlock>(payload, block.size, data); break;
+            case SaveBlockId::Statistics: readBlock<StatisticsBlock>(payload, block.size, data); break;
+            case SaveBlockId::Settings: readBlock<SettingsBlock>(payload, block.size, data); break;
+            case SaveBlockId::Bindings: readBlock<BindingsBlock>(payload, block.size, data); break;
+            case SaveBlockId::ModeStats: readBlock<ModeStatsBlock>(payload, block.size, data); break;
+            default: break;
+        }
+    }
+    return true;
+}
+
+bool writeSaveFile(const std::string& filePath, const SaveData& data) {
+    if (commitSaveFile(filePath, encodeSaveData(data))) {
         std::cout << "Game data saved to: " << filePath << std::endl;
-    } else {
-        std::cout << "Failed to save game data to: " << filePath << std::endl;
+        return true;
     }
+    std::cout << "Failed to save game data to: " << filePath << std::endl;
+    return false;
 }
 
-SaveData loadGameData() {
-    SaveData data;
-    std::string filePath = getSaveFilePath();
-    std::ifstream file(filePath);
-    
-    if (file.is_open()) {
+// Call sites only mark the save dirty; the writer thread picks up the latest
+// snapshot at most once per SAVE_WRITE_INTERVAL, so bursts of saves (menu
+// handlers, achievement unlocks) collapse into a single file write.
+// Other files next to the save hand their finished bytes to the same thread,
+// which writes them straight away, in the order they were queued.
+class SaveService {
+private:
+    struct FileJob {
+        std::string path;
+        std::string contents;
+        bool remove = false;
+    };
+
+    std::mutex stateMutex;
+    std::mutex fileMutex;
+    std::condition_variable wake;
+    std::condition_variable written;
+    std::thread writer;
+    SaveData pending;
+    std::string pendingPath;
+    std::uint64_t pendingSequence = 0;
+    std::uint64_t writtenSequence = 0;
+    std::uint64_t settledSequence = 0;
+    std::vector<FileJob> pendingFiles;
+    bool writingFiles = false;
+    bool dirty = false;
+    bool stopping = false;
+
+    void writeSnapshot(const SaveData& snapshot, const std::string& path, std::uint64_t sequence) {
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        if (sequence <= writtenSequence) return;
+        writeSaveFile(path, snapshot);
+        writtenSequence = sequence;
+    }
+
+    static void runFileJobs(const std::vector<FileJob>& jobs) {
+        for (const FileJob& job : jobs) {
+            if (job.remove) {
+                std::error_code error;
+                std::filesystem::remove(job.path, error);
+            } else if (!replaceFileDurably(job.path, job.contents)) {
+                std::cout << "Failed to write " << job.path << std::endl;
+            }
+        }
+    }
+
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        while (true) {
+            wake.wait(lock, [this] { return dirty || !pendingFiles.empty() || stopping; });
+            if (!pendingFiles.empty()) {
+                std::vector<FileJob> jobs;
+                jobs.swap(pendingFiles);
+                writingFiles = true;
+                lock.unlock();
+                runFileJobs(jobs);
+                lock.lock();
+                writingFiles = false;
+                written.notify_all();
+                continue;
+            }
+            if (!dirty) break;
+            if (!stopping) {
+                wake.wait_for(lock, SAVE_WRITE_INTERVAL, [this] { return stopping || !pendingFiles.empty(); });
+                if (!dirty || !pendingFiles.empty()) continue;
+            }
+
+            SaveData snapshot = pending;
+            std::string path = pendingPath;
+            std::uint64_t sequence = pendingSequence;
+            dirty = false;
+            lock.unlock();
+            writeSnapshot(snapshot, path, sequence);
+            lock.lock();
+            settledSequence = std::max(settledSequence, sequence);
+            written.notify_all();
+        }
+    }
+
+public:
+    SaveService() : writer(&SaveService::writerLoop, this) {}
+
+    ~SaveService() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (writer.joinable()) writer.join();
+    }
+
+    void markDirty(const SaveData& data, const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            pending = data;
+            pendingPath = path;
+            ++pendingSequence;
+            dirty = true;
+        }
+        wake.notify_one();
+    }
+
+    // A later job for the same path supersedes one still waiting, so a
+    // removal queued after a write cannot be undone by it.
+    void queueFile(const std::string& path, std::string contents, bool remove) {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            pendingFiles.erase(std::remove_if(pendingFiles.begin(), pendingFiles.end(),
+                [&path](const FileJob& job) { return job.path == path; }), pendingFiles.end());
+            pendingFiles.push_back(FileJob{path, std::move(contents), remove});
+        }
+        wake.notify_one();
+    }
+
+    // With nothing dirty the latest snapshot may still be in the writer's
+    // hands, so wait until its write has landed rather than returning early.
+    void flush() {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        written.wait(lock, [this] { return pendingFiles.empty() && !writingFiles; });
+        if (!dirty) {
+            written.wait(lock, [this] { return settledSequence >= pendingSequence; });
+            return;
+        }
+        SaveData snapshot = pending;
+        std::string path = pendingPath;
+        std::uint64_t sequence = pendingSequence;
+        dirty = false;
+        lock.unlock();
+        writeSnapshot(snapshot, path, sequence);
+        lock.lock();
+        settledSequence = std::max(settledSequence, sequence);
+        written.notify_all();
+    }
+
+    template <typename Action>
+    void discardPending(Action&& action) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        dirty = false;
+        settledSequence = pendingSequence;
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        writtenSequence = pendingSequence;
+        action();
+        written.notify_all();
+    }
+};
+
+SaveService& getSaveService() {
+    static SaveService service;
+    return service;
+}
+
+}
+
+std::string getSaveFilePath() {
+    ActiveSavePath& active = getActiveSavePath();
+    std::lock_guard<std::mutex> lock(active.mutex);
+    return active.path;
+}
+
+std::string getSaveRootDirectory() {
+    static const std::string root = std::filesystem::path(resolveSaveFilePath()).parent_path().string();
+    return root;
+}
+
+void setSaveFilePath(const std::string& filePath) {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), error);
+    ActiveSavePath& active = getActiveSavePath();
+    std::lock_guard<std::mutex> lock(active.mutex);
+    active.path = filePath;
+}
+
+// The path is captured with the data, so a write still pending when the
+// profile changes lands in the file it was meant for.
+void saveGameData(const SaveData& data) {
+    getSaveService().markDirty(data, getSaveFilePath());
+}
+
+void flushSaveData() {
+    getSaveService().flush();
+}
+
+void replaceFileInBackground(const std::string& filePath, std::string contents) {
+    getSaveService().queueFile(filePath, std::move(contents), false);
+}
+
+void removeFileInBackground(const std::string& filePath) {
+    getSaveService().queueFile(filePath, std::string(), true);
+}
+
+bool replaceFileDurably(const std::string& filePath, const std::string& contents) {
+    std::string tempPath = filePath + ".tmp";
+    if (!writeFileDurably(tempPath, contents)) return false;
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, filePath, error);
+    if (error) {
+        std::cout << "Failed to replace " << filePath << ": " << error.message() << std::endl;
+        return false;
+    }
+    syncDirectory(std::filesystem::path(filePath).parent_path());
+    return true;
+}
+
+bool readWholeFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    std::streamsize size = file.tellg();
+    if (size < 0) return false;
+    contents.resize(static_cast<std::size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(&contents[0], size)) || size == 0;
+}
+
+namespace {
+
+// Text saves from before the binary format: the oldest ones have no header,
+// later ones carry a checksummed header line.
+bool extractLegacySaveBody(const std::string& contents, std::string& body, bool requireHeader) {
+    if (contents.rfind(LEGACY_SAVE_HEADER_MAGIC, 0) != 0) {
+        if (requireHeader) return false;
+        body = contents;
+        return !contents.empty();
+    }
+
+    std::size_t headerEnd = contents.find('\n');
+    if (headerEnd == std::string::npos) return false;
+    std::istringstream header(contents.substr(0, headerEnd));
+    std::string magic;
+    int version = 0;
+    std::size_t length = 0;
+    std::uint32_t checksum = 0;
+    if (!(header >> magic >> version >> length >> std::hex >> checksum)) return false;
+
+    body = contents.substr(headerEnd + 1);
+    return body.size() == length && computeSaveChecksum(body.data(), body.size()) == checksum;
+}
+
+bool parseLegacySaveText(const std::string& text, SaveData& data) {
+    std::istringstream file(text);
+    try {
         std::string line;
         while (std::getline(file, line)) {
             std::size_t pos = line.find('=');
@@ -216,7 +888,7 @@ SaveData loadGameData() {
                 } else if (key.rfind("ACHIEVEMENT_", 0) == 0) {
 
                     int achievementId = std::stoi(key.substr(12));
-                    if (achievementId >= 0 && achievementId < 25) {
+                    if (achievementId >= 0 && achievementId < TOTAL_ACHIEVEMENTS) {
                         data.achievements[achievementId] = (std::stoi(value) == 1);
                     }
                 } else if (key == "KEY_MOVE_LEFT") {
@@ -299,14 +971,89 @@ SaveData loadGameData() {
                 }
             }
         }
-        file.close();
-        std::cout << "Game data loaded from: " << filePath << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Corrupt save value: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool isTempPath(const std::string& path) {
+    return path.size() > 4 && path.compare(path.size() - 4, 4, ".tmp") == 0;
+}
+
+std::vector<std::string> getLoadCandidates(const std::string& filePath) {
+    std::vector<std::string> candidates = {filePath + ".tmp", filePath};
+    for (int i = 1; i <= SAVE_BACKUP_COUNT; ++i) {
+        candidates.push_back(getBackupPath(filePath, i));
+    }
+    return candidates;
+}
+
+// A leftover temp file means a commit was interrupted after it was fully
+// written, so it is the newest data when it validates.
+bool loadFirstValid(const std::vector<std::string>& candidates, bool legacy, SaveData& data, bool& anyFound) {
+    for (const std::string& candidate : candidates) {
+        std::string contents;
+        if (!readWholeFile(candidate, contents)) continue;
+        anyFound = true;
+
+        SaveData loaded;
+        bool valid = false;
+        if (legacy) {
+            std::string body;
+            valid = extractLegacySaveBody(contents, body, isTempPath(candidate)) && parseLegacySaveText(body, loaded);
+        } else {
+            valid = decodeSaveData(contents, loaded);
+        }
+        if (!valid) {
+            std::cout << "Save file failed validation, trying backup: " << candidate << std::endl;
+            continue;
+        }
+        std::cout << "Game data loaded from: " << candidate << std::endl;
+        data = loaded;
+        return true;
+    }
+    return false;
+}
+
+void migrateLegacySave(const std::string& saveFilePath, const SaveData& data) {
+    if (!writeSaveFile(saveFilePath, data)) return;
+    std::string legacyPath = getLegacySaveFilePath(saveFilePath);
+    std::error_code error;
+    std::filesystem::rename(legacyPath, legacyPath + ".migrated", error);
+    for (const std::string& candidate : getLoadCandidates(legacyPath)) {
+        if (candidate != legacyPath) std::filesystem::remove(candidate, error);
+    }
+    std::cout << "Migrated text save to binary format" << std::endl;
+}
+
+}
+
+SaveData loadGameData() {
+    return loadGameData(getSaveFilePath());
+}
+
+SaveData loadGameData(const std::string& saveFilePath) {
+    SaveData data;
+    bool anyFound = false;
+    bool loaded = loadFirstValid(getLoadCandidates(saveFilePath), false, data, anyFound);
+
+    if (!loaded && !anyFound) {
+        loaded = loadFirstValid(getLoadCandidates(getLegacySaveFilePath(saveFilePath)), true, data, anyFound);
+        if (loaded) migrateLegacySave(saveFilePath, data);
+    }
+
+    if (loaded) {
         std::cout << "High Score: " << data.highScore << " | Best Lines: " << data.bestLines << " | Best Level: " << data.bestLevel << std::endl;
+        return data;
+    }
+    if (anyFound) {
+        std::cout << "No valid save or backup found, using default values" << std::endl;
     } else {
         std::cout << "No save file found, using default values" << std::endl;
     }
-    
-    return data;
+    return SaveData();
 }
 
 bool insertNewScore(SaveData& saveData, int score, int lines, int level, ClassicDifficulty difficulty) {
@@ -389,14 +1136,25 @@ bool insertNewScore(SaveData& saveData, int score, int lines, int level, Classic
 
 void deleteSaveFile() {
     std::string filePath = getSaveFilePath();
-    try {
-        if (std::filesystem::exists(filePath)) {
-            std::filesystem::remove(filePath);
-            std::cout << "Save file deleted: " << filePath << std::endl;
-        } else {
-            std::cout << "Save file does not exist: " << filePath << std::endl;
+    getSaveService().discardPending([&filePath] {
+        try {
+            if (std::filesystem::exists(filePath)) {
+                std::filesystem::remove(filePath);
+                std::cout << "Save file deleted: " << filePath << std::endl;
+            } else {
+                std::cout << "Save file does not exist: " << filePath << std::endl;
+            }
+            // Every file loadGameData could fall back to goes, including the
+            // legacy text save and its backups, or the scores would migrate back.
+            std::error_code error;
+            for (const std::string& candidate : getLoadCandidates(filePath)) {
+                std::filesystem::remove(candidate, error);
+            }
+            for (const std::string& candidate : getLoadCandidates(getLegacySaveFilePath(filePath))) {
+                std::filesystem::remove(candidate, error);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error deleting save file: " << e.what() << std::endl;
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Error deleting save file: " << e.what() << std::endl;
-    }
+    });
 }
@@ -1,16 +1,45 @@
 ﻿#pragma once
 
 #include "types.h"
+#include <chrono>
+#include <cstdint>
 #include <string>
 
 
+constexpr std::chrono::milliseconds SAVE_WRITE_INTERVAL{500};
+constexpr int SAVE_FORMAT_VERSION = 2;
+constexpr int SAVE_BACKUP_COUNT = 3;
+
+
+// The active profile's save file; everything else kept per player
+// (history, analytics, suspended game) lives in the same directory.
 std::string getSaveFilePath();
+std::string getSaveRootDirectory();
+void setSaveFilePath(const std::string& filePath);
 
 
+// Queues the snapshot for the background writer and returns immediately.
 void saveGameData(const SaveData& data);
 
 
+// Also waits for the files queued below.
+void flushSaveData();
+
+
+// Shared by the other files kept next to the save: CRC32, a temp-file write
+// that is synced before it replaces the target, and a whole-file read.
+std::uint32_t computeSaveChecksum(const char* bytes, std::size_t size);
+bool replaceFileDurably(const std::string& filePath, const std::string& contents);
+bool readWholeFile(const std::string& path, std::string& contents);
+
+
+// The same durable replace, and a removal, run on the save writer thread.
+void replaceFileInBackground(const std::string& filePath, std::string contents);
+void removeFileInBackground(const std::string& filePath);
+
+
 SaveData loadGameData();
+SaveData loadGameData(const std::string& saveFilePath);
 
 
 void deleteSaveFile();
@@ -0,0 +1,87 @@
+﻿#include "piece_blocks.h"
+
+PieceBlocks getPieceBlocks(PieceType type) {
+    PieceBlocks blocks;
+    switch(type){
+        case PieceType::I_Basic:
+            blocks = {{false, false, false, false},{true, true, true, true},{false, false, false, false},{false, false, false, false}};
+            break;
+        case PieceType::I_Medium:
+            blocks = {{false, false, false, false, false},{false, false, false, false, false},{true, true, true, true, true},{false, false, false, false, false},{false, false, false, false, false}};
+            break;
+        case PieceType::I_Hard:
+            blocks = {{false, false, false, false, false},{false, false, false, false, false},{true, true, true, true, true},{false, false, true, false, false},{false, false, false, false, false}};
+            break;
+
+        case PieceType::T_Basic:
+            blocks = {{false, true, false},{true, true, true},{false, false, false}};
+            break;
+        case PieceType::T_Medium:
+            blocks = {{false, true, false},{false, true, false},{true, true, true}};
+            break;
+        case PieceType::T_Hard:
+            blocks = {{false, true, false},{false, true, false},{true, true, true},{false, true, false},{false, false, false}};
+            break;
+
+        case PieceType::L_Basic:
+            blocks = {{true, false, false},{true, true, true},{false, false, false}};
+            break;
+        case PieceType::L_Medium:
+            blocks = {{false, false, false, false},{true, false, false, false},{true, true, true, true},{false, false, false, false}};
+            break;
+        case PieceType::L_Hard:
+            blocks = {{false, false, false, false},{true, true, false, false},{true, true, true, true},{false, false, false, false}};
+            break;
+
+        case PieceType::J_Basic:
+            blocks = {{false, false, true},{true, true, true},{false, false, false}};
+            break;
+        case PieceType::J_Medium:
+            blocks = {{false, false, false, true},{true, true, true, true}};
+            break;
+        case PieceType::J_Hard:
+            blocks = {{false, false, false, false},{false, false, true, true},{true, true, true, true},{false, false, false, false}};
+            break;
+
+        case PieceType::O_Basic:
+            blocks = {{true, true},{true, true}};
+            break;
+        case PieceType::O_Medium:
+            blocks = {{false, false, false},{true, true, true},{true, true, true}};
+            break;
+        case PieceType::O_Hard:
+            blocks = {{false, true, true},{true, true, true},{true, true, false}};
+            break;
+
+        case PieceType::S_Basic:
+            blocks = {{false, true, true},{true, true, false},{false, false, false}};
+            break;
+        case PieceType::S_Medium:
+            blocks = {{false, true, false},{false, true, true},{true, true, false}};
+            break;
+        case PieceType::S_Hard:
+            blocks = {{false, true, false},{false, true, true},{true, true, false},{false, true, false}};
+            break;
+
+        case PieceType::Z_Basic:
+            blocks = {{true, true, false},{false, true, true},{false, false, false}};
+            break;
+        case PieceType::Z_Medium:
+            blocks = {{false, true, false},{true, true, false},{false, true, true}};
+            break;
+        case PieceType::Z_Hard:
+            blocks = {{false, true, false},{true, true, false},{false, true, true},{false, true, false}};
+            break;
+        case PieceType::Cream_Single:
+            blocks = {{true}};
+            break;
+        case PieceType::A_Bomb:
+            blocks = {{true}};
+            break;
+
+        case PieceType::A_Stomp:
+            blocks = {{true, true, true}};
+            break;
+    }
+    return blocks;
+}
@@ -0,0 +1,15 @@
+﻿#ifndef PIECE_BLOCKS_H
+#define PIECE_BLOCKS_H
+
+#include "board_types.h"
+#include <vector>
+
+
+using PieceBlocks = std::vector<std::vector<bool>>;
+
+
+// Spawn-orientation cells of each piece, row by row. getPieceShape adds the
+// colour on top; the simulator builds its masks from these alone.
+PieceBlocks getPieceBlocks(PieceType type);
+
+#endif
@@ -2,108 +2,85 @@
 
 PieceShape getPieceShape(PieceType type) {
     PieceShape shape;
+    shape.blocks = getPieceBlocks(type);
     switch(type){
         case PieceType::I_Basic:
-            shape.blocks = {{false, false, false, false},{true, true, true, true},{false, false, false, false},{false, false, false, false}};
             shape.color = sf::Color(69, 255, 112);
             break;
         case PieceType::I_Medium:
-            shape.blocks = {{false, false, false, false, false},{false, false, false, false, false},{true, true, true, true, true},{false, false, false, false, false},{false, false, false, false, false}};
             shape.color = sf::Color(69, 255, 112);
             break;
         case PieceType::I_Hard:
-            shape.blocks = {{false, false, false, false, false},{false, false, false, false, false},{true, true, true, true, true},{false, false, true, false, false},{false, false, false, false, false}};
             shape.color = sf::Color(69, 255, 112);
             break;
 
         case PieceType::T_Basic:
-            shape.blocks = {{false, true, false},{true, true, true},{false, false, false}};
             shape.color = sf::Color(255, 0, 80);
             break;
         case PieceType::T_Medium:
-            shape.blocks = {{false, true, false},{false, true, false},{true, true, true}};
             shape.color = sf::Color(255, 0, 80);
             break;
         case PieceType::T_Hard:
-            shape.blocks = {{false, true, false},{false, true, false},{true, true, true},{false, true, false},{false, false, false}};
             shape.color = sf::Color(255, 0, 80);
             break;
 
         case PieceType::L_Basic:
-            shape.blocks = {{true, false, false},{true, true, true},{false, false, false}};
             shape.color = sf::Color(255, 249, 40);
             break;
         case PieceType::L_Medium:
-            shape.blocks = {{false, false, false, false},{true, false, false, false},{true, true, true, true},{false, false, false, false}};
             shape.color = sf::Color(255, 249, 40);
             break;
         case PieceType::L_Hard:
-            shape.blocks = {{false, false, false, false},{true, true, false, false},{true, true, true, true},{false, false, false, false}};
             shape.color = sf::Color(255, 249, 40);
             break;
 
         case PieceType::J_Basic:
-            shape.blocks = {{false, false, true},{true, true, true},{false, false, false}};
             shape.color = sf::Color(255, 142, 0);
             break;
         case PieceType::J_Medium:
-            shape.blocks = {{false, false, false, true},{true, true, true, true}};
             shape.color = sf::Color(255, 142, 0);
             break;
         case PieceType::J_Hard:
-            shape.blocks = {{false, false, false, false},{false, false, true, true},{true, true, true, true},{false, false, false, false}};
             shape.color = sf::Color(255, 142, 0);
             break;
 
         case PieceType::O_Basic:
-            shape.blocks = {{true, true},{true, true}};
             shape.color = sf::Color(90, 30, 10);
             break;
         case PieceType::O_Medium:
-            shape.blocks = {{false, false, false},{true, true, true},{true, true, true}};
             shape.color = sf::Color(90, 30, 10);
             break;
         case PieceType::O_Hard:
-            shape.blocks = {{false, true, true},{true, true, true},{true, true, false}};
             shape.color = sf::Color(90, 30, 10);
             break;
 
         case PieceType::S_Basic:
-            shape.blocks = {{false, true, true},{true, true, false},{false, false, false}};
             shape.color = sf::Color(153, 15, 248);
             break;
         case PieceType::S_Medium:
-            shape.blocks = {{false, true, false},{false, true, true},{true, true, false}};
             shape.color = sf::Color(153, 15, 248);
             break;
         case PieceType::S_Hard:
-            shape.blocks = {{false, true, false},{false, true, true},{true, true, false},{false, true, false}};
             shape.color = sf::Color(153, 15, 248);
             break;
 
         case PieceType::Z_Basic:
-            shape.blocks = {{true, true, false},{false, true, true},{false, false, false}};
             shape.color = sf::Color(0, 115, 255);
             break;
         case PieceType::Z_Medium:
-            shape.blocks = {{false, true, false},{true, true, false},{false, true, true}};
             shape.color = sf::Color(0, 115, 255);
             break;
         case PieceType::Z_Hard:
-            shape.blocks = {{false, true, false},{true, true, false},{false, true, true},{false, true, false}};
             shape.color = sf::Color(0, 115, 255);
             break;
         case PieceType::Cream_Single:
-            shape.blocks = {{true}};
             shape.color = sf::Color(255, 253, 208);
             break;
         case PieceType::A_Bomb:
-            shape.blocks = {{true}};
             shape.color = sf::Color(255, 255, 255);
             break;
 
         case PieceType::A_Stomp:
-            shape.blocks = {{true, true, true}};
             shape.color = sf::Color(160, 82, 45);
             break;
     }
@@ -2,6 +2,7 @@
 #define PIECE_UTILS_H
 
 #include "types.h"
+#include "piece_blocks.h"
 #include <string>
 
 
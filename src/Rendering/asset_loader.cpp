@@ -0,0 +1,106 @@
+﻿#include "asset_loader.h"
+#include "asset_pack.h"
+#include "trace.h"
+#include <algorithm>
+#include <thread>
+
+
+AssetLoader::~AssetLoader() {
+    for (auto& worker : workers) {
+        if (worker.valid()) {
+            worker.wait();
+        }
+    }
+}
+
+std::size_t AssetLoader::addImage(const std::string& path) {
+    images.push_back({path, sf::Image(), false});
+    return images.size() - 1;
+}
+
+void AssetLoader::addFont(sf::Font& font, const std::string& path) {
+    fonts.push_back({&font, path});
+}
+
+void AssetLoader::start() {
+    imageStates = std::vector<std::atomic<DecodeState>>(images.size());
+    for (auto& state : imageStates) {
+        state.store(DecodeState::Pending);
+    }
+
+    std::size_t jobCount = images.size() + fonts.size();
+    int workerCount = std::max(1, std::min<int>({ASSET_DECODE_MAX_WORKERS, static_cast<int>(std::thread::hardware_concurrency()), static_cast<int>(jobCount)}));
+    for (int i = 0; i < workerCount; i++) {
+        workers.push_back(std::async(std::launch::async, &AssetLoader::decodeJobs, this));
+    }
+}
+
+
+// Images come first in the job order so the splash, added before anything
+// else, is the first file read.
+void AssetLoader::decodeJobs() {
+    traceSetThreadName("asset loader");
+    std::size_t job;
+    while ((job = nextJob.fetch_add(1)) < images.size() + fonts.size()) {
+        if (job < images.size()) {
+            TraceZone zone("decode image", images[job].path);
+            AssetBlob packed = getAssetPack().find(images[job].path);
+            bool decoded = packed ? images[job].image.loadFromMemory(packed.data, packed.size)
+                                  : images[job].image.loadFromFile(images[job].path);
+            imageStates[job].store(decoded ? DecodeState::Decoded : DecodeState::Failed, std::memory_order_release);
+        } else {
+            FontJob& fontJob = fonts[job - images.size()];
+            TraceZone zone("open font", fontJob.path);
+            AssetBlob packed = getAssetPack().find(fontJob.path);
+            bool opened = packed ? fontJob.font->openFromMemory(packed.data, packed.size)
+                                 : fontJob.font->openFromFile(fontJob.path);
+            if (!opened) {
+                fontsFailed.fetch_add(1);
+            }
+            fontsDone.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
+int AssetLoader::uploadDecodedImages(const UploadHandler& onUploaded, int maxUploads) {
+    int uploads = 0;
+    for (std::size_t i = 0; i < images.size() && uploads < maxUploads; i++) {
+        ImageJob& job = images[i];
+        DecodeState state = imageStates.empty() ? DecodeState::Pending : imageStates[i].load(std::memory_order_acquire);
+        if (job.uploaded || state == DecodeState::Pending) {
+            continue;
+        }
+
+        TraceZone zone("upload texture", job.path);
+        sf::Texture texture;
+        bool ok = state == DecodeState::Decoded && texture.loadFromImage(job.image);
+        job.image = sf::Image();
+        job.uploaded = true;
+        uploadedCount++;
+        uploads++;
+        zone.finish();
+        onUploaded(i, ok ? &texture : nullptr);
+    }
+    return uploads;
+}
+
+void AssetLoader::finish(const UploadHandler& onUploaded) {
+    for (auto& worker : workers) {
+        if (worker.valid()) {
+            worker.wait();
+        }
+    }
+    uploadDecodedImages(onUploaded, static_cast<int>(images.size()));
+}
+
+bool AssetLoader::isFinished() const {
+    return uploadedCount == images.size() && fontsDone.load(std::memory_order_acquire) == static_cast<int>(fonts.size());
+}
+
+float AssetLoader::getProgress() const {
+    std::size_t total = images.size() + fonts.size();
+    if (total == 0) {
+        return 1.0f;
+    }
+    return static_cast<float>(uploadedCount + fontsDone.load()) / static_cast<float>(total);
+}
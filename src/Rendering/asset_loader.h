@@ -0,0 +1,66 @@
+﻿#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+
+constexpr int ASSET_DECODE_MAX_WORKERS = 4;
+constexpr int ASSET_UPLOADS_PER_FRAME = 2;
+
+
+// Startup images and fonts. Files are read and decoded on worker threads;
+// the decoded pixels are turned into textures on the thread that owns the
+// window, a few per frame, so the splash screen can draw while the rest of
+// the assets arrive.
+class AssetLoader {
+public:
+    // texture is null when the image could not be decoded or uploaded.
+    using UploadHandler = std::function<void(std::size_t image, sf::Texture* texture)>;
+
+    ~AssetLoader();
+
+    std::size_t addImage(const std::string& path);
+    void addFont(sf::Font& font, const std::string& path);
+    void start();
+
+    int uploadDecodedImages(const UploadHandler& onUploaded, int maxUploads);
+    void finish(const UploadHandler& onUploaded);
+
+    bool isFinished() const;
+    bool allFontsLoaded() const { return fontsFailed.load() == 0; }
+    float getProgress() const;
+    const std::string& getImagePath(std::size_t image) const { return images[image].path; }
+
+private:
+    enum class DecodeState { Pending, Decoded, Failed };
+
+    struct ImageJob {
+        std::string path;
+        sf::Image image;
+        bool uploaded = false;
+    };
+
+    struct FontJob {
+        sf::Font* font;
+        std::string path;
+    };
+
+    std::vector<ImageJob> images;
+    std::vector<FontJob> fonts;
+    std::vector<std::atomic<DecodeState>> imageStates;
+    std::vector<std::future<void>> workers;
+    std::atomic<std::size_t> nextJob{0};
+    std::atomic<int> fontsDone{0};
+    std::atomic<int> fontsFailed{0};
+    std::size_t uploadedCount = 0;
+
+    void decodeJobs();
+};
+
+#endif
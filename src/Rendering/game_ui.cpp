@@ -74,7 +74,7 @@ void drawBombAbility(sf::RenderWindow& window, bool isAvailable, int linesSinceL
     if (!shaderLoadAttempted) {
         shaderLoadAttempted = true;
         if (sf::Shader::isAvailable()) {
-            shaderLoaded = grayscaleShader.loadFromFile("Assets/Shaders/grayscale.frag", sf::Shader::Type::Fragment);
+            shaderLoaded = loadFragmentShader(grayscaleShader, "Assets/Shaders/grayscale.frag");
         }
     }
     
@@ -638,6 +638,157 @@ void drawDebugMode(sf::RenderWindow& window, const sf::Font& font, bool fontLoad
     window.draw(debugText);
 }
 
+void drawPerfectClearGuide(sf::RenderWindow& window, const PerfectClearTrainer& trainer, const sf::Font& font, bool fontLoaded, const sf::Color& frameColor) {
+    if (!trainer.isEnabled()) return;
+
+    const PcSolution& solution = trainer.getSolution();
+    PcStep target;
+    bool hasTarget = trainer.getTarget(target);
+
+
+    if (hasTarget) {
+        const PieceMask& mask = getPieceMask(target.placement.type, target.placement.rotation);
+        for (int row = mask.minRow; row <= mask.maxRow; ++row) {
+            for (int col = mask.minCol; col <= mask.maxCol; ++col) {
+                if (!(mask.rows[row] & (1u << col))) continue;
+                int gy = target.placement.y + row;
+                if (gy < 0) continue;
+                sf::RectangleShape cell;
+                cell.setSize(sf::Vector2f(CELL_SIZE - 6, CELL_SIZE - 6));
+                cell.setPosition(sf::Vector2f(GRID_OFFSET_X + (target.placement.x + col) * CELL_SIZE + 3, GRID_OFFSET_Y + gy * CELL_SIZE + 3));
+                cell.setFillColor(sf::Color(0, 255, 255, 40));
+                cell.setOutlineColor(sf::Color(0, 255, 255, 220));
+                cell.setOutlineThickness(3);
+                window.draw(cell);
+            }
+        }
+    }
+
+    if (!fontLoaded) return;
+
+    float panelX = GRID_OFFSET_X + GRID_WIDTH * CELL_SIZE + 50;
+    float panelY = GRID_OFFSET_Y + 340;
+
+    sf::RectangleShape panelBg;
+    panelBg.setFillColor(sf::Color(20, 25, 40, 220));
+    panelBg.setOutlineColor(frameColor);
+    panelBg.setOutlineThickness(3);
+    panelBg.setPosition(sf::Vector2f(panelX, panelY));
+    panelBg.setSize(sf::Vector2f(260, 150));
+    window.draw(panelBg);
+
+    sf::Text title(font, "PC TRAINER");
+    title.setCharacterSize(24);
+    title.setFillColor(sf::Color(0, 255, 255));
+    title.setStyle(sf::Text::Bold);
+    title.setPosition(sf::Vector2f(panelX + 12, panelY + 8));
+    window.draw(title);
+
+    std::string status;
+    std::string detail;
+    if (trainer.isSearching()) {
+        status = "SEARCHING...";
+    } else if (!solution.supported) {
+        status = "NOT AVAILABLE";
+        detail = "BASIC PIECES ONLY";
+    } else if (!solution.found) {
+        status = "NO PERFECT CLEAR";
+        detail = solution.budgetExhausted ? "SEARCH LIMIT REACHED" : "";
+    } else {
+        status = solution.guaranteed ? "GUARANTEED" : "NEEDS LUCK";
+        detail = std::to_string(solution.piecesNeeded) + " PIECES LEFT";
+        if (hasTarget && target.useHold) {
+            detail += " - HOLD";
+        }
+    }
+
+    sf::Text statusText(font, status);
+    statusText.setCharacterSize(20);
+    statusText.setFillColor(sf::Color::White);
+    statusText.setPosition(sf::Vector2f(panelX + 12, panelY + 48));
+    window.draw(statusText);
+
+    sf::Text detailText(font, detail);
+    detailText.setCharacterSize(18);
+    detailText.setFillColor(sf::Color(180, 180, 200));
+    detailText.setPosition(sf::Vector2f(panelX + 12, panelY + 80));
+    window.draw(detailText);
+
+    if (trainer.getStepsFollowed() > 0) {
+        sf::Text streakText(font, "STEPS FOLLOWED: " + std::to_string(trainer.getStepsFollowed()));
+        streakText.setCharacterSize(18);
+        streakText.setFillColor(sf::Color(120, 255, 120));
+        streakText.setPosition(sf::Vector2f(panelX + 12, panelY + 110));
+        window.draw(streakText);
+    }
+}
+
+void drawFinesseInfo(sf::RenderWindow& window, const FinesseTracker& finesse, const sf::Font& font, bool fontLoaded) {
+    if (!fontLoaded || finesse.getPiecesAnalyzed() == 0) return;
+
+    float posX = GRID_OFFSET_X - 300;
+    float posY = GRID_OFFSET_Y + GRID_HEIGHT * CELL_SIZE - 220;
+
+    sf::Text title(font, "FINESSE " + std::to_string(static_cast<int>(std::round(finesse.getAccuracy() * 100.0f))) + "%");
+    title.setCharacterSize(28);
+    title.setFillColor(sf::Color::White);
+    title.setStyle(sf::Text::Bold);
+    title.setPosition(sf::Vector2f(posX, posY));
+    window.draw(title);
+
+    sf::Text faultsText(font, std::to_string(finesse.getTotalFaults()) + " FAULTS");
+    faultsText.setCharacterSize(22);
+    faultsText.setFillColor(sf::Color(180, 180, 200));
+    faultsText.setPosition(sf::Vector2f(posX, posY + 36));
+    window.draw(faultsText);
+
+    if (finesse.hasLastResult() && finesse.getLastFaults() > 0) {
+        sf::Text lastText(font, "LAST " + std::to_string(finesse.getLastPlayerInputs()) + "/" + std::to_string(finesse.getLastOptimalInputs()) + " KEYS");
+        lastText.setCharacterSize(20);
+        lastText.setFillColor(sf::Color(255, 120, 120));
+        lastText.setPosition(sf::Vector2f(posX, posY + 66));
+        window.draw(lastText);
+    }
+}
+
+void drawFinesseSummary(sf::RenderWindow& window, const FinesseTracker& finesse, const sf::Font& font, bool fontLoaded, float uiAlpha, const sf::Color& frameColor) {
+    if (!fontLoaded || finesse.getPiecesAnalyzed() == 0) return;
+
+    std::uint8_t alpha = static_cast<std::uint8_t>(255 * std::clamp(uiAlpha, 0.0f, 1.0f));
+    float panelX = 1920.0f - 410.0f;
+    float panelY = 1080.0f / 2.0f - 90.0f;
+
+    sf::RectangleShape panelBg;
+    panelBg.setFillColor(sf::Color(20, 20, 30, alpha));
+    sf::Color outline = frameColor;
+    outline.a = alpha;
+    panelBg.setOutlineColor(outline);
+    panelBg.setOutlineThickness(3);
+    panelBg.setPosition(sf::Vector2f(panelX, panelY));
+    panelBg.setSize(sf::Vector2f(380, 180));
+    window.draw(panelBg);
+
+    sf::Text title(font, "FINESSE");
+    title.setCharacterSize(36);
+    title.setFillColor(sf::Color(255, 255, 0, alpha));
+    title.setStyle(sf::Text::Bold);
+    title.setPosition(sf::Vector2f(panelX + 20, panelY + 12));
+    window.draw(title);
+
+    std::string lines[] = {
+        "ACCURACY: " + std::to_string(static_cast<int>(std::round(finesse.getAccuracy() * 100.0f))) + "%",
+        "PERFECT PIECES: " + std::to_string(finesse.getPerfectPieces()) + "/" + std::to_string(finesse.getPiecesAnalyzed()),
+        "FAULTS: " + std::to_string(finesse.getTotalFaults())
+    };
+    for (int i = 0; i < 3; ++i) {
+        sf::Text line(font, lines[i]);
+        line.setCharacterSize(24);
+        line.setFillColor(sf::Color(220, 220, 230, alpha));
+        line.setPosition(sf::Vector2f(panelX + 20, panelY + 65 + i * 34));
+        window.draw(line);
+    }
+}
+
 void drawAchievementPopups(sf::RenderWindow& window, const std::vector<AchievementPopup>& popups, const sf::Font& font, bool fontLoaded) {
     if (!fontLoaded) return;
     
@@ -2,6 +2,8 @@
 
 #include "types.h"
 #include "game_mode_theme.h"
+#include "pc_solver.h"
+#include "finesse.h"
 #include <SFML/Graphics.hpp>
 #include <map>
 #include <vector>
@@ -44,6 +46,14 @@ void drawVolumeIndicator(sf::RenderWindow& window, const sf::Font& font, bool fo
 void drawMuteIcon(sf::RenderWindow& window, const std::map<TextureType, sf::Texture>& textures, 
                  const sf::Font& font, bool fontLoaded);
 void drawDebugMode(sf::RenderWindow& window, const sf::Font& font, bool fontLoaded);
+void drawPerfectClearGuide(sf::RenderWindow& window, const PerfectClearTrainer& trainer,
+                          const sf::Font& font, bool fontLoaded,
+                          const sf::Color& frameColor = sf::Color(100, 150, 255));
+void drawFinesseInfo(sf::RenderWindow& window, const FinesseTracker& finesse,
+                    const sf::Font& font, bool fontLoaded);
+void drawFinesseSummary(sf::RenderWindow& window, const FinesseTracker& finesse,
+                       const sf::Font& font, bool fontLoaded, float uiAlpha = 1.0f,
+                       const sf::Color& frameColor = sf::Color(100, 150, 255));
 void drawAchievementPopups(sf::RenderWindow& window, const std::vector<AchievementPopup>& popups, 
                           const sf::Font& font, bool fontLoaded);
 void drawCustomCursor(sf::RenderWindow& window, const std::map<TextureType, sf::Texture>& textures, 
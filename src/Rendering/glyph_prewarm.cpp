@@ -0,0 +1,64 @@
+﻿#include "glyph_prewarm.h"
+#include <array>
+
+
+namespace {
+
+struct GlyphStyle {
+    unsigned int characterSize;
+    bool bold;
+    float outlineThickness;
+};
+
+// Fixed sizes passed to setCharacterSize in menu_render.cpp and game_ui.cpp,
+// regular and bold, plus the outlined titles.
+constexpr std::array<GlyphStyle, 53> PREWARM_STYLES = {{
+    {14, false, 0}, {14, true, 0}, {18, false, 0}, {18, true, 0},
+    {20, false, 0}, {20, true, 0}, {22, false, 0}, {22, true, 0},
+    {24, false, 0}, {24, true, 0}, {26, false, 0}, {26, true, 0},
+    {28, false, 0}, {28, true, 0}, {32, false, 0}, {32, true, 0},
+    {36, false, 0}, {36, true, 0}, {38, false, 0}, {38, true, 0},
+    {40, false, 0}, {40, true, 0}, {42, false, 0}, {42, true, 0},
+    {48, false, 0}, {48, true, 0}, {50, false, 0}, {50, true, 0},
+    {56, false, 0}, {56, true, 0}, {60, false, 0}, {60, true, 0},
+    {70, false, 0}, {70, true, 0}, {80, false, 0}, {80, true, 0},
+    {90, false, 0}, {90, true, 0}, {96, false, 0}, {96, true, 0},
+    {100, false, 0}, {100, true, 0}, {120, false, 0}, {120, true, 0},
+    {128, false, 0}, {128, true, 0},
+    {24, true, 2}, {32, true, 2}, {70, true, 4}, {80, true, 4}, {128, true, 4},
+    {24, false, 2}, {32, false, 2}
+}};
+
+constexpr char32_t FIRST_PRINTABLE = U' ';
+constexpr char32_t LAST_PRINTABLE = U'~';
+constexpr std::size_t GLYPHS_PER_STYLE = LAST_PRINTABLE - FIRST_PRINTABLE + 1;
+constexpr std::size_t TOTAL_GLYPHS = PREWARM_STYLES.size() * GLYPHS_PER_STYLE;
+
+} // namespace
+
+
+void GlyphPrewarmer::start(const sf::Font& sharedFont) {
+    font = &sharedFont;
+    nextGlyph = 0;
+}
+
+void GlyphPrewarmer::step(std::chrono::microseconds budget) {
+    if (isFinished()) {
+        return;
+    }
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    do {
+        const GlyphStyle& style = PREWARM_STYLES[nextGlyph / GLYPHS_PER_STYLE];
+        char32_t codePoint = FIRST_PRINTABLE + static_cast<char32_t>(nextGlyph % GLYPHS_PER_STYLE);
+        font->getGlyph(codePoint, style.characterSize, style.bold, style.outlineThickness);
+        ++nextGlyph;
+    } while (nextGlyph < TOTAL_GLYPHS && std::chrono::steady_clock::now() < deadline);
+}
+
+bool GlyphPrewarmer::isFinished() const {
+    return font == nullptr || nextGlyph >= TOTAL_GLYPHS;
+}
+
+float GlyphPrewarmer::getProgress() const {
+    return font == nullptr ? 0.0f : static_cast<float>(nextGlyph) / static_cast<float>(TOTAL_GLYPHS);
+}
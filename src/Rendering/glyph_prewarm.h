@@ -0,0 +1,27 @@
+﻿#pragma once
+
+#include <SFML/Graphics/Font.hpp>
+#include <chrono>
+#include <cstddef>
+
+
+constexpr std::chrono::microseconds GLYPH_PREWARM_FRAME_BUDGET(1500);
+
+
+// Rasterizes the printable ASCII set at every size and style the menus and
+// HUD draw, a time-boxed slice per frame, so opening a screen for the first
+// time does not stall on glyph uploads. Glyph pages are GL textures and
+// sf::Font is not thread-safe, so this runs on the render thread rather than
+// a worker; started right after the font loads, it finishes during the splash.
+class GlyphPrewarmer {
+public:
+    void start(const sf::Font& font);
+    void step(std::chrono::microseconds budget);
+
+    bool isFinished() const;
+    float getProgress() const;
+
+private:
+    const sf::Font* font = nullptr;
+    std::size_t nextGlyph = 0;
+};
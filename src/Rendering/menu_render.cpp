@@ -3,11 +3,15 @@
 #include "piece_utils.h"
 #include "achievements.h"
 #include "game_ui.h"
+#include "mode_stats.h"
+#include "asset_pack.h"
 #include <algorithm>
 #include <iostream>
 #include <cstdlib>
 #include <cstdint>
 #include <cmath>
+#include <iomanip>
+#include <sstream>
 
 const std::string GAME_VERSION = "v0.3.0-beta.10";
 
@@ -57,7 +61,7 @@ void drawGameLogo(sf::RenderWindow& window, const sf::Font& titleFont, bool font
         static sf::Shader hueShader;
         static bool shaderLoaded = false;
         if (!shaderLoaded) {
-            if (hueShader.loadFromFile("Assets/Shaders/hue_shift.frag", sf::Shader::Type::Fragment)) {
+            if (loadFragmentShader(hueShader, "Assets/Shaders/hue_shift.frag")) {
                 shaderLoaded = true;
             }
         }
@@ -692,7 +696,7 @@ void drawMainMenu(sf::RenderWindow& window, const sf::Font& titleFont, const sf:
         static sf::Shader hueShader;
         static bool shaderLoaded = false;
         if (!shaderLoaded) {
-            if (hueShader.loadFromFile("Assets/Shaders/hue_shift.frag", sf::Shader::Type::Fragment)) {
+            if (loadFragmentShader(hueShader, "Assets/Shaders/hue_shift.frag")) {
                 shaderLoaded = true;
             } else {
             }
@@ -778,6 +782,30 @@ void drawMainMenu(sf::RenderWindow& window, const sf::Font& titleFont, const sf:
     }
 }
 
+bool loadFragmentShader(sf::Shader& shader, const std::string& path) {
+    AssetBlob packed = getAssetPack().find(path);
+    if (packed) {
+        return shader.loadFromMemory(std::string(static_cast<const char*>(packed.data), packed.size), sf::Shader::Type::Fragment);
+    }
+    return shader.loadFromFile(path, sf::Shader::Type::Fragment);
+}
+
+void drawProfileBadge(sf::RenderWindow& window, const sf::Font& menuFont, bool fontLoaded, const std::string& profileName, size_t profileCount, bool switching) {
+    if (!fontLoaded) return;
+
+    sf::Text nameText(menuFont, switching ? "Loading profile..." : "Profile: " + profileName);
+    nameText.setCharacterSize(28);
+    nameText.setFillColor(switching ? sf::Color(150, 150, 150) : sf::Color(100, 255, 150));
+    nameText.setPosition(sf::Vector2f(40.0f, 30.0f));
+    window.draw(nameText);
+
+    sf::Text hintText(menuFont, profileCount > 1 ? "TAB switch  |  CTRL+N new" : "CTRL+N new profile");
+    hintText.setCharacterSize(18);
+    hintText.setFillColor(sf::Color(150, 150, 150));
+    hintText.setPosition(sf::Vector2f(40.0f, 68.0f));
+    window.draw(hintText);
+}
+
 CardLayoutInfo getCardLayout(int numCards) {
     CardLayoutInfo layout;
     float centerX = SCREEN_WIDTH / 2.0f;
@@ -2240,7 +2268,7 @@ void drawAchievementsScreen(sf::RenderWindow& window, const sf::Font& titleFont,
     }
 }
 
-void drawStatisticsScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, bool debugMode) {
+void drawStatisticsScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, const GameHistory& history, bool debugMode) {
     float centerX = SCREEN_WIDTH / 2.0f;
     float centerY = SCREEN_HEIGHT / 2.0f;
     
@@ -2258,7 +2286,7 @@ void drawStatisticsScreen(sf::RenderWindow& window, const sf::Font& titleFont, c
         
 
         sf::RectangleShape panel;
-        panel.setSize(sf::Vector2f(1200, 700));
+        panel.setSize(sf::Vector2f(1200, 760));
         panel.setFillColor(sf::Color(30, 30, 40, 200));
         panel.setOutlineColor(sf::Color(100, 200, 255));
         panel.setOutlineThickness(3);
@@ -2356,11 +2384,116 @@ void drawStatisticsScreen(sf::RenderWindow& window, const sf::Font& titleFont, c
         }
         
 
+        // The trend follows whichever mode has the most recorded games; timed
+        // modes compare finish times, the rest compare scores.
+        const int trendWindow = 20;
+        int trendSlot = -1;
+        int trendGames = 0;
+        for (int slot = 0; slot < MODE_STATS_SLOTS; ++slot) {
+            GameModeOption mode;
+            int subMode;
+            if (!getModeStatsKey(slot, mode, subMode)) continue;
+            int games = history.countGames(mode, subMode);
+            if (games > trendGames) {
+                trendGames = games;
+                trendSlot = slot;
+            }
+        }
+        std::string historyLine = "Games Recorded: " + formatNumber(static_cast<int>(history.getRecordCount()));
+        sf::Color trendColor(200, 200, 200);
+        GameModeOption trendMode;
+        int trendSubMode;
+        if (trendGames >= trendWindow * 2 && getModeStatsKey(trendSlot, trendMode, trendSubMode)) {
+            std::string trendLabel = getModeStatsLabel(trendSlot);
+            if (isTimedMode(trendMode)) {
+                std::vector<const GameHistoryRecord*> newest;
+                history.queryRecent(trendMode, trendSubMode, trendWindow * 2, newest);
+                float windowTotals[2] = {0.0f, 0.0f};
+                int windowRuns[2] = {0, 0};
+                for (size_t i = 0; i < newest.size(); ++i) {
+                    if (!newest[i]->completed) continue;
+                    int half = i < static_cast<size_t>(trendWindow) ? 0 : 1;
+                    windowTotals[half] += newest[i]->timeSeconds;
+                    windowRuns[half]++;
+                }
+                if (windowRuns[0] > 0 && windowRuns[1] > 0) {
+                    float recent = windowTotals[0] / windowRuns[0];
+                    float previous = windowTotals[1] / windowRuns[1];
+                    int change = static_cast<int>(std::round((recent - previous) * 100.0f / previous));
+                    historyLine += "   |   " + trendLabel + " avg time (last " + std::to_string(trendWindow) + "): " + formatTime(recent)
+                        + " (" + (change >= 0 ? "+" : "") + std::to_string(change) + "%)";
+                    trendColor = change <= 0 ? sf::Color(100, 255, 100) : sf::Color(255, 120, 120);
+                }
+            } else {
+                float recent = history.getAverageScore(trendMode, trendSubMode, 0, trendWindow);
+                float previous = history.getAverageScore(trendMode, trendSubMode, trendWindow, trendWindow);
+                int change = previous > 0.0f ? static_cast<int>(std::round((recent - previous) * 100.0f / previous)) : 0;
+                historyLine += "   |   " + trendLabel + " avg (last " + std::to_string(trendWindow) + "): " + formatNumber(static_cast<int>(recent))
+                    + " (" + (change >= 0 ? "+" : "") + std::to_string(change) + "%)";
+                trendColor = change >= 0 ? sf::Color(100, 255, 100) : sf::Color(255, 120, 120);
+            }
+        }
+        sf::Text historyText(menuFont, historyLine);
+        historyText.setCharacterSize(28);
+        historyText.setFillColor(trendColor);
+        sf::FloatRect historyBounds = historyText.getLocalBounds();
+        historyText.setPosition(sf::Vector2f(centerX - historyBounds.size.x / 2, startY + col1Count * lineSpacing + 30));
+        window.draw(historyText);
+        
+
+        const int modeRowsShown = 4;
+        std::vector<int> playedSlots;
+        for (int slot = 0; slot < MODE_STATS_SLOTS; ++slot) {
+            if (saveData.modeStats[slot].gamesPlayed > 0) playedSlots.push_back(slot);
+        }
+        std::stable_sort(playedSlots.begin(), playedSlots.end(), [&saveData](int a, int b) {
+            return saveData.modeStats[a].gamesPlayed > saveData.modeStats[b].gamesPlayed;
+        });
+        if (static_cast<int>(playedSlots.size()) > modeRowsShown) playedSlots.resize(modeRowsShown);
+        
+        if (!playedSlots.empty()) {
+            const float columnX[7] = {centerX - 560, centerX - 230, centerX - 110, centerX + 40, centerX + 190, centerX + 320, centerX + 420};
+            auto drawRow = [&](float y, const std::string (&cells)[7], sf::Color color) {
+                for (int c = 0; c < 7; ++c) {
+                    sf::Text cellText(menuFont, cells[c]);
+                    cellText.setCharacterSize(24);
+                    cellText.setFillColor(color);
+                    cellText.setPosition(sf::Vector2f(columnX[c], y));
+                    window.draw(cellText);
+                }
+            };
+            auto formatRate = [](float value) {
+                std::ostringstream out;
+                out << std::fixed << std::setprecision(value < 10.0f ? 2 : 1) << value;
+                return out.str();
+            };
+            
+            float tableY = startY + col1Count * lineSpacing + 80;
+            const std::string header[7] = {"Mode", "Games", "Avg", "Recent", "Lines/min", "PPS", "Clears 1/2/3/4+"};
+            drawRow(tableY, header, sf::Color(150, 150, 170));
+            
+            for (size_t row = 0; row < playedSlots.size(); ++row) {
+                const ModeStats& stats = saveData.modeStats[playedSlots[row]];
+                int quadsAndUp = 0;
+                for (int c = 3; c < STATS_CLEAR_TYPES; ++c) quadsAndUp += stats.clearCounts[c];
+                const std::string cells[7] = {
+                    getModeStatsLabel(playedSlots[row]),
+                    formatNumber(stats.gamesPlayed),
+                    formatNumber(static_cast<int>(getModeAverageScore(stats))),
+                    formatNumber(static_cast<int>(stats.recentScore)),
+                    formatRate(getModeLinesPerMinute(stats)),
+                    formatRate(getModePiecesPerSecond(stats)),
+                    std::to_string(stats.clearCounts[0]) + "/" + std::to_string(stats.clearCounts[1]) + "/" +
+                        std::to_string(stats.clearCounts[2]) + "/" + std::to_string(quadsAndUp)
+                };
+                drawRow(tableY + 34 * (row + 1), cells, sf::Color(220, 220, 220));
+            }
+        }
     }
 }
 
 
-void drawBestScoresScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, bool debugMode) {
+void drawBestScoresScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, const GameHistory& history, bool debugMode) {
     if (!fontLoaded) return;
     
     float centerX = SCREEN_WIDTH / 2.0f;
@@ -2455,11 +2588,28 @@ void drawBestScoresScreen(sf::RenderWindow& window, const sf::Font& titleFont, c
     window.draw(sprintHeader);
     leftStartY += lineHeight + 10;
     
+    // History keeps every run, so its best time wins over the saved one
+    // whenever it is faster; the run count comes from the same index.
+    std::vector<const GameHistoryRecord*> bestRuns;
+    auto bestTime = [&](GameModeOption mode, int subMode, float savedBest) {
+        history.queryBestTimes(mode, subMode, 1, bestRuns);
+        if (!bestRuns.empty() && (savedBest <= 0.0f || bestRuns[0]->timeSeconds < savedBest)) {
+            return bestRuns[0]->timeSeconds;
+        }
+        return savedBest;
+    };
+    auto challengeTime = [&](ChallengeMode challenge, float savedBest) {
+        std::string text = formatTime(bestTime(GameModeOption::Challenge, static_cast<int>(challenge), savedBest));
+        int runs = history.countGames(GameModeOption::Challenge, static_cast<int>(challenge));
+        if (runs > 0) text += "  (" + std::to_string(runs) + " runs)";
+        return text;
+    };
+    
     entries = {
-        {"Sprint 1", formatTime(saveData.bestTimeSprint1), "", sf::Color(200, 255, 200)},
-        {"Sprint 24", formatTime(saveData.bestTimeSprint24), "", sf::Color(200, 255, 200)},
-        {"Sprint 48", formatTime(saveData.bestTimeSprint48), "", sf::Color(200, 255, 200)},
-        {"Sprint 96", formatTime(saveData.bestTimeSprint96), "", sf::Color(200, 255, 200)}
+        {"Sprint 1", formatTime(bestTime(GameModeOption::Sprint, 1, saveData.bestTimeSprint1)), "", sf::Color(200, 255, 200)},
+        {"Sprint 24", formatTime(bestTime(GameModeOption::Sprint, 24, saveData.bestTimeSprint24)), "", sf::Color(200, 255, 200)},
+        {"Sprint 48", formatTime(bestTime(GameModeOption::Sprint, 48, saveData.bestTimeSprint48)), "", sf::Color(200, 255, 200)},
+        {"Sprint 96", formatTime(bestTime(GameModeOption::Sprint, 96, saveData.bestTimeSprint96)), "", sf::Color(200, 255, 200)}
     };
     
     for (const auto& entry : entries) {
@@ -2480,6 +2630,36 @@ void drawBestScoresScreen(sf::RenderWindow& window, const sf::Font& titleFont, c
     }
     
 
+    std::vector<const GameHistoryRecord*> topGames;
+    history.queryTopScores(GameModeOption::Classic, static_cast<int>(ClassicDifficulty::Normal), 5, topGames);
+    if (!topGames.empty()) {
+        leftStartY += 20;
+        sf::Text historyHeader(menuFont, "=== CLASSIC TOP 5 ===");
+        historyHeader.setCharacterSize(48);
+        historyHeader.setFillColor(sf::Color(100, 200, 255));
+        historyHeader.setStyle(sf::Text::Bold);
+        historyHeader.setPosition(sf::Vector2f(leftX, leftStartY));
+        window.draw(historyHeader);
+        leftStartY += lineHeight + 10;
+        
+        for (size_t i = 0; i < topGames.size(); ++i) {
+            sf::Text rankText(menuFont, std::to_string(i + 1) + ".");
+            rankText.setCharacterSize(32);
+            rankText.setFillColor(sf::Color::White);
+            rankText.setPosition(sf::Vector2f(leftX + 30, leftStartY));
+            window.draw(rankText);
+            
+            sf::Text scoreText(menuFont, formatScore(topGames[i]->score) + " (Lv " + std::to_string(topGames[i]->level) + ", " + std::to_string(topGames[i]->lines) + " lines)");
+            scoreText.setCharacterSize(32);
+            scoreText.setFillColor(sf::Color(150, 255, 150));
+            scoreText.setPosition(sf::Vector2f(leftX + 90, leftStartY));
+            window.draw(scoreText);
+            
+            leftStartY += lineHeight - 5;
+        }
+    }
+    
+
     sf::Text challengeHeader(menuFont, "=== CHALLENGES ===");
     challengeHeader.setCharacterSize(48);
     challengeHeader.setFillColor(sf::Color(255, 200, 100));
@@ -2489,15 +2669,15 @@ void drawBestScoresScreen(sf::RenderWindow& window, const sf::Font& titleFont, c
     rightStartY += lineHeight + 10;
     
     entries = {
-        {"The Forest", formatTime(saveData.bestTimeChallengeTheForest), "", sf::Color(150, 255, 150)},
-        {"Randomness", formatTime(saveData.bestTimeChallengeRandomness), "", sf::Color(150, 255, 150)},
-        {"Non-Straight", formatTime(saveData.bestTimeChallengeNonStraight), "", sf::Color(150, 255, 150)},
-        {"One Rotation", formatTime(saveData.bestTimeChallengeOneRot), "", sf::Color(150, 255, 150)},
-        {"The Curse", formatTime(saveData.bestTimeChallengeChristopherCurse), "", sf::Color(150, 255, 150)},
-        {"Vanishing", formatTime(saveData.bestTimeChallengeVanishing), "", sf::Color(150, 255, 150)},
-        {"Auto Drop", formatTime(saveData.bestTimeChallengeAutoDrop), "", sf::Color(150, 255, 150)},
-        {"Gravity Flip", formatTime(saveData.bestTimeChallengeGravityFlip), "", sf::Color(150, 255, 150)},
-        {"Petrify", formatTime(saveData.bestTimeChallengePetrify), "", sf::Color(150, 255, 150)}
+        {"The Forest", challengeTime(ChallengeMode::TheForest, saveData.bestTimeChallengeTheForest), "", sf::Color(150, 255, 150)},
+        {"Randomness", challengeTime(ChallengeMode::Randomness, saveData.bestTimeChallengeRandomness), "", sf::Color(150, 255, 150)},
+        {"Non-Straight", challengeTime(ChallengeMode::NonStraight, saveData.bestTimeChallengeNonStraight), "", sf::Color(150, 255, 150)},
+        {"One Rotation", challengeTime(ChallengeMode::OneRot, saveData.bestTimeChallengeOneRot), "", sf::Color(150, 255, 150)},
+        {"The Curse", challengeTime(ChallengeMode::ChristopherCurse, saveData.bestTimeChallengeChristopherCurse), "", sf::Color(150, 255, 150)},
+        {"Vanishing", challengeTime(ChallengeMode::Vanishing, saveData.bestTimeChallengeVanishing), "", sf::Color(150, 255, 150)},
+        {"Auto Drop", challengeTime(ChallengeMode::AutoDrop, saveData.bestTimeChallengeAutoDrop), "", sf::Color(150, 255, 150)},
+        {"Gravity Flip", challengeTime(ChallengeMode::GravityFlip, saveData.bestTimeChallengeGravityFlip), "", sf::Color(150, 255, 150)},
+        {"Petrify", challengeTime(ChallengeMode::Petrify, saveData.bestTimeChallengePetrify), "", sf::Color(150, 255, 150)}
     };
     
     for (const auto& entry : entries) {
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "types.h"
+#include "game_history.h"
 #include <SFML/Graphics.hpp>
 #include <map>
 #include <vector>
@@ -10,6 +11,8 @@
 constexpr float SCREEN_WIDTH = 1920.0f;
 constexpr float SCREEN_HEIGHT = 1080.0f;
 
+bool loadFragmentShader(sf::Shader& shader, const std::string& path);
+
 void drawGameOver(sf::RenderWindow& window, int finalScore, int finalLines, int finalLevel, const std::map<TextureType, sf::Texture>& textures, bool useTextures, const sf::Font& font, bool fontLoaded, const SaveData& saveData, int hardDropScore, int lineScore, int comboScore, ClassicDifficulty difficulty, bool isSprintMode, float sprintTime, int sprintTarget, bool sprintCompleted, bool isChallengeMode, bool isPracticeMode = false, float uiAlpha = 1.0f, sf::Color frameColor = sf::Color::White, float statsRevealTime = 0.0f, bool isNewHighScore = false, int previousHighScore = 0, sf::Color backgroundColor = sf::Color::Black);
 void drawTesseraTitle(sf::RenderWindow& window, const sf::Font& font, bool fontLoaded);
 void drawPauseMenu(sf::RenderWindow& window, const sf::Font& menuFont, bool fontLoaded, PauseOption selectedOption, const sf::Color& frameColor = sf::Color(100, 150, 255), const sf::Color& backgroundColor = sf::Color(10, 15, 31));
@@ -39,6 +42,7 @@ CardLayoutInfo getCardLayout(int numCards);
 int getCardIndexAtPosition(float mouseX, float mouseY, int numCards);
 
 void drawMainMenu(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, MenuOption selectedOption, bool debugMode, const std::map<TextureType, sf::Texture>& textures, bool useTextures, float elapsedTime = 0.0f);
+void drawProfileBadge(sf::RenderWindow& window, const sf::Font& menuFont, bool fontLoaded, const std::string& profileName, size_t profileCount, bool switching);
 void drawCardSelectionScreen(sf::RenderWindow& window, const sf::Font& menuFont, bool fontLoaded, const std::vector<CardData>& cards, int selectedCard, bool isBackHovered, const std::map<TextureType, sf::Texture>& textures, bool useTextures);
 void drawModeSelectionScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, int selectedCard, bool isBackHovered, const std::map<TextureType, sf::Texture>& textures, bool useTextures);
 void drawExtrasSelectionScreen(sf::RenderWindow& window, const sf::Font& menuFont, bool fontLoaded, int selectedCard, bool isBackHovered, const std::map<TextureType, sf::Texture>& textures, bool useTextures);
@@ -50,8 +54,8 @@ void drawChallengeMenu(sf::RenderWindow& window, const sf::Font& titleFont, cons
 void drawPracticeMenu(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, PracticeDifficulty selectedDifficulty, PracticeLineGoal selectedLineGoal, bool infiniteBombs, PracticeStartLevel selectedStartLevel, int selectedOption, const std::map<TextureType, sf::Texture>& textures, bool useTextures, bool debugMode = false);
 void drawExtrasMenu(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, ExtrasOption selectedOption, const std::map<TextureType, sf::Texture>& textures, bool useTextures, float elapsedTime, bool debugMode = false);
 void drawAchievementsScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, int hoveredAchievement, bool debugMode = false);
-void drawStatisticsScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, bool debugMode = false);
-void drawBestScoresScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, bool debugMode = false);
+void drawStatisticsScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, const GameHistory& history, bool debugMode = false);
+void drawBestScoresScreen(sf::RenderWindow& window, const sf::Font& titleFont, const sf::Font& menuFont, bool fontLoaded, const SaveData& saveData, const GameHistory& history, bool debugMode = false);
 void drawOptionsMenu(sf::RenderWindow& window, const sf::Font& menuFont, bool fontLoaded, bool debugMode, OptionsMenuOption selectedOption, const std::map<TextureType, sf::Texture>& textures, bool useTextures, float elapsedTime);
 void drawAudioMenu(sf::RenderWindow& window, const sf::Font& menuFont, bool fontLoaded, bool debugMode, AudioOption selectedOption, float mainVolume, float musicVolume, float sfxVolume, const std::map<TextureType, sf::Texture>& textures, bool useTextures, float elapsedTime);
 void drawCustomizationMenu(sf::RenderWindow& window, const sf::Font& menuFont, bool fontLoaded, GameThemeChoice hoveredTheme, GameThemeChoice selectedTheme, const std::map<TextureType, sf::Texture>& textures, bool useTextures, float elapsedTime);
@@ -0,0 +1,427 @@
+﻿#include "sim_batch.h"
+#include <algorithm>
+#include <cstring>
+
+static_assert(TESSERA_SIM_WIDTH == GRID_WIDTH, "TESSERA_SIM_WIDTH must match GRID_WIDTH");
+static_assert(TESSERA_SIM_HEIGHT == GRID_HEIGHT, "TESSERA_SIM_HEIGHT must match GRID_HEIGHT");
+static_assert(TESSERA_SIM_ROTATIONS == PIECE_ROTATIONS, "TESSERA_SIM_ROTATIONS must match PIECE_ROTATIONS");
+
+
+
+
+namespace {
+    constexpr int CELLS_PER_ENV = GRID_WIDTH * GRID_HEIGHT;
+    constexpr int BAG_SEQUENCE = SIM_BAG_SIZE * 2;
+    constexpr int MIN_ENVS_PER_SHARD = 64;
+    constexpr float TOP_OUT_REWARD = -1.0f;
+
+    std::uint64_t splitMix64(std::uint64_t& state) {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    std::uint64_t nextRandom(std::uint64_t& state) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    PieceType toPieceType(std::uint8_t piece) {
+        return static_cast<PieceType>(piece);
+    }
+
+    int spawnRow(std::uint8_t piece, bool gravityFlip) {
+        const PieceMask& spawnMask = getPieceMask(toPieceType(piece), 0);
+        if (gravityFlip) return GRID_HEIGHT / 2 - spawnMask.height / 2;
+        return -spawnMask.minRow;
+    }
+
+    bool maskCollidesWithCeiling(const std::uint16_t* board, const PieceMask& mask, int x, int y) {
+        if (x + mask.minCol < 0 || x + mask.maxCol >= GRID_WIDTH) return true;
+        for (int i = mask.minRow; i <= mask.maxRow; ++i) {
+            int gy = y + i;
+            if (gy < 0 || gy >= GRID_HEIGHT) return true;
+            if (board[gy] & shiftMaskRow(mask.rows[i], x)) return true;
+        }
+        return false;
+    }
+
+    bool maskCollidesRows(const std::uint16_t* board, const PieceMask& mask, int x, int y) {
+        if (x + mask.minCol < 0 || x + mask.maxCol >= GRID_WIDTH) return true;
+        for (int i = mask.minRow; i <= mask.maxRow; ++i) {
+            int gy = y + i;
+            if (gy >= GRID_HEIGHT) return true;
+            if (gy < 0) continue;
+            if (board[gy] & shiftMaskRow(mask.rows[i], x)) return true;
+        }
+        return false;
+    }
+
+    std::uint8_t resolvePlayedPiece(std::uint8_t current, std::uint8_t hold, std::uint8_t nextPiece, bool useHold) {
+        if (!useHold) return current;
+        return hold == TESSERA_SIM_NO_PIECE ? nextPiece : hold;
+    }
+}
+
+
+SimBatch::SimBatch(const TesseraSimConfig& config)
+    : envCount(static_cast<int>(config.envCount)),
+      autoReset(config.autoReset != 0),
+      baseSeed(config.seed) {
+    rows.assign(static_cast<size_t>(envCount) * GRID_HEIGHT, 0);
+    cellStamps.assign(static_cast<size_t>(envCount) * CELLS_PER_ENV, 0);
+    std::uint8_t mode = config.mode;
+    if (mode > TESSERA_SIM_MODE_GRAVITY_FLIP) mode = TESSERA_SIM_MODE_NORMAL;
+    modes.assign(envCount, mode);
+    currentPiece.assign(envCount, 0);
+    holdPiece.assign(envCount, TESSERA_SIM_NO_PIECE);
+    gravityFlipped.assign(envCount, 0);
+    finished.assign(envCount, 0);
+    bagSequence.assign(static_cast<size_t>(envCount) * BAG_SEQUENCE, 0);
+    bagPosition.assign(envCount, 0);
+    rngState.assign(envCount, 0);
+    episodeCount.assign(envCount, 0);
+    piecesPlaced.assign(envCount, 0);
+    linesCleared.assign(envCount, 0);
+    combo.assign(envCount, 0);
+
+    int threadCount = static_cast<int>(config.threadCount);
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    threadCount = std::min(threadCount, std::max(1, envCount / MIN_ENVS_PER_SHARD));
+    workerCount = threadCount - 1;
+    workers.reserve(workerCount);
+    for (int i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&SimBatch::workerLoop, this, i);
+    }
+
+    for (int env = 0; env < envCount; ++env) {
+        resetEnv(env);
+    }
+}
+
+SimBatch::~SimBatch() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        poolStopping = true;
+    }
+    poolWake.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+bool SimBatch::setEnvMode(int env, std::uint8_t mode) {
+    if (env < 0 || env >= envCount || mode > TESSERA_SIM_MODE_GRAVITY_FLIP) return false;
+    modes[env] = mode;
+    resetEnv(env);
+    return true;
+}
+
+void SimBatch::resetEnv(int env) {
+    std::uint64_t seedState = baseSeed ^ (static_cast<std::uint64_t>(env) << 32) ^ episodeCount[env];
+    rngState[env] = splitMix64(seedState) | 1ull;
+    ++episodeCount[env];
+
+    std::fill_n(rows.begin() + static_cast<size_t>(env) * GRID_HEIGHT, GRID_HEIGHT, 0);
+    if (modes[env] == TESSERA_SIM_MODE_VANISHING || modes[env] == TESSERA_SIM_MODE_PETRIFY) {
+        std::fill_n(cellStamps.begin() + static_cast<size_t>(env) * CELLS_PER_ENV, CELLS_PER_ENV, 0);
+    }
+    holdPiece[env] = TESSERA_SIM_NO_PIECE;
+    gravityFlipped[env] = 0;
+    finished[env] = 0;
+    piecesPlaced[env] = 0;
+    linesCleared[env] = 0;
+    combo[env] = 0;
+
+    refillBag(env, 0);
+    refillBag(env, SIM_BAG_SIZE);
+    bagPosition[env] = 0;
+    currentPiece[env] = takeNextPiece(env);
+}
+
+void SimBatch::refillBag(int env, int offset) {
+    std::uint8_t* bag = &bagSequence[static_cast<size_t>(env) * BAG_SEQUENCE + offset];
+    for (int i = 0; i < SIM_BAG_SIZE; ++i) {
+        bag[i] = static_cast<std::uint8_t>(i);
+    }
+    for (int i = SIM_BAG_SIZE - 1; i > 0; --i) {
+        int j = static_cast<int>(nextRandom(rngState[env]) % static_cast<std::uint64_t>(i + 1));
+        std::swap(bag[i], bag[j]);
+    }
+}
+
+std::uint8_t SimBatch::takeNextPiece(int env) {
+    std::uint8_t* sequence = &bagSequence[static_cast<size_t>(env) * BAG_SEQUENCE];
+    std::uint8_t piece = sequence[bagPosition[env]];
+    if (++bagPosition[env] == SIM_BAG_SIZE) {
+        std::memcpy(sequence, sequence + SIM_BAG_SIZE, SIM_BAG_SIZE);
+        refillBag(env, SIM_BAG_SIZE);
+        bagPosition[env] = 0;
+    }
+    return piece;
+}
+
+bool SimBatch::actionValid(int env, std::uint8_t action) const {
+    if (finished[env] || action >= TESSERA_SIM_ACTION_COUNT) return false;
+
+    bool useHold = action >= TESSERA_SIM_PLACE_ACTIONS;
+    int placeAction = action % TESSERA_SIM_PLACE_ACTIONS;
+    int rotation = placeAction / GRID_WIDTH;
+    int column = placeAction % GRID_WIDTH;
+
+    const std::uint8_t* sequence = &bagSequence[static_cast<size_t>(env) * BAG_SEQUENCE];
+    std::uint8_t piece = resolvePlayedPiece(currentPiece[env], holdPiece[env], sequence[bagPosition[env]], useHold);
+    const PieceMask& mask = getPieceMask(toPieceType(piece), rotation);
+    int x = column - mask.minCol;
+    bool gravityFlip = modes[env] == TESSERA_SIM_MODE_GRAVITY_FLIP;
+    const std::uint16_t* board = &rows[static_cast<size_t>(env) * GRID_HEIGHT];
+    return !maskCollidesRows(board, mask, x, spawnRow(piece, gravityFlip));
+}
+
+int SimBatch::clearRows(int env) {
+    std::uint16_t* board = &rows[static_cast<size_t>(env) * GRID_HEIGHT];
+    std::uint32_t* stamps = &cellStamps[static_cast<size_t>(env) * CELLS_PER_ENV];
+    std::uint32_t locks = piecesPlaced[env];
+    bool petrify = modes[env] == TESSERA_SIM_MODE_PETRIFY;
+
+    bool clears[GRID_HEIGHT] = {};
+    int cleared = 0;
+    for (int row = 0; row < GRID_HEIGHT; ++row) {
+        if (board[row] != FULL_ROW_MASK) continue;
+        if (petrify) {
+            bool hasStone = false;
+            for (int col = 0; col < GRID_WIDTH && !hasStone; ++col) {
+                hasStone = locks - stamps[row * GRID_WIDTH + col] + 1 >= SIM_PETRIFY_LOCKS;
+            }
+            if (hasStone) continue;
+        }
+        clears[row] = true;
+        ++cleared;
+    }
+    if (cleared == 0) return 0;
+
+    auto compactDown = [&](int top, int bottom) {
+        int write = bottom;
+        for (int read = bottom; read >= top; --read) {
+            if (clears[read]) continue;
+            if (write != read) {
+                board[write] = board[read];
+                std::memcpy(&stamps[write * GRID_WIDTH], &stamps[read * GRID_WIDTH], GRID_WIDTH * sizeof(std::uint32_t));
+            }
+            --write;
+        }
+        for (; write >= top; --write) {
+            board[write] = 0;
+            std::memset(&stamps[write * GRID_WIDTH], 0, GRID_WIDTH * sizeof(std::uint32_t));
+        }
+    };
+    auto compactUp = [&](int top, int bottom) {
+        int write = top;
+        for (int read = top; read <= bottom; ++read) {
+            if (clears[read]) continue;
+            if (write != read) {
+                board[write] = board[read];
+                std::memcpy(&stamps[write * GRID_WIDTH], &stamps[read * GRID_WIDTH], GRID_WIDTH * sizeof(std::uint32_t));
+            }
+            ++write;
+        }
+        for (; write <= bottom; ++write) {
+            board[write] = 0;
+            std::memset(&stamps[write * GRID_WIDTH], 0, GRID_WIDTH * sizeof(std::uint32_t));
+        }
+    };
+
+    if (modes[env] == TESSERA_SIM_MODE_GRAVITY_FLIP) {
+        int midPoint = GRID_HEIGHT / 2;
+        compactDown(midPoint, GRID_HEIGHT - 1);
+        compactUp(0, midPoint - 1);
+    } else {
+        compactDown(0, GRID_HEIGHT - 1);
+    }
+    return cleared;
+}
+
+float SimBatch::stepEnv(int env, std::uint8_t action, bool& done) {
+    if (finished[env]) {
+        done = true;
+        return 0.0f;
+    }
+    if (!actionValid(env, action)) {
+        finished[env] = 1;
+        done = true;
+        return TOP_OUT_REWARD;
+    }
+
+    bool useHold = action >= TESSERA_SIM_PLACE_ACTIONS;
+    int placeAction = action % TESSERA_SIM_PLACE_ACTIONS;
+    int rotation = placeAction / GRID_WIDTH;
+    int column = placeAction % GRID_WIDTH;
+
+    if (useHold) {
+        std::uint8_t held = holdPiece[env];
+        holdPiece[env] = currentPiece[env];
+        currentPiece[env] = held == TESSERA_SIM_NO_PIECE ? takeNextPiece(env) : held;
+    }
+
+    std::uint8_t piece = currentPiece[env];
+    const PieceMask& mask = getPieceMask(toPieceType(piece), rotation);
+    std::uint16_t* board = &rows[static_cast<size_t>(env) * GRID_HEIGHT];
+    bool gravityFlip = modes[env] == TESSERA_SIM_MODE_GRAVITY_FLIP;
+    int x = column - mask.minCol;
+    int y = spawnRow(piece, gravityFlip);
+
+    if (gravityFlip && gravityFlipped[env]) {
+        while (!maskCollidesWithCeiling(board, mask, x, y - 1)) --y;
+    } else {
+        while (!maskCollidesRows(board, mask, x, y + 1)) ++y;
+    }
+
+    if (y + mask.minRow < 0) {
+        finished[env] = 1;
+        done = true;
+        return TOP_OUT_REWARD;
+    }
+
+    std::uint32_t lockNumber = ++piecesPlaced[env];
+    bool stamped = modes[env] == TESSERA_SIM_MODE_VANISHING || modes[env] == TESSERA_SIM_MODE_PETRIFY;
+    std::uint32_t* stamps = &cellStamps[static_cast<size_t>(env) * CELLS_PER_ENV];
+    for (int i = mask.minRow; i <= mask.maxRow; ++i) {
+        std::uint16_t shifted = shiftMaskRow(mask.rows[i], x);
+        int gy = y + i;
+        board[gy] |= shifted;
+        if (!stamped) continue;
+        for (int col = x + mask.minCol; col <= x + mask.maxCol; ++col) {
+            if (shifted & (1u << col)) stamps[gy * GRID_WIDTH + col] = lockNumber;
+        }
+    }
+
+    int cleared = clearRows(env);
+    linesCleared[env] += static_cast<std::uint32_t>(cleared);
+    combo[env] = cleared > 0 ? static_cast<std::uint16_t>(combo[env] + 1) : 0;
+
+    currentPiece[env] = takeNextPiece(env);
+    if (gravityFlip) {
+        gravityFlipped[env] = gravityFlipped[env] ? 0 : 1;
+    }
+
+    const PieceMask& nextMask = getPieceMask(toPieceType(currentPiece[env]), 0);
+    bool toppedOut = maskCollidesRows(board, nextMask, getSpawnX(toPieceType(currentPiece[env])), spawnRow(currentPiece[env], gravityFlip));
+    if (toppedOut) {
+        finished[env] = 1;
+        done = true;
+        return static_cast<float>(cleared) + TOP_OUT_REWARD;
+    }
+
+    done = false;
+    return static_cast<float>(cleared);
+}
+
+void SimBatch::writeObservation(int env, TesseraObservation& observation) const {
+    const std::uint16_t* board = &rows[static_cast<size_t>(env) * GRID_HEIGHT];
+    if (modes[env] == TESSERA_SIM_MODE_VANISHING) {
+        const std::uint32_t* stamps = &cellStamps[static_cast<size_t>(env) * CELLS_PER_ENV];
+        std::uint32_t locks = piecesPlaced[env];
+        for (int row = 0; row < GRID_HEIGHT; ++row) {
+            std::uint32_t visible = 0;
+            if (board[row]) {
+                const std::uint32_t* rowStamps = &stamps[row * GRID_WIDTH];
+                for (int col = 0; col < GRID_WIDTH; ++col) {
+                    visible |= static_cast<std::uint32_t>(locks - rowStamps[col] < SIM_VANISH_LOCKS) << col;
+                }
+            }
+            observation.rows[row] = static_cast<std::uint16_t>(board[row] & visible);
+        }
+    } else {
+        std::memcpy(observation.rows, board, sizeof(observation.rows));
+    }
+
+    const std::uint8_t* sequence = &bagSequence[static_cast<size_t>(env) * BAG_SEQUENCE];
+    observation.current = currentPiece[env];
+    observation.hold = holdPiece[env];
+    for (int i = 0; i < TESSERA_SIM_QUEUE; ++i) {
+        observation.queue[i] = sequence[bagPosition[env] + i];
+    }
+    observation.gravityFlipped = gravityFlipped[env];
+    observation.combo = combo[env];
+    observation.piecesPlaced = piecesPlaced[env];
+    observation.linesCleared = linesCleared[env];
+}
+
+void SimBatch::resetAll(TesseraObservation* observations) {
+    runSharded([this, observations](int begin, int end) {
+        for (int env = begin; env < end; ++env) {
+            resetEnv(env);
+            if (observations) writeObservation(env, observations[env]);
+        }
+    });
+}
+
+void SimBatch::step(const std::uint8_t* actions, TesseraObservation* observations, float* rewards, std::uint8_t* dones) {
+    runSharded([this, actions, observations, rewards, dones](int begin, int end) {
+        for (int env = begin; env < end; ++env) {
+            bool done = false;
+            float reward = stepEnv(env, actions[env], done);
+            if (done && autoReset) resetEnv(env);
+            if (rewards) rewards[env] = reward;
+            if (dones) dones[env] = done ? 1 : 0;
+            if (observations) writeObservation(env, observations[env]);
+        }
+    });
+}
+
+void SimBatch::writeActionMasks(std::uint8_t* masks) const {
+    for (int env = 0; env < envCount; ++env) {
+        std::uint8_t* envMask = masks + static_cast<size_t>(env) * TESSERA_SIM_ACTION_COUNT;
+        for (int action = 0; action < TESSERA_SIM_ACTION_COUNT; ++action) {
+            envMask[action] = actionValid(env, static_cast<std::uint8_t>(action)) ? 1 : 0;
+        }
+    }
+}
+
+void SimBatch::workerLoop(int workerIndex) {
+    std::uint64_t seenGeneration = 0;
+    int shardCount = workerCount + 1;
+    while (true) {
+        const std::function<void(int, int)>* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            poolWake.wait(lock, [&] { return poolStopping || poolGeneration != seenGeneration; });
+            if (poolStopping) return;
+            seenGeneration = poolGeneration;
+            task = poolTask;
+        }
+
+        int begin = static_cast<int>(static_cast<long long>(envCount) * workerIndex / shardCount);
+        int end = static_cast<int>(static_cast<long long>(envCount) * (workerIndex + 1) / shardCount);
+        (*task)(begin, end);
+
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (--poolPending == 0) poolDone.notify_one();
+    }
+}
+
+void SimBatch::runSharded(const std::function<void(int, int)>& task) {
+    if (workerCount == 0) {
+        task(0, envCount);
+        return;
+    }
+
+    int shardCount = workerCount + 1;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        poolTask = &task;
+        poolPending = workerCount;
+        ++poolGeneration;
+    }
+    poolWake.notify_all();
+
+    task(0, static_cast<int>(static_cast<long long>(envCount) / shardCount));
+
+    std::unique_lock<std::mutex> lock(poolMutex);
+    poolDone.wait(lock, [&] { return poolPending == 0; });
+}
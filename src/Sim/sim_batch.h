@@ -0,0 +1,81 @@
+﻿#ifndef SIM_BATCH_H
+#define SIM_BATCH_H
+
+#include "tessera_sim.h"
+#include "piece_mask.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+
+constexpr int SIM_BAG_SIZE = 7;
+constexpr int SIM_PETRIFY_LOCKS = 12;
+constexpr int SIM_VANISH_LOCKS = 8;
+
+
+// Every environment is a slice of the same flat arrays so a worker walks
+// contiguous memory for its shard; cell stamps record the lock number that
+// placed each cell and drive both Petrify and Vanishing.
+class SimBatch {
+public:
+    explicit SimBatch(const TesseraSimConfig& config);
+    ~SimBatch();
+
+    SimBatch(const SimBatch&) = delete;
+    SimBatch& operator=(const SimBatch&) = delete;
+
+    int getEnvCount() const { return envCount; }
+    bool setEnvMode(int env, std::uint8_t mode);
+
+    void resetAll(TesseraObservation* observations);
+    void step(const std::uint8_t* actions, TesseraObservation* observations, float* rewards, std::uint8_t* dones);
+    void writeActionMasks(std::uint8_t* masks) const;
+
+private:
+    int envCount = 0;
+    bool autoReset = true;
+    std::uint64_t baseSeed = 0;
+
+    std::vector<std::uint16_t> rows;
+    std::vector<std::uint32_t> cellStamps;
+    std::vector<std::uint8_t> modes;
+    std::vector<std::uint8_t> currentPiece;
+    std::vector<std::uint8_t> holdPiece;
+    std::vector<std::uint8_t> gravityFlipped;
+    std::vector<std::uint8_t> finished;
+    std::vector<std::uint8_t> bagSequence;
+    std::vector<std::uint8_t> bagPosition;
+    std::vector<std::uint64_t> rngState;
+    std::vector<std::uint32_t> episodeCount;
+    std::vector<std::uint32_t> piecesPlaced;
+    std::vector<std::uint32_t> linesCleared;
+    std::vector<std::uint16_t> combo;
+
+    int workerCount = 0;
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable poolWake;
+    std::condition_variable poolDone;
+    const std::function<void(int, int)>* poolTask = nullptr;
+    std::uint64_t poolGeneration = 0;
+    int poolPending = 0;
+    bool poolStopping = false;
+
+    void resetEnv(int env);
+    void refillBag(int env, int offset);
+    std::uint8_t takeNextPiece(int env);
+    float stepEnv(int env, std::uint8_t action, bool& done);
+    int clearRows(int env);
+    bool actionValid(int env, std::uint8_t action) const;
+    void writeObservation(int env, TesseraObservation& observation) const;
+
+    void workerLoop(int workerIndex);
+    void runSharded(const std::function<void(int, int)>& task);
+};
+
+#endif
@@ -0,0 +1,69 @@
+﻿#include "tessera_sim.h"
+#include "sim_batch.h"
+#include <iostream>
+#include <exception>
+
+
+
+
+struct TesseraSim {
+    explicit TesseraSim(const TesseraSimConfig& config) : batch(config) {}
+    SimBatch batch;
+};
+
+
+extern "C" {
+
+TESSERA_SIM_API TesseraSim* tessera_sim_create(const TesseraSimConfig* config) {
+    if (!config || config->envCount == 0) {
+        std::cout << "[SIM] Refusing to create a batch without environments" << std::endl;
+        return nullptr;
+    }
+    try {
+        return new TesseraSim(*config);
+    } catch (const std::exception& e) {
+        std::cout << "[SIM] Failed to create batch: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+TESSERA_SIM_API void tessera_sim_destroy(TesseraSim* sim) {
+    delete sim;
+}
+
+TESSERA_SIM_API uint32_t tessera_sim_env_count(const TesseraSim* sim) {
+    return sim ? static_cast<uint32_t>(sim->batch.getEnvCount()) : 0;
+}
+
+TESSERA_SIM_API int tessera_sim_set_env_mode(TesseraSim* sim, uint32_t env, uint8_t mode) {
+    if (!sim) return 0;
+    return sim->batch.setEnvMode(static_cast<int>(env), mode) ? 1 : 0;
+}
+
+TESSERA_SIM_API void tessera_sim_reset(TesseraSim* sim, TesseraObservation* observations) {
+    if (!sim) return;
+    sim->batch.resetAll(observations);
+}
+
+TESSERA_SIM_API int tessera_sim_step(
+    TesseraSim* sim,
+    const uint8_t* actions,
+    TesseraObservation* observations,
+    float* rewards,
+    uint8_t* dones
+) {
+    if (!sim || !actions) return 0;
+    sim->batch.step(actions, observations, rewards, dones);
+    return 1;
+}
+
+TESSERA_SIM_API void tessera_sim_action_masks(const TesseraSim* sim, uint8_t* masks) {
+    if (!sim || !masks) return;
+    sim->batch.writeActionMasks(masks);
+}
+
+TESSERA_SIM_API int tessera_sim_version(void) {
+    return TESSERA_SIM_VERSION;
+}
+
+}
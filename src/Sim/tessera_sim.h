@@ -0,0 +1,87 @@
+﻿#ifndef TESSERA_SIM_H
+#define TESSERA_SIM_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(TESSERA_SIM_BUILD)
+        #define TESSERA_SIM_API __declspec(dllexport)
+    #else
+        #define TESSERA_SIM_API __declspec(dllimport)
+    #endif
+#else
+    #define TESSERA_SIM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define TESSERA_SIM_VERSION 1
+#define TESSERA_SIM_WIDTH 11
+#define TESSERA_SIM_HEIGHT 22
+#define TESSERA_SIM_QUEUE 3
+#define TESSERA_SIM_ROTATIONS 4
+#define TESSERA_SIM_PLACE_ACTIONS (TESSERA_SIM_ROTATIONS * TESSERA_SIM_WIDTH)
+#define TESSERA_SIM_ACTION_COUNT (2 * TESSERA_SIM_PLACE_ACTIONS)
+#define TESSERA_SIM_NO_PIECE 255
+
+
+/* Action layout: hold * PLACE_ACTIONS + rotation * WIDTH + column, where
+   column is the leftmost filled column of the rotated piece. The piece is
+   rotated at the spawn row and hard dropped; kicks and tucks are not
+   simulated. An action whose spawn position collides ends the episode. */
+
+typedef enum TesseraSimMode {
+    TESSERA_SIM_MODE_NORMAL = 0,
+    TESSERA_SIM_MODE_VANISHING = 1,
+    TESSERA_SIM_MODE_PETRIFY = 2,
+    TESSERA_SIM_MODE_GRAVITY_FLIP = 3
+} TesseraSimMode;
+
+typedef struct TesseraSimConfig {
+    uint32_t envCount;
+    uint32_t threadCount;
+    uint64_t seed;
+    uint8_t mode;
+    uint8_t autoReset;
+} TesseraSimConfig;
+
+typedef struct TesseraObservation {
+    uint16_t rows[TESSERA_SIM_HEIGHT];
+    uint8_t current;
+    uint8_t hold;
+    uint8_t queue[TESSERA_SIM_QUEUE];
+    uint8_t gravityFlipped;
+    uint16_t combo;
+    uint32_t piecesPlaced;
+    uint32_t linesCleared;
+} TesseraObservation;
+
+typedef struct TesseraSim TesseraSim;
+
+
+TESSERA_SIM_API TesseraSim* tessera_sim_create(const TesseraSimConfig* config);
+TESSERA_SIM_API void tessera_sim_destroy(TesseraSim* sim);
+
+TESSERA_SIM_API uint32_t tessera_sim_env_count(const TesseraSim* sim);
+TESSERA_SIM_API int tessera_sim_set_env_mode(TesseraSim* sim, uint32_t env, uint8_t mode);
+
+TESSERA_SIM_API void tessera_sim_reset(TesseraSim* sim, TesseraObservation* observations);
+TESSERA_SIM_API int tessera_sim_step(
+    TesseraSim* sim,
+    const uint8_t* actions,
+    TesseraObservation* observations,
+    float* rewards,
+    uint8_t* dones
+);
+TESSERA_SIM_API void tessera_sim_action_masks(const TesseraSim* sim, uint8_t* masks);
+
+TESSERA_SIM_API int tessera_sim_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
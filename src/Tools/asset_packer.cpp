@@ -0,0 +1,42 @@
+﻿#include "asset_pack.h"
+#include <iostream>
+#include <string>
+
+
+
+
+namespace {
+    void printUsage() {
+        std::cout << "Usage: asset_packer [--assets DIR] [--out FILE]\n"
+                  << "Packs DIR (default Assets) into FILE (default " << ASSET_PACK_FILE << ")." << std::endl;
+    }
+}
+
+
+int main(int argc, char** argv) {
+    std::string assetDirectory = "Assets";
+    std::string packPath = ASSET_PACK_FILE;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--assets" && hasValue) {
+            assetDirectory = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            packPath = argv[++i];
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (!writeAssetPack(assetDirectory, packPath)) {
+        return 1;
+    }
+
+    AssetPack check;
+    if (!check.open(packPath)) {
+        std::cout << "Written pack failed to open: " << packPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
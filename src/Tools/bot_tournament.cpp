@@ -0,0 +1,259 @@
+﻿#include "bot_player.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+
+namespace {
+    constexpr double ELO_START = 1500.0;
+    constexpr double ELO_K = 16.0;
+
+    struct TournamentOptions {
+        int seedCount = 200;
+        std::uint32_t firstSeed = 1;
+        int pieceLimit = 500;
+        int threadCount = 0;
+        int replaysPerConfig = 3;
+        std::string replayDir = "tournament_replays";
+        std::vector<std::string> configNames;
+    };
+
+    struct ConfigStanding {
+        int wins = 0;
+        int losses = 0;
+        int draws = 0;
+        double elo = ELO_START;
+        long long pieces = 0;
+        long long lines = 0;
+        long long score = 0;
+        int topOuts = 0;
+        double thinkSeconds = 0.0;
+    };
+
+    struct LossRecord {
+        int margin = 0;
+        int seedIndex = 0;
+    };
+
+    void printUsage() {
+        std::cout << "Usage: bot_tournament [--seeds N] [--first-seed S] [--pieces N] [--threads N]\n"
+                  << "                      [--replays N] [--out DIR] [--config NAME]...\n"
+                  << "Configs:";
+        for (const BotConfig& preset : getBotPresets()) {
+            std::cout << " " << preset.name;
+        }
+        std::cout << std::endl;
+    }
+
+    bool parseOptions(int argc, char** argv, TournamentOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--help" || arg == "-h") return false;
+            if (!hasValue) {
+                std::cout << "Missing value for " << arg << std::endl;
+                return false;
+            }
+            std::string value = argv[++i];
+            if (arg == "--seeds") options.seedCount = std::max(1, std::atoi(value.c_str()));
+            else if (arg == "--first-seed") options.firstSeed = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+            else if (arg == "--pieces") options.pieceLimit = std::max(1, std::atoi(value.c_str()));
+            else if (arg == "--threads") options.threadCount = std::max(0, std::atoi(value.c_str()));
+            else if (arg == "--replays") options.replaysPerConfig = std::max(0, std::atoi(value.c_str()));
+            else if (arg == "--out") options.replayDir = value;
+            else if (arg == "--config") options.configNames.push_back(value);
+            else {
+                std::cout << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool selectConfigs(const TournamentOptions& options, std::vector<BotConfig>& configs) {
+        const std::vector<BotConfig>& presets = getBotPresets();
+        if (options.configNames.empty()) {
+            configs = presets;
+            return true;
+        }
+        for (const std::string& name : options.configNames) {
+            auto it = std::find_if(presets.begin(), presets.end(), [&](const BotConfig& preset) { return preset.name == name; });
+            if (it == presets.end()) {
+                std::cout << "Unknown config " << name << std::endl;
+                return false;
+            }
+            configs.push_back(*it);
+        }
+        return true;
+    }
+
+    int compareResults(const BotGameResult& a, const BotGameResult& b) {
+        if (a.score != b.score) return a.score > b.score ? 1 : -1;
+        if (a.piecesPlaced != b.piecesPlaced) return a.piecesPlaced > b.piecesPlaced ? 1 : -1;
+        return 0;
+    }
+
+    bool writeReplay(const std::filesystem::path& path, const BotConfig& config, std::uint32_t seed, int pieceLimit, const BotGameResult& result, const std::vector<BotMove>& moves) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cout << "Failed to write replay " << path.string() << std::endl;
+            return false;
+        }
+        file << "config=" << config.name << "\n";
+        file << "seed=" << seed << "\n";
+        file << "pieceLimit=" << pieceLimit << "\n";
+        file << "score=" << result.score << "\n";
+        file << "lines=" << result.linesCleared << "\n";
+        file << "pieces=" << result.piecesPlaced << "\n";
+        file << "toppedOut=" << (result.toppedOut ? 1 : 0) << "\n";
+        file << "# type rotation x y hold\n";
+        for (const BotMove& move : moves) {
+            file << static_cast<int>(move.placement.type) << " " << move.placement.rotation << " "
+                 << move.placement.x << " " << move.placement.y << " " << (move.useHold ? 1 : 0) << "\n";
+        }
+        return true;
+    }
+}
+
+
+int main(int argc, char** argv) {
+    TournamentOptions options;
+    std::vector<BotConfig> configs;
+    if (!parseOptions(argc, argv, options) || !selectConfigs(options, configs)) {
+        printUsage();
+        return 1;
+    }
+    if (configs.size() < 2) {
+        std::cout << "A tournament needs at least two configs" << std::endl;
+        return 1;
+    }
+
+    int configCount = static_cast<int>(configs.size());
+    int gameCount = options.seedCount * configCount;
+    std::vector<BotGameResult> results(gameCount);
+
+    int threadCount = options.threadCount > 0 ? options.threadCount : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, std::min(threadCount, gameCount));
+    std::cout << "Running " << gameCount << " games (" << options.seedCount << " seeds x " << configCount
+              << " configs, " << options.pieceLimit << " pieces) on " << threadCount << " threads" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int> nextGame{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&] {
+            for (int game = nextGame++; game < gameCount; game = nextGame++) {
+                int seedIndex = game / configCount;
+                int configIndex = game % configCount;
+                std::uint32_t seed = options.firstSeed + static_cast<std::uint32_t>(seedIndex);
+                results[game] = playHeadlessGame(configs[configIndex], seed, options.pieceLimit);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<ConfigStanding> standings(configCount);
+    std::vector<std::vector<LossRecord>> losses(configCount);
+    std::vector<double> eloDelta(configCount);
+    for (int seedIndex = 0; seedIndex < options.seedCount; ++seedIndex) {
+        const BotGameResult* seedResults = &results[seedIndex * configCount];
+        int bestScore = 0;
+        for (int c = 0; c < configCount; ++c) {
+            const BotGameResult& result = seedResults[c];
+            ConfigStanding& standing = standings[c];
+            standing.pieces += result.piecesPlaced;
+            standing.lines += result.linesCleared;
+            standing.score += result.score;
+            standing.thinkSeconds += result.thinkSeconds;
+            if (result.toppedOut) ++standing.topOuts;
+            bestScore = std::max(bestScore, result.score);
+        }
+
+        std::fill(eloDelta.begin(), eloDelta.end(), 0.0);
+        for (int a = 0; a < configCount; ++a) {
+            bool lostAny = false;
+            for (int b = 0; b < configCount; ++b) {
+                if (a == b) continue;
+                int outcome = compareResults(seedResults[a], seedResults[b]);
+                if (outcome > 0) ++standings[a].wins;
+                else if (outcome < 0) { ++standings[a].losses; lostAny = true; }
+                else ++standings[a].draws;
+
+                double expected = 1.0 / (1.0 + std::pow(10.0, (standings[b].elo - standings[a].elo) / 400.0));
+                double actual = outcome > 0 ? 1.0 : (outcome < 0 ? 0.0 : 0.5);
+                eloDelta[a] += ELO_K * (actual - expected);
+            }
+            if (lostAny) losses[a].push_back({bestScore - seedResults[a].score, seedIndex});
+        }
+        for (int c = 0; c < configCount; ++c) {
+            standings[c].elo += eloDelta[c];
+        }
+    }
+
+    std::vector<int> order(configCount);
+    for (int c = 0; c < configCount; ++c) order[c] = c;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return standings[a].elo > standings[b].elo; });
+
+    std::cout << "\nFinished in " << std::fixed << std::setprecision(2) << wallSeconds << "s\n\n";
+    std::cout << std::left << std::setw(16) << "Config" << std::right
+              << std::setw(8) << "Elo" << std::setw(9) << "Win%" << std::setw(7) << "W"
+              << std::setw(7) << "L" << std::setw(7) << "D" << std::setw(11) << "AvgLines"
+              << std::setw(9) << "TopOut" << std::setw(10) << "PPS" << "\n";
+    for (int c : order) {
+        const ConfigStanding& standing = standings[c];
+        int games = standing.wins + standing.losses + standing.draws;
+        double winRate = games > 0 ? 100.0 * (standing.wins + 0.5 * standing.draws) / games : 0.0;
+        double pps = standing.thinkSeconds > 0.0 ? standing.pieces / standing.thinkSeconds : 0.0;
+        std::cout << std::left << std::setw(16) << configs[c].name << std::right
+                  << std::setw(8) << std::setprecision(0) << standing.elo
+                  << std::setw(8) << std::setprecision(1) << winRate << "%"
+                  << std::setw(7) << standing.wins << std::setw(7) << standing.losses << std::setw(7) << standing.draws
+                  << std::setw(11) << std::setprecision(1) << static_cast<double>(standing.lines) / options.seedCount
+                  << std::setw(9) << standing.topOuts
+                  << std::setw(10) << std::setprecision(0) << pps << "\n";
+    }
+    std::cout << std::endl;
+
+    if (options.replaysPerConfig == 0) return 0;
+
+    std::error_code error;
+    std::filesystem::path replayDir(options.replayDir);
+    std::filesystem::create_directories(replayDir, error);
+    if (error) {
+        std::cout << "Failed to create replay directory " << replayDir.string() << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    int written = 0;
+    std::vector<BotMove> moves;
+    for (int c = 0; c < configCount; ++c) {
+        std::vector<LossRecord>& configLosses = losses[c];
+        std::sort(configLosses.begin(), configLosses.end(), [](const LossRecord& a, const LossRecord& b) {
+            return a.margin != b.margin ? a.margin > b.margin : a.seedIndex < b.seedIndex;
+        });
+        int count = std::min(options.replaysPerConfig, static_cast<int>(configLosses.size()));
+        for (int i = 0; i < count; ++i) {
+            std::uint32_t seed = options.firstSeed + static_cast<std::uint32_t>(configLosses[i].seedIndex);
+            BotGameResult replayed = playHeadlessGame(configs[c], seed, options.pieceLimit, &moves);
+            if (replayed.score != results[configLosses[i].seedIndex * configCount + c].score) {
+                std::cout << "WARNING: replay of " << configs[c].name << " seed " << seed << " diverged from the tournament game" << std::endl;
+            }
+            std::filesystem::path path = replayDir / (configs[c].name + "_seed" + std::to_string(seed) + ".replay");
+            if (writeReplay(path, configs[c], seed, options.pieceLimit, replayed, moves)) ++written;
+        }
+    }
+    std::cout << "Wrote " << written << " replays to " << replayDir.string() << std::endl;
+    return 0;
+}
@@ -12,6 +12,20 @@
 #include "game_logic.h"
 #include "game_state.h"
 #include "input_handler.h"
+#include "pc_solver.h"
+#include "game_analytics.h"
+#include "analytics_log.h"
+#include "finesse.h"
+#include "game_history.h"
+#include "achievement_engine.h"
+#include "game_snapshot.h"
+#include "mode_stats.h"
+#include "profiles.h"
+#include "practice_undo.h"
+#include "asset_loader.h"
+#include "asset_pack.h"
+#include "glyph_prewarm.h"
+#include "trace.h"
 #include <iostream>
 #include <iomanip>
 #include <cstdlib>
@@ -41,8 +55,7 @@ void explodeMenuBomb(const BackgroundPiece& bomb,
                      float& shakeIntensity,
                      float& shakeDuration,
                      float& shakeTimer,
-                     SaveData& saveData,
-                     std::vector<AchievementPopup>& achievementPopups) {
+                     AchievementEngine& achievementEngine) {
     
     float bombRotation = bomb.rotation;
     float bombCenterX = bomb.x;
@@ -91,8 +104,7 @@ void explodeMenuBomb(const BackgroundPiece& bomb,
     shakeTimer = 0.0f;
     
 
-    unlockAchievement(saveData, Achievement::MenuBombClicker, &achievementPopups, &audioManager);
-    saveGameData(saveData);
+    achievementEngine.onMenuBombClicked();
     
     std::cout << "Bomb clicked and exploded in menu!" << std::endl;
 }
@@ -171,243 +183,6 @@ AbilityType getAbilityType(PieceType type) {
 }
 
 
-std::vector<PieceType> PieceBag::createNewBag(int level) {
-    std::cout << "Creating bag for level: " << level << std::endl;
-    std::vector<PieceType> newBag;
-    
-
-    std::vector<PieceType> basicTypes = {
-        PieceType::I_Basic, PieceType::T_Basic, PieceType::L_Basic, 
-        PieceType::J_Basic, PieceType::O_Basic, PieceType::S_Basic, PieceType::Z_Basic,
-    };
-    
-
-    if (difficultyConfig && difficultyConfig->useCustomPieceFilter && !difficultyConfig->allowedBasicPieces.empty()) {
-        basicTypes = difficultyConfig->allowedBasicPieces;
-        std::cout << "Using custom basic pieces filter (" << basicTypes.size() << " pieces)" << std::endl;
-    }
-    
-
-    if (!difficultyConfig) {
-        std::cout << "WARNING: No difficulty config set, using fallback" << std::endl;
-
-        if (level < 1) {
-            newBag = basicTypes;
-        } else if (level <= 5) {
-            newBag = basicTypes;
-            for (int i = 0; i < std::min(level, 2); i++) {
-                if (mediumBagIndex >= mediumBag.size()) refillMediumBag();
-                newBag.push_back(mediumBag[mediumBagIndex++]);
-            }
-            if (level >= 2) {
-                for (int i = 0; i < std::min(level - 2, 2); i++) {
-                    if (hardBagIndex >= hardBag.size()) refillHardBag();
-                    newBag.push_back(hardBag[hardBagIndex++]);
-                }
-            }
-        }
-        std::shuffle(newBag.begin(), newBag.end(), rng);
-        return newBag;
-    }
-    
-
-    BagLevelConfig bagConfig = {7, 0, 0};
-    
-    for (const auto& threshold : difficultyConfig->levelThresholds) {
-        if (level >= threshold.lines / 10) {
-            bagConfig = threshold.bagConfig;
-        }
-    }
-    
-
-    int bestThreshold = 0;
-    for (size_t i = 0; i < difficultyConfig->levelThresholds.size(); i++) {
-        if (level >= static_cast<int>(i)) {
-            bagConfig = difficultyConfig->levelThresholds[i].bagConfig;
-        }
-    }
-    
-    std::cout << "Bag config for level " << level << ": " 
-              << bagConfig.basicPieces << " basic, " 
-              << bagConfig.mediumPieces << " medium, " 
-              << bagConfig.hardPieces << " hard" << std::endl;
-    
-
-    for (int i = 0; i < bagConfig.basicPieces; i++) {
-        newBag.push_back(basicTypes[i % basicTypes.size()]);
-    }
-    
-
-    for (int i = 0; i < bagConfig.mediumPieces; i++) {
-        if (mediumBagIndex >= mediumBag.size()) refillMediumBag();
-        newBag.push_back(mediumBag[mediumBagIndex++]);
-    }
-    
-
-    for (int i = 0; i < bagConfig.hardPieces; i++) {
-        if (hardBagIndex >= hardBag.size()) refillHardBag();
-        newBag.push_back(hardBag[hardBagIndex++]);
-    }
-    
-    std::shuffle(newBag.begin(), newBag.end(), rng);
-    return newBag;
-}
-
-void PieceBag::ensureNextBagReady() {
-    if (!nextBagReady) {
-        nextBag = createNewBag(currentLevel);
-        nextBagReady = true;
-    }
-}
-
-void PieceBag::fillNextQueue() {
-    nextQueue.clear();
-    int tempBagIndex = bagIndex;
-    
-    for (int i = 0; i < 3; ++i) {
-        if (tempBagIndex >= currentBag.size()) {
-            ensureNextBagReady();
-            int nextBagIdx = tempBagIndex - currentBag.size();
-            nextQueue.push_back(nextBag[nextBagIdx]);
-            tempBagIndex++;
-        } else {
-            nextQueue.push_back(currentBag[tempBagIndex++]);
-        }
-    }
-}
-
-void PieceBag::refillMediumBag() {
-
-    std::vector<PieceType> defaultMediumTypes = {
-        PieceType::I_Medium, PieceType::T_Medium, PieceType::L_Medium, 
-        PieceType::J_Medium, PieceType::O_Medium, PieceType::S_Medium, PieceType::Z_Medium
-    };
-    
-
-    if (difficultyConfig && difficultyConfig->useCustomPieceFilter && !difficultyConfig->allowedMediumPieces.empty()) {
-        mediumBag = difficultyConfig->allowedMediumPieces;
-    } else {
-        mediumBag = defaultMediumTypes;
-    }
-    
-    std::shuffle(mediumBag.begin(), mediumBag.end(), rng);
-    mediumBagIndex = 0;
-    std::cout << "Medium bag refilled and shuffled (" << mediumBag.size() << " pieces)" << std::endl;
-}
-
-void PieceBag::refillHardBag() {
-
-    std::vector<PieceType> defaultHardTypes = {
-        PieceType::I_Hard, PieceType::T_Hard, PieceType::L_Hard, 
-        PieceType::J_Hard, PieceType::O_Hard, PieceType::S_Hard, PieceType::Z_Hard
-    };
-    
-
-    if (difficultyConfig && difficultyConfig->useCustomPieceFilter && !difficultyConfig->allowedHardPieces.empty()) {
-        hardBag = difficultyConfig->allowedHardPieces;
-    } else {
-        hardBag = defaultHardTypes;
-    }
-    
-    std::shuffle(hardBag.begin(), hardBag.end(), rng);
-    hardBagIndex = 0;
-    std::cout << "Hard bag refilled and shuffled (" << hardBag.size() << " pieces)" << std::endl;
-}
-
-PieceBag::PieceBag() : rng(std::random_device{}()), currentLevel(0) {
-    std::cout << "PieceBag constructor: currentLevel = " << currentLevel << std::endl;
-    refillMediumBag();
-    refillHardBag();
-    currentBag = createNewBag(currentLevel);
-    bagIndex = 0;
-    fillNextQueue();
-}
-
-PieceType PieceBag::getNextPiece() {
-    if (bagIndex >= currentBag.size()) {
-        ensureNextBagReady();
-        currentBag = nextBag;
-        bagIndex = 0;
-        nextBagReady = false;
-    }
-    
-    PieceType piece = currentBag[bagIndex++];
-    fillNextQueue();
-    return piece;
-}
-
-void PieceBag::updateLevel(int newLevel) {
-    if (newLevel != currentLevel) {
-        currentLevel = newLevel;
-        std::cout << "Bag difficulty updated to level " << currentLevel << "!" << std::endl;
-    }
-}
-
-const std::vector<PieceType>& PieceBag::getNextQueue() const {
-    return nextQueue;
-}
-
-const std::vector<PieceType>& PieceBag::getCurrentBag() const {
-    return currentBag;
-}
-
-const std::vector<PieceType>& PieceBag::getNextBag() const {
-    return nextBag;
-}
-
-int PieceBag::getBagIndex() const {
-    return bagIndex;
-}
-
-bool PieceBag::isNextBagReady() const {
-    return nextBagReady;
-}
-
-void PieceBag::reset() {
-    reset(0);
-}
-
-void PieceBag::reset(int startLevel) {
-    currentLevel = startLevel;
-    bagIndex = 0;
-    nextBagReady = false;
-    refillMediumBag();
-    refillHardBag();
-    currentBag = createNewBag(currentLevel);
-    nextBag.clear();
-    nextQueue.clear();
-    fillNextQueue();
-    std::cout << "Bag system reset to level " << currentLevel << "!" << std::endl;
-}
-
-void PieceBag::setDifficultyConfig(const DifficultyConfig* config) {
-    difficultyConfig = config;
-    std::cout << "Difficulty config set to: " << (config ? config->modeName : "nullptr") << std::endl;
-    if (config) {
-        std::cout << "  Max Levels: " << config->maxLevels << std::endl;
-        std::cout << "  Line Goal: " << (config->hasLineGoal ? std::to_string(config->lineGoal) : "None") << std::endl;
-        std::cout << "  Bomb: " << (config->bombEnabled ? "Yes" : "No") << std::endl;
-        std::cout << "  Hold: " << (config->holdEnabled ? "Yes" : "No") << std::endl;
-    }
-}
-
-void PieceBag::returnPieceToBag(PieceType piece) {
-    std::cout << "[DEBUG] Returning piece to bag at position " << bagIndex << " (will be next piece)" << std::endl;
-    currentBag.insert(currentBag.begin() + bagIndex, piece);
-    fillNextQueue();
-    std::cout << "[DEBUG] Bag size after return: " << currentBag.size() << std::endl;
-}
-
-void PieceBag::insertPiecesToQueue(PieceType piece, int count) {
-    std::cout << "[DEBUG] Inserting " << count << " pieces into queue at position " << bagIndex << std::endl;
-    for (int i = 0; i < count; i++) {
-        currentBag.insert(currentBag.begin() + bagIndex + i, piece);
-    }
-    fillNextQueue();
-    std::cout << "[DEBUG] Bag size after insert: " << currentBag.size() << std::endl;
-}
-
-
 void StompEffect(int stompX, int stompY, std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, float& shakeIntensity, float& shakeDuration, float& shakeTimer);
 
 class Piece {
@@ -443,6 +218,38 @@ public:
     void setY(int newY) { y = newY; }
     void setColor(const sf::Color& newColor) { shape.color = newColor; }
     const PieceShape& getShape() const { return shape; }
+
+    ActivePieceState captureState() const {
+        ActivePieceState state;
+        state.type = type;
+        state.ability = ability;
+        state.shape = shape;
+        state.x = x;
+        state.y = y;
+        state.isStatic = isStatic;
+        state.fallTimer = fallTimer;
+        state.touchingGround = touchingGround;
+        state.lockDelayTimer = lockDelayTimer;
+        state.lockResetCount = lockResetCount;
+        state.lowestY = lowestY;
+        state.highestY = highestY;
+        return state;
+    }
+
+    void restoreState(const ActivePieceState& state) {
+        type = state.type;
+        ability = state.ability;
+        shape = state.shape;
+        x = state.x;
+        y = state.y;
+        isStatic = state.isStatic;
+        fallTimer = state.fallTimer;
+        touchingGround = state.touchingGround;
+        lockDelayTimer = state.lockDelayTimer;
+        lockResetCount = state.lockResetCount;
+        lowestY = state.lowestY;
+        highestY = state.highestY;
+    }
     bool collidesAt(const std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, int testX, int testY) const {
         for (int i = 0; i < shape.height; ++i) {
             for (int j = 0; j < shape.width; ++j) {
@@ -472,7 +279,7 @@ public:
         }
         return false;
     }
-    void update(float deltaTime, bool fastFall, std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, int currentLevel, float gravityValue, bool gravityFlipped = false) {
+    void update(float deltaTime, std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, int currentLevel, float gravityValue, bool gravityFlipped = false) {
         if (isStatic) return;
 
         fallTimer += deltaTime;
@@ -530,7 +337,7 @@ public:
 
             float fallInterval = 1.0f / gravityValue;
             
-            if (fallTimer >= (fastFall ? 0.03f : fallInterval)) {
+            if (fallTimer >= fallInterval) {
                 if (gravityFlipped) {
                     y--;
                 } else {
@@ -541,7 +348,7 @@ public:
             }
         }
     }
-    void ChangeToStatic(std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, AbilityType ability = AbilityType::None, AudioManager* audioManager = nullptr, std::vector<ExplosionEffect>* explosions = nullptr, std::vector<GlowEffect>* glowEffects = nullptr, float* shakeIntensity = nullptr, float* shakeDuration = nullptr, float* shakeTimer = nullptr, int* consecutiveBombsUsed = nullptr, SaveData* saveData = nullptr, std::vector<AchievementPopup>* achievementPopups = nullptr, bool isVanishingMode = false) {
+    void ChangeToStatic(std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, AbilityType ability = AbilityType::None, AudioManager* audioManager = nullptr, std::vector<ExplosionEffect>* explosions = nullptr, std::vector<GlowEffect>* glowEffects = nullptr, float* shakeIntensity = nullptr, float* shakeDuration = nullptr, float* shakeTimer = nullptr, int* consecutiveBombsUsed = nullptr, AchievementEngine* achievementEngine = nullptr, bool isVanishingMode = false) {
 
         if (ability != AbilityType::Stomp) {
             for (int i = 0; i < shape.height; ++i) {
@@ -563,20 +370,19 @@ public:
         }
         
         if (ability != AbilityType::None) {
-            AbilityEffect(grid, audioManager, explosions, glowEffects, shakeIntensity, shakeDuration, shakeTimer, consecutiveBombsUsed, saveData, achievementPopups);
+            AbilityEffect(grid, audioManager, explosions, glowEffects, shakeIntensity, shakeDuration, shakeTimer, consecutiveBombsUsed, achievementEngine);
         }
     }
-    void BombEffect(int centerX, int centerY, std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, AudioManager& audioManager, std::vector<ExplosionEffect>& explosions, std::vector<GlowEffect>& glowEffects, float& shakeIntensity, float& shakeDuration, float& shakeTimer, int* consecutiveBombsUsed = nullptr, SaveData* saveData = nullptr, std::vector<AchievementPopup>* achievementPopups = nullptr) {
+    void BombEffect(int centerX, int centerY, std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, AudioManager& audioManager, std::vector<ExplosionEffect>& explosions, std::vector<GlowEffect>& glowEffects, float& shakeIntensity, float& shakeDuration, float& shakeTimer, int* consecutiveBombsUsed = nullptr, AchievementEngine* achievementEngine = nullptr) {
         audioManager.playBombSound();
         
 
-        if (consecutiveBombsUsed && saveData && achievementPopups) {
+        if (consecutiveBombsUsed) {
             (*consecutiveBombsUsed)++;
             std::cout << "[BOMB] Consecutive explosions: " << *consecutiveBombsUsed << "/3" << std::endl;
             
-            if (*consecutiveBombsUsed >= 3) {
-                std::cout << "[ACHIEVEMENT] UNLOCKING EXPLOSION!" << std::endl;
-                unlockAchievement(*saveData, Achievement::Explosion, achievementPopups, &audioManager);
+            if (achievementEngine) {
+                achievementEngine->onBombExploded(*consecutiveBombsUsed, true);
             }
         }
         
@@ -634,13 +440,13 @@ public:
         }
     }
     
-    void AbilityEffect(std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, AudioManager* audioManager = nullptr, std::vector<ExplosionEffect>* explosions = nullptr, std::vector<GlowEffect>* glowEffects = nullptr, float* shakeIntensity = nullptr, float* shakeDuration = nullptr, float* shakeTimer = nullptr, int* consecutiveBombsUsed = nullptr, SaveData* saveData = nullptr, std::vector<AchievementPopup>* achievementPopups = nullptr)
+    void AbilityEffect(std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, AudioManager* audioManager = nullptr, std::vector<ExplosionEffect>* explosions = nullptr, std::vector<GlowEffect>* glowEffects = nullptr, float* shakeIntensity = nullptr, float* shakeDuration = nullptr, float* shakeTimer = nullptr, int* consecutiveBombsUsed = nullptr, AchievementEngine* achievementEngine = nullptr)
     {
         switch(ability)
         {
             case AbilityType::Bomb:
                 if (audioManager && explosions && glowEffects && shakeIntensity && shakeDuration && shakeTimer) {
-                    BombEffect(x, y, grid, *audioManager, *explosions, *glowEffects, *shakeIntensity, *shakeDuration, *shakeTimer, consecutiveBombsUsed, saveData, achievementPopups);
+                    BombEffect(x, y, grid, *audioManager, *explosions, *glowEffects, *shakeIntensity, *shakeDuration, *shakeTimer, consecutiveBombsUsed, achievementEngine);
                 } else {
                     std::cout << "Bomb ability activated (no sound/explosions)!" << std::endl;
                 }
@@ -790,6 +596,17 @@ public:
         }
     }
     
+    // One soft-drop row; gravity restarts its count from here.
+    void softDrop(const std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid, bool gravityFlipped = false) {
+        if (isStatic) return;
+        int nextY = gravityFlipped ? y - 1 : y + 1;
+        bool blocked = gravityFlipped ? collidesAtWithCeiling(grid, x, nextY) : collidesAt(grid, x, nextY);
+        if (!blocked) {
+            y = nextY;
+            fallTimer = 0.0f;
+            updatePosition();
+        }
+    }
     void moveLeft(const std::array<std::array<Cell, GRID_WIDTH>, GRID_HEIGHT>& grid) { 
         if (!isStatic && !collidesAt(grid, x - 1, y)) {
             --x;
@@ -1145,13 +962,20 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 int main(int argc, char* argv[]) {
 #endif
     bool consoleMode = false;
+    bool audioEnabled = true;
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         if (arg == "-debugMode" || arg == "--debug" || arg == "-d") {
             consoleMode = true;
-            break;
+        } else if (arg == "-noAudio" || arg == "--no-audio") {
+            audioEnabled = false;
+        } else if (arg == "--trace") {
+            traceEnable(TRACE_DEFAULT_FILE);
+        } else if (arg.rfind("--trace=", 0) == 0) {
+            traceEnable(arg.substr(8));
         }
     }
+    traceSetThreadName("main");
     
 #ifdef _WIN32
     if (consoleMode) {
@@ -1168,10 +992,19 @@ int main(int argc, char* argv[]) {
     
     srand(static_cast<unsigned int>(time(nullptr)));
     
+    TraceZone loadSaveZone("loadGameData");
+    ProfileManager profileManager;
+    profileManager.loadIndex();
     SaveData saveData = loadGameData();
+    loadSaveZone.finish();
+    TraceZone historyZone("open game history");
+    GameHistory gameHistory;
+    gameHistory.open(getHistoryFilePath());
+    historyZone.finish();
     
     const unsigned int WINDOW_WIDTH = 1920;
     const unsigned int WINDOW_HEIGHT = 1080;
+    TraceZone windowZone("create window");
     sf::RenderWindow window;
     bool isFullscreen = true;
     if (isFullscreen) {
@@ -1185,6 +1018,7 @@ int main(int argc, char* argv[]) {
     window.setMouseCursorGrabbed(false);
     window.setFramerateLimit(144);
     window.requestFocus();
+    windowZone.finish();
     
 
     sf::View mainView(sf::Vector2f(static_cast<float>(WINDOW_WIDTH) / 2.0f, static_cast<float>(WINDOW_HEIGHT) / 2.0f), 
@@ -1194,14 +1028,16 @@ int main(int argc, char* argv[]) {
     std::cout << "View size: " << WINDOW_WIDTH << "x" << WINDOW_HEIGHT << " (will be scaled to fit)" << std::endl;
     
 
+    TraceZone packZone("open asset pack");
+    if (!getAssetPack().open(ASSET_PACK_FILE)) {
+        std::cout << "No asset pack found, loading loose files from Assets/" << std::endl;
+    }
+    packZone.finish();
+    AssetLoader assetLoader;
     sf::Texture splashTexture;
     bool splashLoaded = false;
-    if (splashTexture.loadFromFile("Assets/Texture/SplashScreen/Kilonia Studios.png")) {
-        splashLoaded = true;
-        std::cout << "Splash screen texture loaded successfully" << std::endl;
-    } else {
-        std::cout << "Unable to load splash screen texture" << std::endl;
-    }
+    bool splashResolved = false;
+    std::size_t splashImage = assetLoader.addImage("Assets/Texture/SplashScreen/Kilonia Studios.png");
     
     std::map<TextureType, sf::Texture> textures;
     std::vector<TextureInfo> textureList = {
@@ -1215,50 +1051,79 @@ int main(int argc, char* argv[]) {
         {TextureType::Button, "Assets/Texture/Menu/Button.png", sf::Color::White},
         {TextureType::ButtonActive, "Assets/Texture/Menu/ButtonActive.png", sf::Color::White}
     };
-    bool useTextures = false;
+    std::size_t firstTextureImage = splashImage + 1;
     for (const auto& info : textureList) {
-        sf::Texture texture;
-        if (texture.loadFromFile(info.filename)) {
-            textures[info.type] = texture;
+        assetLoader.addImage(info.filename);
+    }
+    bool useTextures = false;
+    
+    // Titles and menus use the same face, so the file is opened once and
+    // both names refer to it; glyphs rasterized for one are reused by the other.
+    sf::Font menuFont;
+    sf::Font& titleFont = menuFont;
+    assetLoader.addFont(menuFont, "Assets/Fonts/Righteous-Regular.ttf");
+    bool fontLoaded = false;
+    GlyphPrewarmer glyphPrewarmer;
+    assetLoader.start();
+
+
+    // Runs on this thread as each decoded image becomes a texture; the
+    // texture is moved into place so it is only uploaded once.
+    auto onTextureUploaded = [&](std::size_t image, sf::Texture* texture) {
+        if (image == splashImage) {
+            splashResolved = true;
+            if (texture) {
+                splashTexture = std::move(*texture);
+                splashLoaded = true;
+                std::cout << "Splash screen texture loaded successfully" << std::endl;
+            } else {
+                std::cout << "Unable to load splash screen texture" << std::endl;
+            }
+            return;
+        }
+        const TextureInfo& info = textureList[image - firstTextureImage];
+        if (texture) {
+            textures[info.type] = std::move(*texture);
             useTextures = true;
             std::cout << "Loaded texture: " << info.filename << std::endl;
         } else {
             std::cout << "Unable to load texture: " << info.filename << " - using fallback for this type" << std::endl;
         }
-    }
-    
-    sf::Font titleFont;
-    bool titleFontLoaded = false;
-    for (int attempt = 0; attempt < 3 && !titleFontLoaded; ++attempt) {
-        if (titleFont.openFromFile("Assets/Fonts/Righteous-Regular.ttf")) {
-            titleFontLoaded = true;
-            std::cout << "Font loaded successfully: Righteous-Regular.ttf" << std::endl;
-        } else {
-            std::cout << "Unable to load font: Assets/Fonts/Righteous-Regular.ttf (attempt " << (attempt + 1) << "/3)" << std::endl;
-            if (attempt < 2) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
+    };
+    auto pumpAssetLoader = [&](bool waitForAll) {
+        if (assetLoader.isFinished()) {
+            return;
         }
-    }
-    
-    sf::Font menuFont;
-    bool menuFontLoaded = false;
-    for (int attempt = 0; attempt < 3 && !menuFontLoaded; ++attempt) {
-        if (menuFont.openFromFile("Assets/Fonts/Righteous-Regular.ttf")) {
-            menuFontLoaded = true;
-            std::cout << "Font loaded successfully: Righteous-Regular.ttf" << std::endl;
+        if (waitForAll) {
+            assetLoader.finish(onTextureUploaded);
         } else {
-            std::cout << "Unable to load font: Assets/Fonts/Righteous-Regular.ttf (attempt " << (attempt + 1) << "/3)" << std::endl;
-            if (attempt < 2) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            assetLoader.uploadDecodedImages(onTextureUploaded, ASSET_UPLOADS_PER_FRAME);
+        }
+        if (assetLoader.isFinished()) {
+            fontLoaded = assetLoader.allFontsLoaded();
+            std::cout << (fontLoaded ? "Font loaded successfully: Righteous-Regular.ttf" : "Unable to load font: Assets/Fonts/Righteous-Regular.ttf") << std::endl;
+            if (fontLoaded) {
+                glyphPrewarmer.start(menuFont);
             }
         }
-    }
-    
-    bool fontLoaded = titleFontLoaded && menuFontLoaded;
+    };
     
 
-    AudioManager audioManager;
+    bool debugMode = false;
+
+
+    struct NullStreamBuf final : std::streambuf {
+        int overflow(int c) override { return c; }
+    };
+    static NullStreamBuf nullStreamBuf;
+    static std::streambuf* originalCoutBuf = nullptr;
+    if (!debugMode) {
+        originalCoutBuf = std::cout.rdbuf(&nullStreamBuf);
+    }
+
+    // Swapped before the audio thread starts so its logging never races the rdbuf change.
+    AudioManager audioManager(audioEnabled ? std::unique_ptr<AudioBackend>(std::make_unique<SfmlAudioBackend>())
+                                           : std::unique_ptr<AudioBackend>(std::make_unique<NullAudioBackend>()));
     audioManager.setMasterVolume(saveData.masterVolume);
     if (saveData.isMuted) {
         audioManager.toggleMute();
@@ -1274,6 +1139,8 @@ int main(int argc, char* argv[]) {
     std::vector<BackgroundPiece> backgroundPieces;
     std::vector<BackgroundPiece> gameBackgroundPieces;
     std::vector<AchievementPopup> achievementPopups;
+    AchievementEngine achievementEngine;
+    achievementEngine.sync(saveData);
     std::vector<ThermometerParticle> thermometerParticles;
     std::vector<FallingCell> fallingCells;
     
@@ -1323,6 +1190,14 @@ int main(int argc, char* argv[]) {
     GameThemeChoice selectedThemeChoice = static_cast<GameThemeChoice>(saveData.selectedTheme);
     GameThemeChoice hoveredThemeChoice = selectedThemeChoice;
     
+    // Selection whose theme sounds were last queued, so the menus only
+    // prefetch when it changes instead of every frame.
+    bool themePrefetched = false;
+    GameModeOption prefetchedModeOption = selectedGameModeOption;
+    ClassicDifficulty prefetchedClassicDifficulty = selectedClassicDifficulty;
+    ChallengeMode prefetchedChallengeMode = selectedChallengeMode;
+    GameThemeChoice prefetchedThemeChoice = selectedThemeChoice;
+    
 
     AbilityChoice selectedAbilityChoice = AbilityChoice::Bomb;
     AbilityChoice hoveredAbilityChoice = selectedAbilityChoice;
@@ -1355,32 +1230,22 @@ int main(int argc, char* argv[]) {
     ControlScheme hoveredControlScheme = ControlScheme::Alternative;
     
     KeyBindings keyBindings;
-
-    keyBindings.moveLeft = static_cast<sf::Keyboard::Key>(saveData.moveLeft);
-    keyBindings.moveRight = static_cast<sf::Keyboard::Key>(saveData.moveRight);
-    keyBindings.rotateLeft = static_cast<sf::Keyboard::Key>(saveData.rotateLeft);
-    keyBindings.rotateRight = static_cast<sf::Keyboard::Key>(saveData.rotateRight);
-    keyBindings.quickFall = static_cast<sf::Keyboard::Key>(saveData.quickFall);
-    keyBindings.drop = static_cast<sf::Keyboard::Key>(saveData.drop);
-    keyBindings.hold = static_cast<sf::Keyboard::Key>(saveData.hold);
-    keyBindings.bomb = static_cast<sf::Keyboard::Key>(saveData.bomb);
-    keyBindings.restart = static_cast<sf::Keyboard::Key>(saveData.restart);
-    keyBindings.mute = static_cast<sf::Keyboard::Key>(saveData.mute);
-    keyBindings.volumeDown = static_cast<sf::Keyboard::Key>(saveData.volumeDown);
-    keyBindings.volumeUp = static_cast<sf::Keyboard::Key>(saveData.volumeUp);
-    keyBindings.menu = static_cast<sf::Keyboard::Key>(saveData.menu);
-    
-    bool debugMode = false;
-
-
-    struct NullStreamBuf final : std::streambuf {
-        int overflow(int c) override { return c; }
+    auto loadKeyBindings = [&keyBindings](const SaveData& data) {
+        keyBindings.moveLeft = static_cast<sf::Keyboard::Key>(data.moveLeft);
+        keyBindings.moveRight = static_cast<sf::Keyboard::Key>(data.moveRight);
+        keyBindings.rotateLeft = static_cast<sf::Keyboard::Key>(data.rotateLeft);
+        keyBindings.rotateRight = static_cast<sf::Keyboard::Key>(data.rotateRight);
+        keyBindings.quickFall = static_cast<sf::Keyboard::Key>(data.quickFall);
+        keyBindings.drop = static_cast<sf::Keyboard::Key>(data.drop);
+        keyBindings.hold = static_cast<sf::Keyboard::Key>(data.hold);
+        keyBindings.bomb = static_cast<sf::Keyboard::Key>(data.bomb);
+        keyBindings.restart = static_cast<sf::Keyboard::Key>(data.restart);
+        keyBindings.mute = static_cast<sf::Keyboard::Key>(data.mute);
+        keyBindings.volumeDown = static_cast<sf::Keyboard::Key>(data.volumeDown);
+        keyBindings.volumeUp = static_cast<sf::Keyboard::Key>(data.volumeUp);
+        keyBindings.menu = static_cast<sf::Keyboard::Key>(data.menu);
     };
-    static NullStreamBuf nullStreamBuf;
-    static std::streambuf* originalCoutBuf = nullptr;
-    if (!debugMode) {
-        originalCoutBuf = std::cout.rdbuf(&nullStreamBuf);
-    }
+    loadKeyBindings(saveData);
     
     bool showVolumeIndicator = false;
     float volumeIndicatorTimer = 0.0f;
@@ -1427,7 +1292,33 @@ int main(int argc, char* argv[]) {
     int sessionPiecesPlaced = 0;
     
 
-    #define RESET_SESSION_STATS() do { sessionPlayTime = 0.0f; sessionPiecesPlaced = 0; } while(0)
+    PieceEventLog pieceEventLog;
+    std::uint32_t pieceSpawnTick = 0;
+    int pieceInputCount = 0;
+    int pieceRotationCount = 0;
+    int pieceDropDistance = 0;
+    bool pieceHoldUsed = false;
+    int pieceFinesseInputs = 0;
+    int pieceFinesseFaults = 0;
+    bool analyticsRecorded = false;
+    FinesseTracker finesseTracker;
+    BoardRows historyFinalBoard{};
+    std::array<int, STATS_CLEAR_TYPES> clearTypeCounts{};
+    bool suspendedGameOnDisk = false;
+    
+
+    #define DISCARD_SUSPENDED_GAME() do { \
+        if (suspendedGameOnDisk) { deleteGameSnapshot(); suspendedGameOnDisk = false; } \
+    } while(0)
+
+    #define RESET_SESSION_STATS() do { \
+        sessionPlayTime = 0.0f; sessionPiecesPlaced = 0; \
+        pieceEventLog.clear(); pieceSpawnTick = 0; pieceInputCount = 0; pieceRotationCount = 0; \
+        pieceDropDistance = 0; pieceHoldUsed = false; pieceFinesseInputs = 0; pieceFinesseFaults = 0; \
+        analyticsRecorded = false; finesseTracker.reset(); \
+        historyFinalBoard.fill(0); clearTypeCounts.fill(0); TesseraBag.reseed(std::random_device{}()); \
+        DISCARD_SUSPENDED_GAME(); practiceUndo.clear(); \
+    } while(0)
     
 
     const DifficultyConfig* currentConfig = nullptr;
@@ -1488,13 +1379,11 @@ int main(int argc, char* argv[]) {
     int currentPieceRotations = 0;
     
 
-    float leftHoldTime = 0.0f;
-    float rightHoldTime = 0.0f;
-    const float DAS_DELAY = 0.2f;
-    const float DAS_REPEAT = 0.04f;
-    float dasTimer = 0.0f;
-    bool leftPressed = false;
-    bool rightPressed = false;
+    PerfectClearTrainer pcTrainer;
+    
+
+    DASConfig dasConfig;
+    InputTimeline inputTimeline;
     
     PieceType initType = TesseraBag.getNextPiece();
     std::cout << "Initial spawn: " << pieceTypeToString(initType) << " (Bag System)" << std::endl;
@@ -1503,14 +1392,476 @@ int main(int argc, char* argv[]) {
     int firstFilledRow = findFirstFilledRow(initShape);
     int startY = -firstFilledRow;
     Piece activePiece(startX, startY, initType);
+    
+
+    auto captureGameSnapshot = [&]() {
+        GameSnapshot snapshot;
+        snapshot.mode = selectedGameModeOption;
+        snapshot.classicDifficulty = selectedClassicDifficulty;
+        snapshot.sprintLines = selectedSprintLines;
+        snapshot.challengeMode = selectedChallengeMode;
+        snapshot.practiceDifficulty = selectedPracticeDifficulty;
+        snapshot.practiceLineGoal = selectedPracticeLineGoal;
+        snapshot.practiceInfiniteBombs = practiceInfiniteBombs;
+        snapshot.themeChoice = selectedThemeChoice;
+        snapshot.sprintModeActive = sprintModeActive;
+        snapshot.challengeModeActive = challengeModeActive;
+        snapshot.practiceModeActive = practiceModeActive;
+        snapshot.grid = grid;
+        snapshot.bag = TesseraBag.captureState();
+        snapshot.piece = activePiece.captureState();
+        snapshot.heldPiece = heldPiece;
+        snapshot.hasHeldPiece = hasHeldPiece;
+        snapshot.canUseHold = canUseHold;
+        snapshot.currentPieceRotations = currentPieceRotations;
+        snapshot.totalLinesCleared = totalLinesCleared;
+        snapshot.currentLevel = currentLevel;
+        snapshot.totalScore = totalScore;
+        snapshot.currentCombo = currentCombo;
+        snapshot.maxComboThisGame = maxComboThisGame;
+        snapshot.lastMoveScore = lastMoveScore;
+        snapshot.totalHardDropScore = totalHardDropScore;
+        snapshot.totalLineScore = totalLineScore;
+        snapshot.totalComboScore = totalComboScore;
+        snapshot.bombUsedThisGame = bombUsedThisGame;
+        snapshot.consecutiveBombsUsed = consecutiveBombsUsed;
+        snapshot.linesSinceLastAbility = linesSinceLastAbility;
+        snapshot.bombAbilityAvailable = bombAbilityAvailable;
+        snapshot.deliveryAbilityAvailable = deliveryAbilityAvailable;
+        snapshot.stompAbilityAvailable = stompAbilityAvailable;
+        snapshot.lastCreamBlockX = lastCreamBlockX;
+        snapshot.sprintTimer = sprintTimer;
+        snapshot.sprintTargetLines = sprintTargetLines;
+        snapshot.autoDropTimer = autoDropTimer;
+        snapshot.gravityFlipped = gravityFlipped;
+        snapshot.gravityFlipPieceCount = gravityFlipPieceCount;
+        snapshot.sessionPlayTime = sessionPlayTime;
+        snapshot.sessionPiecesPlaced = sessionPiecesPlaced;
+        return snapshot;
+    };
+    
+    auto restoreGameSnapshot = [&](const GameSnapshot& snapshot) {
+        TesseraBag.restoreState(snapshot.bag);
+        grid = snapshot.grid;
+        activePiece.restoreState(snapshot.piece);
+        heldPiece = snapshot.heldPiece;
+        hasHeldPiece = snapshot.hasHeldPiece;
+        canUseHold = snapshot.canUseHold;
+        currentPieceRotations = snapshot.currentPieceRotations;
+        totalLinesCleared = snapshot.totalLinesCleared;
+        currentLevel = snapshot.currentLevel;
+        totalScore = snapshot.totalScore;
+        currentCombo = snapshot.currentCombo;
+        displayCombo = static_cast<float>(currentCombo);
+        maxComboThisGame = snapshot.maxComboThisGame;
+        lastMoveScore = snapshot.lastMoveScore;
+        totalHardDropScore = snapshot.totalHardDropScore;
+        totalLineScore = snapshot.totalLineScore;
+        totalComboScore = snapshot.totalComboScore;
+        bombUsedThisGame = snapshot.bombUsedThisGame;
+        consecutiveBombsUsed = snapshot.consecutiveBombsUsed;
+        linesSinceLastAbility = snapshot.linesSinceLastAbility;
+        bombAbilityAvailable = snapshot.bombAbilityAvailable;
+        deliveryAbilityAvailable = snapshot.deliveryAbilityAvailable;
+        stompAbilityAvailable = snapshot.stompAbilityAvailable;
+        lastCreamBlockX = snapshot.lastCreamBlockX;
+        sprintTimer = snapshot.sprintTimer;
+        sprintTargetLines = snapshot.sprintTargetLines;
+        autoDropTimer = snapshot.autoDropTimer;
+        gravityFlipped = snapshot.gravityFlipped;
+        gravityFlipPieceCount = snapshot.gravityFlipPieceCount;
+        sessionPlayTime = snapshot.sessionPlayTime;
+        sessionPiecesPlaced = snapshot.sessionPiecesPlaced;
+    };
+    
+
+    PracticeUndoHistory practiceUndo;
+    
+    // Called after every piece that spawns because the previous one locked.
+    auto recordPracticePlacement = [&]() {
+        if (practiceModeActive && !gameOver) {
+            practiceUndo.record(captureGameSnapshot());
+        }
+    };
+
+    // Rotation, hold and hard drop reach the game through the input timeline
+    // like shifts do, so every input applies in the order it was pressed.
+    auto rotateActivePiece = [&](bool clockwise) {
+        bool canRotate = true;
+        if (challengeModeActive && selectedChallengeMode == ChallengeMode::OneRot) {
+            canRotate = (currentPieceRotations < 1);
+        }
+        
+
+        if (activePiece.getType() == PieceType::A_Stomp) {
+            canRotate = false;
+        }
+        if (gameOver || !canRotate) return;
+
+        if (clockwise) {
+            activePiece.rotateRight(grid);
+        } else {
+            activePiece.rotateLeft(grid);
+        }
+        pieceRotationCount++;
+        saveData.totalRotations++;
+        if (challengeModeActive && selectedChallengeMode == ChallengeMode::OneRot) {
+            currentPieceRotations++;
+        }
+    };
+
+    auto holdActivePiece = [&]() {
+        if (!canUseHold || gameOver) return;
+
+        if (challengeModeActive && selectedChallengeMode == ChallengeMode::AutoDrop) {
+            autoDropTimer = 0.0f;
+        }
+        
+        if (!hasHeldPiece) {
+
+            heldPiece = activePiece.getType();
+            hasHeldPiece = true;
+            
+
+            saveData.totalHolds++;
+            pieceHoldUsed = true;
+            pieceFinesseInputs = 0;
+            
+
+            achievementEngine.onPieceHeld(heldPiece, !challengeModeActive && !practiceModeActive);
+            
+            PieceType newType = TesseraBag.getNextPiece();
+            std::cout << "HOLD: Stored " << pieceTypeToString(heldPiece) << ", spawning " << pieceTypeToString(newType) << std::endl;
+            PieceShape newShape = getPieceShape(newType);
+            int spawnX = (GRID_WIDTH - newShape.width) / 2;
+            int firstFilledRow = findFirstFilledRow(newShape);
+            int spawnY = -firstFilledRow;
+            
+
+            if (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) {
+                spawnY = GRID_HEIGHT / 2 - newShape.height / 2;
+            }
+            
+
+            Piece testPiece(spawnX, spawnY, newType);
+            if (testPiece.collidesAt(grid, spawnX, spawnY)) {
+                std::cout << "HOLD BLOCKED: Cannot spawn " << pieceTypeToString(newType) << " - would cause game over!" << std::endl;
+                hasHeldPiece = false;
+                canUseHold = false;
+                return;
+            }
+            
+            activePiece = Piece(spawnX, spawnY, newType);
+            
+
+            if (currentConfig && currentConfig->useTypeBasedColors && !currentConfig->colorPalette.empty()) {
+                int colorIndex = getColorIndexForPieceType(newType);
+                if (colorIndex < static_cast<int>(currentConfig->colorPalette.size())) {
+                    activePiece.setColor(currentConfig->colorPalette[colorIndex]);
+                }
+            } else if (currentConfig && currentConfig->useRandomColorPalette && !currentConfig->colorPalette.empty()) {
+                int randomIndex = rand() % currentConfig->colorPalette.size();
+                activePiece.setColor(currentConfig->colorPalette[randomIndex]);
+            }
+        } else {
+
+            PieceType currentType = activePiece.getType();
+            PieceType swapType = heldPiece;
+            
+
+            saveData.totalHolds++;
+            pieceHoldUsed = true;
+            pieceFinesseInputs = 0;
+            
+
+            achievementEngine.onPieceHeld(currentType, !challengeModeActive && !practiceModeActive);
+            
+            std::cout << "SWAP: " << pieceTypeToString(currentType) << " <-> " << pieceTypeToString(swapType) << std::endl;
+            PieceShape swapShape = getPieceShape(swapType);
+            int spawnX = (GRID_WIDTH - swapShape.width) / 2;
+            int firstFilledRow = findFirstFilledRow(swapShape);
+            int spawnY = -firstFilledRow;
+            
+
+            if (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) {
+                spawnY = GRID_HEIGHT / 2 - swapShape.height / 2;
+            }
+            
+
+            Piece testPiece(spawnX, spawnY, swapType);
+            if (testPiece.collidesAt(grid, spawnX, spawnY)) {
+                std::cout << "SWAP BLOCKED: Cannot spawn " << pieceTypeToString(swapType) << " from hold - would cause game over!" << std::endl;
+                canUseHold = false;
+                return;
+            }
+            
+            heldPiece = currentType;
+            activePiece = Piece(spawnX, spawnY, swapType);
+            
+
+            if (currentConfig && currentConfig->useTypeBasedColors && !currentConfig->colorPalette.empty()) {
+                int colorIndex = getColorIndexForPieceType(swapType);
+                if (colorIndex < static_cast<int>(currentConfig->colorPalette.size())) {
+                    activePiece.setColor(currentConfig->colorPalette[colorIndex]);
+                }
+            } else if (currentConfig && currentConfig->useRandomColorPalette && !currentConfig->colorPalette.empty()) {
+                int randomIndex = rand() % currentConfig->colorPalette.size();
+                activePiece.setColor(currentConfig->colorPalette[randomIndex]);
+            }
+        }
+        
+        canUseHold = false;
+    };
+
+    auto hardDropActivePiece = [&]() {
+        if (gameOver || hardDropCooldown > 0.0f) return;
+
+        if (activePiece.getAbility() == AbilityType::Bomb) {
+
+            if (challengeModeActive && selectedChallengeMode == ChallengeMode::AutoDrop) {
+                autoDropTimer = 0.0f;
+            }
+            
+            std::cout << "BOMB EXPLOSION TRIGGERED!" << std::endl;
+            
+
+            consecutiveBombsUsed++;
+            std::cout << "[BOMB] Consecutive explosions: " << consecutiveBombsUsed << "/3" << std::endl;
+            
+            achievementEngine.onBombExploded(consecutiveBombsUsed, !challengeModeActive && !practiceModeActive);
+            
+            int bombCenterX = activePiece.getX();
+            int bombCenterY = activePiece.getY();
+            
+
+            for (int dy = -2; dy <= 2; ++dy) {
+                for (int dx = -2; dx <= 2; ++dx) {
+                    int x = bombCenterX + dx;
+                    int y = bombCenterY + dy;
+                    if (x >= 0 && x < GRID_WIDTH && y >= 0 && y < GRID_HEIGHT) {
+                        sf::Color blockColor = grid[y][x].occupied ? grid[y][x].color : sf::Color(200, 200, 200);
+                        
+                        grid[y][x] = Cell();
+                        
+
+                        float explosionX = GRID_OFFSET_X + x * CELL_SIZE;
+                        float explosionY = GRID_OFFSET_Y + y * CELL_SIZE;
+                        float explosionRotation = static_cast<float>(rand() % 360);
+                        
+                        explosionEffects.push_back(ExplosionEffect(explosionX, explosionY, explosionRotation, 0.0f));
+                        
+                        float offsetX = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 20.0f;
+                        float offsetY = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 20.0f;
+                        float glowRotation = static_cast<float>(rand() % 360);
+                        
+                        glowEffects.push_back(GlowEffect(explosionX + offsetX, explosionY + offsetY, blockColor, glowRotation));
+                    }
+                }
+            }
+            
+            shakeIntensity = 15.0f;
+            shakeDuration = 0.4f;
+            shakeTimer = 0.0f;
+            
+            audioManager.playBombSound();
+            
+
+            int minX = std::max(0, bombCenterX - 2);
+            int maxX = std::min(GRID_WIDTH - 1, bombCenterX + 2);
+            int minY = std::max(0, bombCenterY - 2);
+            int maxY = std::min(GRID_HEIGHT - 1, bombCenterY + 2);
+            
+            for (int col = minX; col <= maxX; ++col) {
+                for (int row = minY - 1; row >= 0; --row) {
+                    if (grid[row][col].occupied) {
+                        int fallRow = row;
+                        
+                        while (fallRow + 1 < GRID_HEIGHT && !grid[fallRow + 1][col].occupied) {
+                            fallRow++;
+                        }
+                        
+                        if (fallRow != row) {
+                            grid[fallRow][col] = grid[row][col];
+                            grid[row][col] = Cell();
+                        }
+                    }
+                }
+            }
+            
+
+            int clearedLines;
+            bool isPetrifyMode = challengeModeActive && selectedChallengeMode == ChallengeMode::Petrify;
+            bool isRaceMode = sprintModeActive || challengeModeActive;
+            if (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) {
+                clearedLines = clearFullLinesGravityFlip(grid, audioManager, &glowEffects, &shakeIntensity, &shakeDuration, &shakeTimer);
+            } else {
+                clearedLines = clearFullLines(grid, audioManager, &glowEffects, &shakeIntensity, &shakeDuration, &shakeTimer, isPetrifyMode, isRaceMode ? &thermometerParticles : nullptr, isRaceMode);
+            }
+            
+
+            if (isPetrifyMode) {
+                updatePetrifyCounters(grid);
+            }
+            if (clearedLines > 0) {
+                totalLinesCleared += clearedLines;
+                clearTypeCounts[getClearTypeIndex(clearedLines)]++;
+                
+                int fullScore = calculateScore(clearedLines);
+                int baseScore = clearedLines * 1000;
+                int lineBonus = fullScore - baseScore;
+                int comboBonus = currentCombo * COMBO_BONUS_PER_LINE * clearedLines;
+                int bombLineScore = fullScore + comboBonus;
+                totalScore += bombLineScore;
+                totalLineScore += baseScore;
+                totalComboScore += lineBonus + comboBonus;
+                lastMoveScore = bombLineScore;
+                
+                currentCombo += clearedLines;
+                
+                achievementEngine.onLinesCleared(clearedLines, currentCombo, !challengeModeActive && !practiceModeActive);
+                
+                if (currentCombo > maxComboThisGame) {
+                    maxComboThisGame = currentCombo;
+                }
+                
+                std::cout << "Bomb cleared " << clearedLines << " lines! Base: " << baseScore << " | Combo: x" << (currentCombo - clearedLines) << " (+" << comboBonus << ") | Total: +" << bombLineScore << std::endl;
+                
+                linesSinceLastAbility += clearedLines;
+                if (selectedAbilityChoice == AbilityChoice::Bomb && linesSinceLastAbility >= LINES_FOR_BOMB) {
+                    bombAbilityAvailable = true;
+                    std::cout << "BOMB ABILITY READY AGAIN!" << std::endl;
+                } else if (selectedAbilityChoice == AbilityChoice::Delivery && linesSinceLastAbility >= LINES_FOR_DELIVERY) {
+                    deliveryAbilityAvailable = true;
+                    std::cout << "DELIVERY ABILITY READY AGAIN!" << std::endl;
+                } else if (selectedAbilityChoice == AbilityChoice::Stomp && linesSinceLastAbility >= LINES_FOR_STOMP) {
+                    stompAbilityAvailable = true;
+                    std::cout << "STOMP ABILITY READY AGAIN!" << std::endl;
+                }
+            } else {
+                lastMoveScore = 0;
+            }
+            
+
+            PieceType newType = TesseraBag.getNextPiece();
+            std::cout << "Spawning new piece after explosion: " << pieceTypeToString(newType) << std::endl;
+            PieceShape newShape = getPieceShape(newType);
+            int spawnX = (GRID_WIDTH - newShape.width) / 2;
+            int firstFilledRow = findFirstFilledRow(newShape);
+            int spawnY = -firstFilledRow;
+            activePiece = Piece(spawnX, spawnY, newType);
+            
+
+            if (currentConfig && currentConfig->useTypeBasedColors && !currentConfig->colorPalette.empty()) {
+                int colorIndex = getColorIndexForPieceType(newType);
+                if (colorIndex < static_cast<int>(currentConfig->colorPalette.size())) {
+                    activePiece.setColor(currentConfig->colorPalette[colorIndex]);
+                }
+            } else if (currentConfig && currentConfig->useRandomColorPalette && !currentConfig->colorPalette.empty()) {
+                int randomIndex = rand() % currentConfig->colorPalette.size();
+                activePiece.setColor(currentConfig->colorPalette[randomIndex]);
+            }
+            canUseHold = true;
+            recordPracticePlacement();
+        } else {
+
+            bool useGravityFlipForDrop = (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) ? gravityFlipped : false;
+            int dropDistance = activePiece.moveGround(grid, useGravityFlipForDrop);
+            pieceDropDistance = dropDistance;
+            int dropPoints = dropDistance * HARD_DROP_POINTS_PER_CELL;
+            totalScore += dropPoints;
+            totalHardDropScore += dropPoints;
+            std::cout << "Hard drop: " << dropDistance << " cells = +" << dropPoints << " points" << std::endl;
+            audioManager.playDropSound();
+        }
+    };
+    
+
+    GameSnapshot suspendedGame;
+    if (loadGameSnapshot(suspendedGame)) {
+        selectedGameModeOption = suspendedGame.mode;
+        selectedClassicDifficulty = suspendedGame.classicDifficulty;
+        selectedSprintLines = suspendedGame.sprintLines;
+        selectedChallengeMode = suspendedGame.challengeMode;
+        selectedPracticeDifficulty = suspendedGame.practiceDifficulty;
+        selectedPracticeLineGoal = suspendedGame.practiceLineGoal;
+        practiceInfiniteBombs = suspendedGame.practiceInfiniteBombs;
+        selectedThemeChoice = suspendedGame.themeChoice;
+        sprintModeActive = suspendedGame.sprintModeActive;
+        challengeModeActive = suspendedGame.challengeModeActive;
+        practiceModeActive = suspendedGame.practiceModeActive;
+        
+        currentConfig = getDifficultyConfig(
+            selectedGameModeOption,
+            selectedClassicDifficulty,
+            selectedSprintLines,
+            selectedChallengeMode,
+            selectedPracticeDifficulty,
+            selectedPracticeLineGoal,
+            practiceInfiniteBombs
+        );
+        TesseraBag.setDifficultyConfig(currentConfig);
+        restoreGameSnapshot(suspendedGame);
+        historyFinalBoard.fill(0);
+        suspendedGameOnDisk = true;
+        
+
+        applyGameTheme(currentTheme, audioManager, selectedGameModeOption, selectedClassicDifficulty, selectedChallengeMode, selectedThemeChoice);
+        pumpAssetLoader(true);
+        gameState = GameState::Paused;
+        selectedPauseOption = PauseOption::Resume;
+        showCustomCursor = true;
+        std::cout << "Resumed suspended game (" << totalScore << " points, " << totalLinesCleared << " lines)" << std::endl;
+    }
     sf::Clock clock;
     bool firstFrame = true;
+    bool firstFramePresented = false;
+    // OS key repeat resends KeyPressed while a key is held, so per-piece input
+    // counts only take presses whose key was up before.
+    std::array<bool, sf::Keyboard::KeyCount> keysDown{};
     while (window.isOpen()) {
+        TraceZone frameZone("frame");
         float deltaTime = clock.restart().asSeconds();
         if (firstFrame) { window.requestFocus(); firstFrame = false; }
+        TraceZone loadingZone("asset uploads");
+        pumpAssetLoader(false);
+        glyphPrewarmer.step(GLYPH_PREWARM_FRAME_BUDGET);
+        loadingZone.finish();
+        TraceZone eventsZone("events");
         while (auto event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) { window.close(); }
             
+            bool keyRepeated = false;
+            if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>()) {
+                int keyIndex = static_cast<int>(keyPressed->code);
+                if (keyIndex >= 0 && keyIndex < sf::Keyboard::KeyCount) {
+                    keyRepeated = keysDown[keyIndex];
+                    keysDown[keyIndex] = true;
+                }
+            } else if (const auto* keyReleased = event->getIf<sf::Event::KeyReleased>()) {
+                int keyIndex = static_cast<int>(keyReleased->code);
+                if (keyIndex >= 0 && keyIndex < sf::Keyboard::KeyCount) {
+                    keysDown[keyIndex] = false;
+                }
+            } else if (event->is<sf::Event::FocusLost>()) {
+                keysDown.fill(false);
+            }
+            
+            if (gameState == GameState::Playing) {
+                auto movementAction = [&](sf::Keyboard::Key key, InputAction& action) {
+                    if (key == keyBindings.moveLeft) action = InputAction::MoveLeft;
+                    else if (key == keyBindings.moveRight) action = InputAction::MoveRight;
+                    else if (key == keyBindings.quickFall) action = InputAction::SoftDrop;
+                    else return false;
+                    return true;
+                };
+                InputAction action;
+                if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>()) {
+                    if (movementAction(keyPressed->code, action)) inputTimeline.press(action, inputTimeline.now());
+                } else if (const auto* keyReleased = event->getIf<sf::Event::KeyReleased>()) {
+                    if (movementAction(keyReleased->code, action)) inputTimeline.release(action, inputTimeline.now());
+                }
+            }
+            
 
             if (event->is<sf::Event::MouseMoved>()) {
                 if (gameState != GameState::SplashScreen && gameState != GameState::Playing) {
@@ -1660,6 +2011,7 @@ int main(int argc, char* argv[]) {
                     if (gameState == GameState::SplashScreen) {
 
                         constexpr int CURRENT_SETUP_VERSION = 1;
+                        pumpAssetLoader(true);
                         audioManager.stopAllMusic();
                         if (saveData.setupVersion < CURRENT_SETUP_VERSION) {
                             gameState = GameState::FirstTimeSetup;
@@ -1767,7 +2119,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             
 
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
@@ -1829,7 +2181,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
                         else {
@@ -1960,7 +2312,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
                         else {
@@ -2105,11 +2457,7 @@ int main(int argc, char* argv[]) {
                             explosionEffects.clear();
                             glowEffects.clear();
                             thermometerParticles.clear();
-                            leftHoldTime = 0.0f;
-                            rightHoldTime = 0.0f;
-                            dasTimer = 0.0f;
-                            leftPressed = false;
-                            rightPressed = false;
+                            inputTimeline.reset();
                             
                             PieceType firstType = TesseraBag.getNextPiece();
                             PieceShape firstShape = getPieceShape(firstType);
@@ -2231,11 +2579,7 @@ int main(int argc, char* argv[]) {
                         explosionEffects.clear();
                         glowEffects.clear();
                             thermometerParticles.clear();
-                        leftHoldTime = 0.0f;
-                        rightHoldTime = 0.0f;
-                        dasTimer = 0.0f;
-                        leftPressed = false;
-                        rightPressed = false;
+                        inputTimeline.reset();
                         
                         PieceType startType = TesseraBag.getNextPiece();
                         PieceShape startShape = getPieceShape(startType);
@@ -2280,7 +2624,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
                         else {
@@ -2327,7 +2671,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
                         else {
@@ -2428,7 +2772,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
 
@@ -2445,7 +2789,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
 
@@ -2462,7 +2806,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
 
@@ -2531,11 +2875,7 @@ int main(int argc, char* argv[]) {
                             explosionEffects.clear();
                             glowEffects.clear();
                             thermometerParticles.clear();
-                            leftHoldTime = 0.0f;
-                            rightHoldTime = 0.0f;
-                            dasTimer = 0.0f;
-                            leftPressed = false;
-                            rightPressed = false;
+                            inputTimeline.reset();
                             
                             PieceType startType = TesseraBag.getNextPiece();
                             PieceShape startShape = getPieceShape(startType);
@@ -2561,6 +2901,7 @@ int main(int argc, char* argv[]) {
                             audioManager.playMenuClickSound();
                             audioManager.switchToMenuMusic();
                             
+                            DISCARD_SUSPENDED_GAME();
                             gameState = GameState::MainMenu;
                             selectedMenuOption = MenuOption::Start;
                             std::cout << "Returned to main menu (mouse)" << std::endl;
@@ -2578,7 +2919,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         } else {
 
@@ -2689,11 +3030,7 @@ int main(int argc, char* argv[]) {
                                 explosionEffects.clear();
                                 glowEffects.clear();
                                 thermometerParticles.clear();
-                                leftHoldTime = 0.0f;
-                                rightHoldTime = 0.0f;
-                                dasTimer = 0.0f;
-                                leftPressed = false;
-                                rightPressed = false;
+                                inputTimeline.reset();
                                 
                                 PieceType startType = TesseraBag.getNextPiece();
                                 PieceShape startShape = getPieceShape(startType);
@@ -2729,7 +3066,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         } else {
 
@@ -2803,11 +3140,7 @@ int main(int argc, char* argv[]) {
                                     explosionEffects.clear();
                                     glowEffects.clear();
                             thermometerParticles.clear();
-                                    leftHoldTime = 0.0f;
-                                    rightHoldTime = 0.0f;
-                                    dasTimer = 0.0f;
-                                    leftPressed = false;
-                                    rightPressed = false;
+                                    inputTimeline.reset();
                                     
                                     PieceType startType = TesseraBag.getNextPiece();
                                     PieceShape startShape = getPieceShape(startType);
@@ -2846,7 +3179,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         } else {
 
@@ -2929,11 +3262,7 @@ int main(int argc, char* argv[]) {
                                     explosionEffects.clear();
                                     glowEffects.clear();
                             thermometerParticles.clear();
-                                    leftHoldTime = 0.0f;
-                                    rightHoldTime = 0.0f;
-                                    dasTimer = 0.0f;
-                                    leftPressed = false;
-                                    rightPressed = false;
+                                    inputTimeline.reset();
                                     
                                     PieceType startType = TesseraBag.getNextPiece();
                                     PieceShape startShape = getPieceShape(startType);
@@ -3119,7 +3448,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
                     } else if (gameState == GameState::ConfirmClearScores) {
@@ -3135,7 +3464,7 @@ int main(int argc, char* argv[]) {
                             const auto& bomb = backgroundPieces[clickedBombIndex];
                             explodeMenuBomb(bomb, explosionEffects, glowEffects, audioManager, 
                                           shakeIntensity, shakeDuration, shakeTimer, 
-                                          saveData, achievementPopups);
+                                          achievementEngine);
                             backgroundPieces.erase(backgroundPieces.begin() + clickedBombIndex);
                         }
 
@@ -3179,6 +3508,7 @@ int main(int argc, char* argv[]) {
                 if (gameState == GameState::SplashScreen) {
 
                     constexpr int CURRENT_SETUP_VERSION = 1;
+                    pumpAssetLoader(true);
                     audioManager.stopAllMusic();
                     if (saveData.setupVersion < CURRENT_SETUP_VERSION) {
                         gameState = GameState::FirstTimeSetup;
@@ -3265,6 +3595,15 @@ int main(int argc, char* argv[]) {
                         case sf::Keyboard::Key::Escape: 
                             window.close(); 
                             break;
+                        case sf::Keyboard::Key::Tab:
+                            profileManager.requestNextProfile();
+                            break;
+                        case sf::Keyboard::Key::N:
+                            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
+                                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl)) {
+                                profileManager.requestNewProfile();
+                            }
+                            break;
                         case sf::Keyboard::Key::D:
                             if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) || 
                                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl)) {
@@ -3381,11 +3720,7 @@ int main(int argc, char* argv[]) {
                                 explosionEffects.clear();
                                 glowEffects.clear();
                             thermometerParticles.clear();
-                                leftHoldTime = 0.0f;
-                                rightHoldTime = 0.0f;
-                                dasTimer = 0.0f;
-                                leftPressed = false;
-                                rightPressed = false;
+                                inputTimeline.reset();
                                 
                                 PieceType startType = TesseraBag.getNextPiece();
                                 PieceShape startShape = getPieceShape(startType);
@@ -3408,6 +3743,7 @@ int main(int argc, char* argv[]) {
                                 audioManager.playMenuClickSound();
                                 audioManager.switchToMenuMusic();
                                 
+                                DISCARD_SUSPENDED_GAME();
                                 gameState = GameState::MainMenu;
                                 selectedMenuOption = MenuOption::Start;
                                 std::cout << "Returned to main menu" << std::endl;
@@ -3896,11 +4232,7 @@ int main(int argc, char* argv[]) {
                             explosionEffects.clear();
                             glowEffects.clear();
                             thermometerParticles.clear();
-                            leftHoldTime = 0.0f;
-                            rightHoldTime = 0.0f;
-                            dasTimer = 0.0f;
-                            leftPressed = false;
-                            rightPressed = false;
+                            inputTimeline.reset();
                             PieceType startType = TesseraBag.getNextPiece();
                             PieceShape startShape = getPieceShape(startType);
                             int startX = (GRID_WIDTH - startShape.width) / 2;
@@ -4038,11 +4370,7 @@ int main(int argc, char* argv[]) {
                             explosionEffects.clear();
                             glowEffects.clear();
                             thermometerParticles.clear();
-                            leftHoldTime = 0.0f;
-                            rightHoldTime = 0.0f;
-                            dasTimer = 0.0f;
-                            leftPressed = false;
-                            rightPressed = false;
+                            inputTimeline.reset();
                             PieceType startType = TesseraBag.getNextPiece();
                             PieceShape startShape = getPieceShape(startType);
                             int startX = (GRID_WIDTH - startShape.width) / 2;
@@ -4236,11 +4564,7 @@ int main(int argc, char* argv[]) {
                             explosionEffects.clear();
                             glowEffects.clear();
                             thermometerParticles.clear();
-                            leftHoldTime = 0.0f;
-                            rightHoldTime = 0.0f;
-                            dasTimer = 0.0f;
-                            leftPressed = false;
-                            rightPressed = false;
+                            inputTimeline.reset();
                             PieceType startType = TesseraBag.getNextPiece();
                             PieceShape startShape = getPieceShape(startType);
                             int startX = (GRID_WIDTH - startShape.width) / 2;
@@ -4398,11 +4722,7 @@ int main(int argc, char* argv[]) {
                                 explosionEffects.clear();
                                 glowEffects.clear();
                             thermometerParticles.clear();
-                                leftHoldTime = 0.0f;
-                                rightHoldTime = 0.0f;
-                                dasTimer = 0.0f;
-                                leftPressed = false;
-                                rightPressed = false;
+                                inputTimeline.reset();
                                 
                                 PieceType startType = TesseraBag.getNextPiece();
                                 PieceShape startShape = getPieceShape(startType);
@@ -4911,6 +5231,7 @@ int main(int argc, char* argv[]) {
                             audioManager.playMenuClickSound();
 
                             deleteSaveFile();
+                            gameHistory.clear();
                             
 
                             saveData.highScore = 0;
@@ -4937,6 +5258,7 @@ int main(int argc, char* argv[]) {
                             for (int i = 0; i < TOTAL_ACHIEVEMENTS; i++) {
                                 saveData.achievements[i] = false;
                             }
+                            achievementEngine.sync(saveData);
 
                             for (int i = 0; i < 3; i++) {
                                 saveData.topScores[i].score = 0;
@@ -4952,6 +5274,10 @@ int main(int argc, char* argv[]) {
                                 saveData.topScoresHard[i].level = 0;
                             }
                             
+                            for (int i = 0; i < MODE_STATS_SLOTS; i++) {
+                                saveData.modeStats[i] = ModeStats();
+                            }
+                            
                             std::cout << "Save file deleted and all data cleared!" << std::endl;
                             gameState = GameState::OptionsSelection;
                             break;
@@ -4961,310 +5287,24 @@ int main(int argc, char* argv[]) {
                 } else if (gameState == GameState::Playing) {
                 
 
-                bool canRotate = true;
-                if (challengeModeActive && selectedChallengeMode == ChallengeMode::OneRot) {
-                    canRotate = (currentPieceRotations < 1);
-                }
-                
-
-                if (activePiece.getType() == PieceType::A_Stomp) {
-                    canRotate = false;
+                if (!gameOver && !keyRepeated && (keyPressed->code == keyBindings.moveLeft || keyPressed->code == keyBindings.moveRight ||
+                                  keyPressed->code == keyBindings.rotateLeft || keyPressed->code == keyBindings.rotateRight ||
+                                  keyPressed->code == keyBindings.quickFall || keyPressed->code == keyBindings.drop ||
+                                  keyPressed->code == keyBindings.hold)) {
+                    pieceInputCount++;
+                    if (keyPressed->code != keyBindings.drop && keyPressed->code != keyBindings.hold) {
+                        pieceFinesseInputs++;
+                    }
                 }
                 
                 if (keyPressed->code == keyBindings.rotateLeft) {
-                    if (!gameOver && canRotate) {
-                        activePiece.rotateLeft(grid);
-                        saveData.totalRotations++;
-                        if (challengeModeActive && selectedChallengeMode == ChallengeMode::OneRot) {
-                            currentPieceRotations++;
-                        }
-                    }
+                    inputTimeline.trigger(InputAction::RotateLeft, inputTimeline.now());
                 } else if (keyPressed->code == keyBindings.rotateRight) {
-                    if (!gameOver && canRotate) {
-                        activePiece.rotateRight(grid);
-                        saveData.totalRotations++;
-                        if (challengeModeActive && selectedChallengeMode == ChallengeMode::OneRot) {
-                            currentPieceRotations++;
-                        }
-                    }
+                    inputTimeline.trigger(InputAction::RotateRight, inputTimeline.now());
                 } else if (keyPressed->code == keyBindings.hold) {
-                    if (!canUseHold || gameOver) {
-                        
-                    } else {
-
-                        if (challengeModeActive && selectedChallengeMode == ChallengeMode::AutoDrop) {
-                            autoDropTimer = 0.0f;
-                        }
-                        
-                        if (!hasHeldPiece) {
-
-                            heldPiece = activePiece.getType();
-                            hasHeldPiece = true;
-                            
-
-                            saveData.totalHolds++;
-                            
-
-                            if (heldPiece == PieceType::A_Bomb && !challengeModeActive && !practiceModeActive) {
-                                unlockAchievement(saveData, Achievement::HoldBomb, &achievementPopups, &audioManager);
-                            }
-                            
-                            PieceType newType = TesseraBag.getNextPiece();
-                            std::cout << "HOLD: Stored " << pieceTypeToString(heldPiece) << ", spawning " << pieceTypeToString(newType) << std::endl;
-                            PieceShape newShape = getPieceShape(newType);
-                            int spawnX = (GRID_WIDTH - newShape.width) / 2;
-                            int firstFilledRow = findFirstFilledRow(newShape);
-                            int spawnY = -firstFilledRow;
-                            
-
-                            if (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) {
-                                spawnY = GRID_HEIGHT / 2 - newShape.height / 2;
-                            }
-                            
-
-                            Piece testPiece(spawnX, spawnY, newType);
-                            if (testPiece.collidesAt(grid, spawnX, spawnY)) {
-                                std::cout << "HOLD BLOCKED: Cannot spawn " << pieceTypeToString(newType) << " - would cause game over!" << std::endl;
-                                hasHeldPiece = false;
-                                canUseHold = false;
-                                break;
-                            }
-                            
-                            activePiece = Piece(spawnX, spawnY, newType);
-                            
-
-                            if (currentConfig && currentConfig->useTypeBasedColors && !currentConfig->colorPalette.empty()) {
-                                int colorIndex = getColorIndexForPieceType(newType);
-                                if (colorIndex < static_cast<int>(currentConfig->colorPalette.size())) {
-                                    activePiece.setColor(currentConfig->colorPalette[colorIndex]);
-                                }
-                            } else if (currentConfig && currentConfig->useRandomColorPalette && !currentConfig->colorPalette.empty()) {
-                                int randomIndex = rand() % currentConfig->colorPalette.size();
-                                activePiece.setColor(currentConfig->colorPalette[randomIndex]);
-                            }
-                        } else {
-
-                            PieceType currentType = activePiece.getType();
-                            PieceType swapType = heldPiece;
-                            
-
-                            saveData.totalHolds++;
-                            
-
-                            if (currentType == PieceType::A_Bomb && !challengeModeActive && !practiceModeActive) {
-                                unlockAchievement(saveData, Achievement::HoldBomb, &achievementPopups, &audioManager);
-                            }
-                            
-                            std::cout << "SWAP: " << pieceTypeToString(currentType) << " <-> " << pieceTypeToString(swapType) << std::endl;
-                            PieceShape swapShape = getPieceShape(swapType);
-                            int spawnX = (GRID_WIDTH - swapShape.width) / 2;
-                            int firstFilledRow = findFirstFilledRow(swapShape);
-                            int spawnY = -firstFilledRow;
-                            
-
-                            if (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) {
-                                spawnY = GRID_HEIGHT / 2 - swapShape.height / 2;
-                            }
-                            
-
-                            Piece testPiece(spawnX, spawnY, swapType);
-                            if (testPiece.collidesAt(grid, spawnX, spawnY)) {
-                                std::cout << "SWAP BLOCKED: Cannot spawn " << pieceTypeToString(swapType) << " from hold - would cause game over!" << std::endl;
-                                canUseHold = false;
-                                break;
-                            }
-                            
-                            heldPiece = currentType;
-                            activePiece = Piece(spawnX, spawnY, swapType);
-                            
-
-                            if (currentConfig && currentConfig->useTypeBasedColors && !currentConfig->colorPalette.empty()) {
-                                int colorIndex = getColorIndexForPieceType(swapType);
-                                if (colorIndex < static_cast<int>(currentConfig->colorPalette.size())) {
-                                    activePiece.setColor(currentConfig->colorPalette[colorIndex]);
-                                }
-                            } else if (currentConfig && currentConfig->useRandomColorPalette && !currentConfig->colorPalette.empty()) {
-                                int randomIndex = rand() % currentConfig->colorPalette.size();
-                                activePiece.setColor(currentConfig->colorPalette[randomIndex]);
-                            }
-                        }
-                        
-                        canUseHold = false;
-                    }
+                    inputTimeline.trigger(InputAction::Hold, inputTimeline.now());
                 } else if (keyPressed->code == keyBindings.drop) {
-                    if (!gameOver && hardDropCooldown <= 0.0f) {
-
-                        if (activePiece.getAbility() == AbilityType::Bomb) {
-
-                            if (challengeModeActive && selectedChallengeMode == ChallengeMode::AutoDrop) {
-                                autoDropTimer = 0.0f;
-                            }
-                            
-                            std::cout << "BOMB EXPLOSION TRIGGERED!" << std::endl;
-                            
-
-                            consecutiveBombsUsed++;
-                            std::cout << "[BOMB] Consecutive explosions: " << consecutiveBombsUsed << "/3" << std::endl;
-                            
-                            if (consecutiveBombsUsed >= 3 && !challengeModeActive && !practiceModeActive) {
-                                std::cout << "[ACHIEVEMENT] UNLOCKING EXPLOSION!" << std::endl;
-                                unlockAchievement(saveData, Achievement::Explosion, &achievementPopups, &audioManager);
-                            }
-                            
-                            int bombCenterX = activePiece.getX();
-                            int bombCenterY = activePiece.getY();
-                            
-
-                            for (int dy = -2; dy <= 2; ++dy) {
-                                for (int dx = -2; dx <= 2; ++dx) {
-                                    int x = bombCenterX + dx;
-                                    int y = bombCenterY + dy;
-                                    if (x >= 0 && x < GRID_WIDTH && y >= 0 && y < GRID_HEIGHT) {
-                                        sf::Color blockColor = grid[y][x].occupied ? grid[y][x].color : sf::Color(200, 200, 200);
-                                        
-                                        grid[y][x] = Cell();
-                                        
-
-                                        float explosionX = GRID_OFFSET_X + x * CELL_SIZE;
-                                        float explosionY = GRID_OFFSET_Y + y * CELL_SIZE;
-                                        float explosionRotation = static_cast<float>(rand() % 360);
-                                        
-                                        explosionEffects.push_back(ExplosionEffect(explosionX, explosionY, explosionRotation, 0.0f));
-                                        
-                                        float offsetX = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 20.0f;
-                                        float offsetY = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 20.0f;
-                                        float glowRotation = static_cast<float>(rand() % 360);
-                                        
-                                        glowEffects.push_back(GlowEffect(explosionX + offsetX, explosionY + offsetY, blockColor, glowRotation));
-                                    }
-                                }
-                            }
-                            
-                            shakeIntensity = 15.0f;
-                            shakeDuration = 0.4f;
-                            shakeTimer = 0.0f;
-                            
-                            audioManager.playBombSound();
-                            
-
-                            int minX = std::max(0, bombCenterX - 2);
-                            int maxX = std::min(GRID_WIDTH - 1, bombCenterX + 2);
-                            int minY = std::max(0, bombCenterY - 2);
-                            int maxY = std::min(GRID_HEIGHT - 1, bombCenterY + 2);
-                            
-                            for (int col = minX; col <= maxX; ++col) {
-                                for (int row = minY - 1; row >= 0; --row) {
-                                    if (grid[row][col].occupied) {
-                                        int fallRow = row;
-                                        
-                                        while (fallRow + 1 < GRID_HEIGHT && !grid[fallRow + 1][col].occupied) {
-                                            fallRow++;
-                                        }
-                                        
-                                        if (fallRow != row) {
-                                            grid[fallRow][col] = grid[row][col];
-                                            grid[row][col] = Cell();
-                                        }
-                                    }
-                                }
-                            }
-                            
-
-                            int clearedLines;
-                            bool isPetrifyMode = challengeModeActive && selectedChallengeMode == ChallengeMode::Petrify;
-                            bool isRaceMode = sprintModeActive || challengeModeActive;
-                            if (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) {
-                                clearedLines = clearFullLinesGravityFlip(grid, audioManager, &glowEffects, &shakeIntensity, &shakeDuration, &shakeTimer);
-                            } else {
-                                clearedLines = clearFullLines(grid, audioManager, &glowEffects, &shakeIntensity, &shakeDuration, &shakeTimer, isPetrifyMode, isRaceMode ? &thermometerParticles : nullptr, isRaceMode);
-                            }
-                            
-
-                            if (isPetrifyMode) {
-                                updatePetrifyCounters(grid);
-                            }
-                            if (clearedLines > 0) {
-                                totalLinesCleared += clearedLines;
-                                
-                                int fullScore = calculateScore(clearedLines);
-                                int baseScore = clearedLines * 1000;
-                                int lineBonus = fullScore - baseScore;
-                                int comboBonus = currentCombo * COMBO_BONUS_PER_LINE * clearedLines;
-                                int bombLineScore = fullScore + comboBonus;
-                                totalScore += bombLineScore;
-                                totalLineScore += baseScore;
-                                totalComboScore += lineBonus + comboBonus;
-                                lastMoveScore = bombLineScore;
-                                
-                                currentCombo += clearedLines;
-                                
-
-                                if (!challengeModeActive && !practiceModeActive) {
-                                    if (currentCombo >= 12) {
-                                        unlockAchievement(saveData, Achievement::Combo10, &achievementPopups, &audioManager);
-                                    }
-                                    
-                                    if (clearedLines >= 5) {
-                                        unlockAchievement(saveData, Achievement::Combo5OneClear, &achievementPopups, &audioManager);
-                                    }
-                                    
-                                    if (clearedLines >= 6) {
-                                        unlockAchievement(saveData, Achievement::Combo6OneClear, &achievementPopups, &audioManager);
-                                    }
-                                }
-                                
-                                if (currentCombo > maxComboThisGame) {
-                                    maxComboThisGame = currentCombo;
-                                }
-                                
-                                std::cout << "Bomb cleared " << clearedLines << " lines! Base: " << baseScore << " | Combo: x" << (currentCombo - clearedLines) << " (+" << comboBonus << ") | Total: +" << bombLineScore << std::endl;
-                                
-                                linesSinceLastAbility += clearedLines;
-                                if (selectedAbilityChoice == AbilityChoice::Bomb && linesSinceLastAbility >= LINES_FOR_BOMB) {
-                                    bombAbilityAvailable = true;
-                                    std::cout << "BOMB ABILITY READY AGAIN!" << std::endl;
-                                } else if (selectedAbilityChoice == AbilityChoice::Delivery && linesSinceLastAbility >= LINES_FOR_DELIVERY) {
-                                    deliveryAbilityAvailable = true;
-                                    std::cout << "DELIVERY ABILITY READY AGAIN!" << std::endl;
-                                } else if (selectedAbilityChoice == AbilityChoice::Stomp && linesSinceLastAbility >= LINES_FOR_STOMP) {
-                                    stompAbilityAvailable = true;
-                                    std::cout << "STOMP ABILITY READY AGAIN!" << std::endl;
-                                }
-                            } else {
-                                lastMoveScore = 0;
-                            }
-                            
-
-                            PieceType newType = TesseraBag.getNextPiece();
-                            std::cout << "Spawning new piece after explosion: " << pieceTypeToString(newType) << std::endl;
-                            PieceShape newShape = getPieceShape(newType);
-                            int spawnX = (GRID_WIDTH - newShape.width) / 2;
-                            int firstFilledRow = findFirstFilledRow(newShape);
-                            int spawnY = -firstFilledRow;
-                            activePiece = Piece(spawnX, spawnY, newType);
-                            
-
-                            if (currentConfig && currentConfig->useTypeBasedColors && !currentConfig->colorPalette.empty()) {
-                                int colorIndex = getColorIndexForPieceType(newType);
-                                if (colorIndex < static_cast<int>(currentConfig->colorPalette.size())) {
-                                    activePiece.setColor(currentConfig->colorPalette[colorIndex]);
-                                }
-                            } else if (currentConfig && currentConfig->useRandomColorPalette && !currentConfig->colorPalette.empty()) {
-                                int randomIndex = rand() % currentConfig->colorPalette.size();
-                                activePiece.setColor(currentConfig->colorPalette[randomIndex]);
-                            }
-                            canUseHold = true;
-                        } else {
-
-                            bool useGravityFlipForDrop = (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) ? gravityFlipped : false;
-                            int dropDistance = activePiece.moveGround(grid, useGravityFlipForDrop);
-                            int dropPoints = dropDistance * HARD_DROP_POINTS_PER_CELL;
-                            totalScore += dropPoints;
-                            totalHardDropScore += dropPoints;
-                            std::cout << "Hard drop: " << dropDistance << " cells = +" << dropPoints << " points" << std::endl;
-                            audioManager.playDropSound();
-                        }
-                    }
+                    inputTimeline.trigger(InputAction::HardDrop, inputTimeline.now());
                 } else if (keyPressed->code == keyBindings.menu) {
                     if (gameOver) {
 
@@ -5274,6 +5314,10 @@ int main(int argc, char* argv[]) {
                         showCustomCursor = true;
                         selectedPauseOption = PauseOption::Resume;
                         std::cout << "Game paused" << std::endl;
+                        
+
+                        queueGameSnapshot(captureGameSnapshot());
+                        suspendedGameOnDisk = true;
                     }
                 } else if (keyPressed->code == keyBindings.bomb) {
 
@@ -5430,11 +5474,7 @@ int main(int argc, char* argv[]) {
                         hasHeldPiece = false;
                         canUseHold = true;
                         
-                        leftHoldTime = 0.0f;
-                        rightHoldTime = 0.0f;
-                        dasTimer = 0.0f;
-                        leftPressed = false;
-                        rightPressed = false;
+                        inputTimeline.reset();
                         
                         linesSinceLastAbility = 0;
                         bombAbilityAvailable = practiceInfiniteBombs ? true : debugMode;
@@ -5540,11 +5580,7 @@ int main(int argc, char* argv[]) {
                             hasHeldPiece = false;
                             canUseHold = true;
 
-                            leftHoldTime = 0.0f;
-                            rightHoldTime = 0.0f;
-                            dasTimer = 0.0f;
-                            leftPressed = false;
-                            rightPressed = false;
+                            inputTimeline.reset();
                             
                             linesSinceLastAbility = 0;
                             bombAbilityAvailable = practiceInfiniteBombs ? true : debugMode;
@@ -5580,6 +5616,23 @@ int main(int argc, char* argv[]) {
                 }
                 
 
+                if (keyPressed->code == sf::Keyboard::Key::P && practiceModeActive && !gameOver) {
+                    pcTrainer.setEnabled(!pcTrainer.isEnabled());
+                    std::cout << "Perfect clear trainer " << (pcTrainer.isEnabled() ? "ENABLED" : "DISABLED") << std::endl;
+                }
+                
+                if ((keyPressed->code == sf::Keyboard::Key::U || keyPressed->code == sf::Keyboard::Key::Y) && practiceModeActive && !gameOver) {
+                    bool isUndo = keyPressed->code == sf::Keyboard::Key::U;
+                    GameSnapshot placement;
+                    if (isUndo ? practiceUndo.undo(placement) : practiceUndo.redo(placement)) {
+                        restoreGameSnapshot(placement);
+                        pcTrainer.reset();
+                        inputTimeline.reset();
+                        std::cout << (isUndo ? "Undo" : "Redo") << " placement (" << practiceUndo.getUndoDepth() << " undo steps left)" << std::endl;
+                    }
+                }
+                
+
                 switch (keyPressed->code) {
                     case sf::Keyboard::Key::Backspace: {
                         isFullscreen = !isFullscreen;
@@ -5601,6 +5654,8 @@ int main(int argc, char* argv[]) {
             }
         }
         
+        eventsZone.finish();
+        TraceZone updateZone("update");
         if (showVolumeIndicator && volumeIndicatorTimer > 0.0f) {
             volumeIndicatorTimer -= deltaTime;
             if (volumeIndicatorTimer <= 0.0f) {
@@ -5701,6 +5756,10 @@ int main(int argc, char* argv[]) {
         if (!gameOver) {
             sessionPlayTime += deltaTime;
             
+            if (practiceModeActive && practiceUndo.isEmpty()) {
+                practiceUndo.record(captureGameSnapshot());
+            }
+            
 
             if (hardDropCooldown > 0.0f) {
                 hardDropCooldown -= deltaTime;
@@ -5709,64 +5768,19 @@ int main(int argc, char* argv[]) {
                 }
             }
         }
-
-        bool currentLeftPressed = sf::Keyboard::isKeyPressed(keyBindings.moveLeft);
-        bool currentRightPressed = sf::Keyboard::isKeyPressed(keyBindings.moveRight);
-        
-
-        if (!currentLeftPressed || currentRightPressed) {
-            leftHoldTime = 0.0f;
-        }
-        if (!currentRightPressed || currentLeftPressed) {
-            rightHoldTime = 0.0f;
-        }
         
 
-        if (currentLeftPressed && !currentRightPressed && !gameOver) {
-            if (!leftPressed) {
-
-                activePiece.moveLeft(grid);
-                leftHoldTime = 0.0f;
-                dasTimer = 0.0f;
-            } else {
-
-                leftHoldTime += deltaTime;
-                if (leftHoldTime >= DAS_DELAY) {
-                    dasTimer += deltaTime;
-                    if (dasTimer >= DAS_REPEAT) {
-                        activePiece.moveLeft(grid);
-                        dasTimer = 0.0f;
-                    }
-                }
+        if (pcTrainer.isEnabled()) {
+            if (!practiceModeActive) {
+                pcTrainer.setEnabled(false);
+            } else if (!gameOver) {
+                pcTrainer.update(makePcQuery(grid, activePiece.getType(), hasHeldPiece, heldPiece, canUseHold, TesseraBag));
             }
         }
-        
-
-        if (currentRightPressed && !currentLeftPressed && !gameOver) {
-            if (!rightPressed) {
-
-                activePiece.moveRight(grid);
-                rightHoldTime = 0.0f;
-                dasTimer = 0.0f;
-            } else {
 
-                rightHoldTime += deltaTime;
-                if (rightHoldTime >= DAS_DELAY) {
-                    dasTimer += deltaTime;
-                    if (dasTimer >= DAS_REPEAT) {
-                        activePiece.moveRight(grid);
-                        dasTimer = 0.0f;
-                    }
-                }
-            }
+        if (gameOver) {
+            inputTimeline.reset();
         }
-        
-
-        leftPressed = currentLeftPressed;
-        rightPressed = currentRightPressed;
-        
-
-        bool fastFall = sf::Keyboard::isKeyPressed(keyBindings.quickFall);
         if (!gameOver) {
 
 
@@ -5782,7 +5796,34 @@ int main(int argc, char* argv[]) {
             
 
             bool useGravityFlip = (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) ? gravityFlipped : false;
-            activePiece.update(deltaTime, fastFall, grid, currentLevel, currentGravity, useGravityFlip);
+
+
+            // Gravity and lock delay run up to each input's exact time before
+            // it is applied, so a shift that resets lock delay mid-frame only
+            // gets the time that is left after it.
+            double stepWallTime = inputTimeline.now();
+            inputTimeline.sync(sf::Keyboard::isKeyPressed(keyBindings.moveLeft), sf::Keyboard::isKeyPressed(keyBindings.moveRight),
+                               sf::Keyboard::isKeyPressed(keyBindings.quickFall), stepWallTime);
+            inputTimeline.beginStep(stepWallTime, deltaTime);
+            double simulatedUntil = inputTimeline.getStepStart();
+            InputStep inputStep;
+            while (inputTimeline.next(dasConfig, inputStep)) {
+                if (activePiece.hasStopped()) continue;
+                activePiece.update(static_cast<float>(inputStep.time - simulatedUntil), grid, currentLevel, currentGravity, useGravityFlip);
+                simulatedUntil = inputStep.time;
+                switch (inputStep.action) {
+                    case InputAction::MoveLeft: activePiece.moveLeft(grid); break;
+                    case InputAction::MoveRight: activePiece.moveRight(grid); break;
+                    case InputAction::SoftDrop: activePiece.softDrop(grid, useGravityFlip); break;
+                    case InputAction::RotateLeft: rotateActivePiece(false); break;
+                    case InputAction::RotateRight: rotateActivePiece(true); break;
+                    case InputAction::Hold: holdActivePiece(); break;
+                    case InputAction::HardDrop: hardDropActivePiece(); break;
+                }
+            }
+            if (!activePiece.hasStopped()) {
+                activePiece.update(static_cast<float>(inputTimeline.getStepEnd() - simulatedUntil), grid, currentLevel, currentGravity, useGravityFlip);
+            }
             
 
             if (challengeModeActive && selectedChallengeMode == ChallengeMode::Vanishing) {
@@ -5812,6 +5853,7 @@ int main(int argc, char* argv[]) {
                     
 
                     int dropDistance = activePiece.moveGround(grid, false);
+                    pieceDropDistance = dropDistance;
                     int dropPoints = dropDistance * HARD_DROP_POINTS_PER_CELL;
                     totalScore += dropPoints;
                     totalHardDropScore += dropPoints;
@@ -5836,9 +5878,24 @@ int main(int argc, char* argv[]) {
                 std::cout << "Saved cream block position X: " << lastCreamBlockX << std::endl;
             }
             
+            Placement lockedPlacement;
+            lockedPlacement.type = activePiece.getType();
+            lockedPlacement.rotation = findRotationIndex(lockedPlacement.type, activePiece.getShape());
+            lockedPlacement.x = activePiece.getX();
+            lockedPlacement.y = activePiece.getY();
+            pcTrainer.onPieceLocked(lockedPlacement);
+            
+
+            pieceFinesseFaults = 0;
+            bool canAnalyzeFinesse = activePiece.getAbility() == AbilityType::None && activePiece.getType() != PieceType::Cream_Single &&
+                                     !(challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip);
+            if (canAnalyzeFinesse) {
+                pieceFinesseFaults = std::max(0, finesseTracker.analyzePiece(gridToBoardRows(grid), lockedPlacement, pieceFinesseInputs));
+            }
+            
             AbilityType usedAbility = activePiece.getAbility();
             bool isVanishing = (challengeModeActive && selectedChallengeMode == ChallengeMode::Vanishing);
-            activePiece.ChangeToStatic(grid, usedAbility, &audioManager, &explosionEffects, &glowEffects, &shakeIntensity, &shakeDuration, &shakeTimer, &consecutiveBombsUsed, &saveData, &achievementPopups, isVanishing);
+            activePiece.ChangeToStatic(grid, usedAbility, &audioManager, &explosionEffects, &glowEffects, &shakeIntensity, &shakeDuration, &shakeTimer, &consecutiveBombsUsed, (challengeModeActive || practiceModeActive) ? nullptr : &achievementEngine, isVanishing);
             
 
             if (usedAbility != AbilityType::Bomb) {
@@ -5877,6 +5934,8 @@ int main(int argc, char* argv[]) {
                 gameOverBlocksFalling = true;
                 gameOverPauseComplete = true;
                 sprintCompleted = true;
+                historyFinalBoard = gridToBoardRows(grid);
+                DISCARD_SUSPENDED_GAME();
                 
 
                 shakeIntensity = 15.0f;
@@ -5898,8 +5957,8 @@ int main(int argc, char* argv[]) {
                 std::cout << "MODE COMPLETED! Time: " << sprintTimer << " seconds | Lines: " << totalLinesCleared << "/" << lineGoal << std::endl;
                 
 
-                if (sprintModeActive && lineGoal == 48 && sprintTimer < 133.7f && !challengeModeActive && !practiceModeActive) {
-                    unlockAchievement(saveData, Achievement::Blitz48Under230, &achievementPopups, &audioManager);
+                if (sprintModeActive) {
+                    achievementEngine.onSprintCompleted(lineGoal, sprintTimer, !challengeModeActive && !practiceModeActive);
                 }
                 
 
@@ -5920,49 +5979,37 @@ int main(int argc, char* argv[]) {
 
                 if (challengeModeActive) {
                     float* bestTimePtr = nullptr;
-                    Achievement challengeAchievement;
-                    bool hasAchievement = true;
                     
                     switch (selectedChallengeMode) {
                         case ChallengeMode::Debug:
                             bestTimePtr = &saveData.bestTimeChallengeDebug;
-                            hasAchievement = false;
                             break;
                         case ChallengeMode::TheForest:
                             bestTimePtr = &saveData.bestTimeChallengeTheForest;
-                            challengeAchievement = Achievement::ChallengeTheForest;
                             break;
                         case ChallengeMode::Randomness:
                             bestTimePtr = &saveData.bestTimeChallengeRandomness;
-                            challengeAchievement = Achievement::ChallengeRandomness;
                             break;
                         case ChallengeMode::NonStraight:
                             bestTimePtr = &saveData.bestTimeChallengeNonStraight;
-                            challengeAchievement = Achievement::ChallengeNonStraight;
                             break;
                         case ChallengeMode::OneRot:
                             bestTimePtr = &saveData.bestTimeChallengeOneRot;
-                            challengeAchievement = Achievement::ChallengeOneRot;
                             break;
                         case ChallengeMode::ChristopherCurse:
                             bestTimePtr = &saveData.bestTimeChallengeChristopherCurse;
-                            challengeAchievement = Achievement::ChallengeChristopherCurse;
                             break;
                         case ChallengeMode::Vanishing:
                             bestTimePtr = &saveData.bestTimeChallengeVanishing;
-                            challengeAchievement = Achievement::ChallengeVanishing;
                             break;
                         case ChallengeMode::AutoDrop:
                             bestTimePtr = &saveData.bestTimeChallengeAutoDrop;
-                            challengeAchievement = Achievement::ChallengeAutoDrop;
                             break;
                         case ChallengeMode::GravityFlip:
                             bestTimePtr = &saveData.bestTimeChallengeGravityFlip;
-                            hasAchievement = false;
                             break;
                         case ChallengeMode::Petrify:
                             bestTimePtr = &saveData.bestTimeChallengePetrify;
-                            hasAchievement = false;
                             break;
                     }
                     
@@ -5976,9 +6023,7 @@ int main(int argc, char* argv[]) {
                         }
                         
 
-                        if (isFirstCompletion && hasAchievement) {
-                            unlockAchievement(saveData, challengeAchievement, &achievementPopups, &audioManager);
-                        }
+                        achievementEngine.onChallengeCompleted(selectedChallengeMode, sprintTimer, isFirstCompletion);
                     }
                 }
                 
@@ -5991,6 +6036,7 @@ int main(int argc, char* argv[]) {
             }
             
             if (clearedLines > 0) {
+                clearTypeCounts[getClearTypeIndex(clearedLines)]++;
 
                 if (clearedLines >= 4) {
                     saveData.totalPerfectClears++;
@@ -6007,20 +6053,7 @@ int main(int argc, char* argv[]) {
                 
                 currentCombo += clearedLines;
                 
-
-                if (currentCombo >= 12 && !challengeModeActive && !practiceModeActive) {
-                    unlockAchievement(saveData, Achievement::Combo10, &achievementPopups, &audioManager);
-                }
-                
-
-                if (clearedLines >= 5 && !challengeModeActive && !practiceModeActive) {
-                    unlockAchievement(saveData, Achievement::Combo5OneClear, &achievementPopups, &audioManager);
-                }
-                
-
-                if (clearedLines >= 6 && !challengeModeActive && !practiceModeActive) {
-                    unlockAchievement(saveData, Achievement::Combo6OneClear, &achievementPopups, &audioManager);
-                }
+                achievementEngine.onLinesCleared(clearedLines, currentCombo, !challengeModeActive && !practiceModeActive);
                 
 
                 if (currentCombo > maxComboThisGame) {
@@ -6065,7 +6098,7 @@ int main(int argc, char* argv[]) {
                     }
                     
                     if (hasEmptyColumn && !challengeModeActive && !practiceModeActive) {
-                        unlockAchievement(saveData, Achievement::PerfectClear, &achievementPopups, &audioManager);
+                        achievementEngine.onPerfectClear(true);
                         std::cout << "[ACHIEVEMENT] Perfect Clear! At least one column is empty to the floor with " << totalLinesCleared << " lines cleared!" << std::endl;
                     }
                 }
@@ -6078,6 +6111,26 @@ int main(int argc, char* argv[]) {
             }
             
 
+            PieceEvent pieceEvent;
+            pieceEvent.spawnTick = pieceSpawnTick;
+            pieceEvent.lockTick = static_cast<std::uint32_t>(sessionPlayTime * ANALYTICS_TICKS_PER_SECOND);
+            pieceEvent.type = static_cast<std::uint8_t>(activePiece.getType());
+            pieceEvent.inputs = static_cast<std::uint8_t>(std::min(pieceInputCount, 255));
+            pieceEvent.rotations = static_cast<std::uint8_t>(std::min(pieceRotationCount, 255));
+            pieceEvent.dropDistance = static_cast<std::uint8_t>(std::min(pieceDropDistance, 255));
+            pieceEvent.linesCleared = static_cast<std::uint8_t>(clearedLines);
+            pieceEvent.holdUsed = pieceHoldUsed ? 1 : 0;
+            pieceEvent.combo = static_cast<std::uint16_t>(std::min(currentCombo, 65535));
+            pieceEvent.finesseFaults = static_cast<std::uint8_t>(std::min(pieceFinesseFaults, 255));
+            pieceEventLog.record(pieceEvent);
+            pieceSpawnTick = pieceEvent.lockTick;
+            pieceInputCount = 0;
+            pieceRotationCount = 0;
+            pieceDropDistance = 0;
+            pieceHoldUsed = false;
+            pieceFinesseInputs = 0;
+            
+
             if (!practiceModeActive) {
                 int newLevel = calculateLevel(totalLinesCleared);
                 if (newLevel != currentLevel) {
@@ -6136,6 +6189,8 @@ int main(int argc, char* argv[]) {
             
             if (activePiece.collidesAt(grid, spawnX, spawnY)) {
                 gameOver = true;
+                historyFinalBoard = gridToBoardRows(grid);
+                DISCARD_SUSPENDED_GAME();
                 gameOverDelayTimer = 0.0f;
                 gameOverScreenVisible = false;
                 gameOverBlocksFalling = false;
@@ -6178,14 +6233,7 @@ int main(int argc, char* argv[]) {
                     }
                     
 
-                    if (totalScore >= 200000 && !bombUsedThisGame && !challengeModeActive && !practiceModeActive) {
-                        unlockAchievement(saveData, Achievement::Score200kNoBomb, &achievementPopups, &audioManager);
-                    }
-                    
-
-                    if (totalScore >= 400000 && selectedClassicDifficulty == ClassicDifficulty::Hard && !challengeModeActive && !practiceModeActive) {
-                        unlockAchievement(saveData, Achievement::Score400kMedHard, &achievementPopups, &audioManager);
-                    }
+                    achievementEngine.onClassicFinished(selectedClassicDifficulty, totalScore, bombUsedThisGame, !challengeModeActive && !practiceModeActive);
                     
                     bool recordsUpdated = false;
                     if (totalLinesCleared > saveData.bestLines) {
@@ -6242,16 +6290,99 @@ int main(int argc, char* argv[]) {
             canUseHold = true;
             
 
-            leftHoldTime = 0.0f;
-            rightHoldTime = 0.0f;
-            dasTimer = 0.0f;
-            leftPressed = false;
-            rightPressed = false;
+            inputTimeline.reset();
+            
+            recordPracticePlacement();
+        }
+        
+
+        if (gameOver && !analyticsRecorded) {
+            analyticsRecorded = true;
+            GameModeOption analyticsMode = GameModeOption::Classic;
+            int analyticsSubMode = static_cast<int>(selectedClassicDifficulty);
+            if (practiceModeActive) {
+                analyticsMode = GameModeOption::Practice;
+                analyticsSubMode = static_cast<int>(selectedPracticeDifficulty);
+            } else if (challengeModeActive) {
+                analyticsMode = GameModeOption::Challenge;
+                analyticsSubMode = static_cast<int>(selectedChallengeMode);
+            } else if (sprintModeActive) {
+                analyticsMode = GameModeOption::Sprint;
+                analyticsSubMode = sprintTargetLines;
+            }
+            if (!debugMode && pieceEventLog.getTotalRecorded() > 0) {
+                std::uint32_t durationMs = static_cast<std::uint32_t>(sessionPlayTime * ANALYTICS_TICKS_PER_SECOND);
+                appendAnalyticsRecord(aggregatePieceEvents(pieceEventLog, durationMs, analyticsMode, analyticsSubMode));
+            }
+            if (!debugMode) {
+                GameHistoryRecord historyRecord;
+                historyRecord.timestamp = static_cast<std::int64_t>(std::time(nullptr));
+                historyRecord.seed = TesseraBag.getSeed();
+                historyRecord.score = totalScore;
+                historyRecord.lines = totalLinesCleared;
+                historyRecord.level = currentLevel;
+                historyRecord.timeSeconds = sprintCompleted ? sprintTimer : sessionPlayTime;
+                historyRecord.mode = static_cast<std::uint8_t>(analyticsMode);
+                historyRecord.completed = sprintCompleted ? 1 : 0;
+                historyRecord.config = static_cast<std::uint16_t>(analyticsSubMode);
+                std::copy(historyFinalBoard.begin(), historyFinalBoard.end(), historyRecord.boardRows);
+                gameHistory.append(historyRecord);
+                
+                int statsSlot = getModeStatsSlot(analyticsMode, analyticsSubMode);
+                if (statsSlot >= 0) {
+                    ModeGameResult statsResult;
+                    statsResult.score = totalScore;
+                    statsResult.lines = totalLinesCleared;
+                    statsResult.pieces = sessionPiecesPlaced;
+                    statsResult.playTimeSeconds = sessionPlayTime;
+                    statsResult.completed = sprintCompleted;
+                    statsResult.clears = clearTypeCounts;
+                    recordModeStatsGame(saveData.modeStats[statsSlot], statsResult);
+                    saveGameData(saveData);
+                }
+            }
         }
         
         }
         
 
+        if (gameState != GameState::Playing && gameState != GameState::Paused && gameState != GameState::GameOver &&
+            profileManager.pollSwitch(saveData, gameHistory)) {
+            achievementEngine.sync(saveData);
+            loadKeyBindings(saveData);
+            customKeyBindings = keyBindings;
+            // Same order as startup: unmuted volume first, then mute, so
+            // toggleMute remembers this profile's volume and not the last one's.
+            if (audioManager.isMutedStatus()) {
+                audioManager.toggleMute();
+            }
+            audioManager.setMasterVolume(saveData.masterVolume);
+            if (saveData.isMuted) {
+                audioManager.toggleMute();
+            }
+            selectedThemeChoice = static_cast<GameThemeChoice>(saveData.selectedTheme);
+            hoveredThemeChoice = selectedThemeChoice;
+            suspendedGameOnDisk = false;
+        }
+
+        if (gameState == GameState::ModeSelection || gameState == GameState::GameModeSelect ||
+            gameState == GameState::ClassicDifficultySelect || gameState == GameState::SprintLinesSelect ||
+            gameState == GameState::ChallengeSelect || gameState == GameState::PracticeSelect) {
+            if (!themePrefetched || prefetchedModeOption != selectedGameModeOption ||
+                prefetchedClassicDifficulty != selectedClassicDifficulty ||
+                prefetchedChallengeMode != selectedChallengeMode || prefetchedThemeChoice != selectedThemeChoice) {
+                prefetchGameTheme(audioManager, selectedGameModeOption, selectedClassicDifficulty, selectedChallengeMode, selectedThemeChoice);
+                themePrefetched = true;
+                prefetchedModeOption = selectedGameModeOption;
+                prefetchedClassicDifficulty = selectedClassicDifficulty;
+                prefetchedChallengeMode = selectedChallengeMode;
+                prefetchedThemeChoice = selectedThemeChoice;
+            }
+        } else {
+            // The cache may evict between visits, so each new visit queues once.
+            themePrefetched = false;
+        }
+        achievementEngine.flush(saveData, achievementPopups, &audioManager);
         for (auto it = achievementPopups.begin(); it != achievementPopups.end(); ) {
             it->update(deltaTime);
             if (it->isFinished()) {
@@ -6640,6 +6771,8 @@ int main(int argc, char* argv[]) {
             view.setCenter(sf::Vector2f(WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f));
         }
         window.setView(view);
+        updateZone.finish();
+        TraceZone sceneZone("draw scene");
         
         if (gameState == GameState::SplashScreen) {
             splashElapsedTime += deltaTime;
@@ -6647,7 +6780,7 @@ int main(int argc, char* argv[]) {
             switch (splashSequenceStep) {
                 case 0:
                     blackScreenAlpha = 1.0f;
-                    if (splashElapsedTime >= 1.0f) {
+                    if (splashElapsedTime >= 1.0f && splashResolved) {
                         audioManager.playSplashMusic();
                         splashElapsedTime = 0.0f;
                         splashSequenceStep++;
@@ -6680,7 +6813,7 @@ int main(int argc, char* argv[]) {
                     
                 case 4:
                     blackScreenAlpha = 1.0f;
-                    if (splashElapsedTime >= 1.0f) {
+                    if (splashElapsedTime >= 1.0f && assetLoader.isFinished() && audioManager.getLoadProgress() >= 1.0f) {
                         splashElapsedTime = 0.0f;
                         splashSequenceStep++;
                     }
@@ -6728,6 +6861,20 @@ int main(int argc, char* argv[]) {
             blackScreen.setFillColor(sf::Color(0, 0, 0, static_cast<std::uint8_t>(blackScreenAlpha * 255)));
             window.draw(blackScreen);
             
+
+            float loadProgress = (assetLoader.getProgress() + audioManager.getLoadProgress()) / 2.0f;
+            if (splashSequenceStep <= 4 && loadProgress < 1.0f) {
+                const float barWidth = 480.0f;
+                sf::RectangleShape barTrack(sf::Vector2f(barWidth, 4.0f));
+                barTrack.setPosition(sf::Vector2f((WINDOW_WIDTH - barWidth) / 2.0f, WINDOW_HEIGHT - 80.0f));
+                barTrack.setFillColor(sf::Color(255, 255, 255, 40));
+                window.draw(barTrack);
+                sf::RectangleShape barFill(sf::Vector2f(barWidth * loadProgress, 4.0f));
+                barFill.setPosition(barTrack.getPosition());
+                barFill.setFillColor(sf::Color(255, 255, 255, 200));
+                window.draw(barFill);
+            }
+            
         } else if (gameState == GameState::FirstTimeSetup) {
             drawFirstTimeSetup(window, titleFont, menuFont, fontLoaded, hoveredControlScheme, textures, useTextures);
         } else if (gameState == GameState::WelcomeScreen) {
@@ -6737,6 +6884,7 @@ int main(int argc, char* argv[]) {
             drawBackgroundPiecesWithExplosions(window, backgroundPieces, explosionEffects, textures, useTextures);
             drawGlowEffects(window, glowEffects, textures);
             drawMainMenu(window, titleFont, menuFont, fontLoaded, selectedMenuOption, debugMode, textures, useTextures, splashElapsedTime);
+            drawProfileBadge(window, menuFont, fontLoaded, profileManager.getActiveProfile().name, profileManager.getProfiles().size(), profileManager.isSwitching());
         } else if (gameState == GameState::ModeSelection) {
             drawBackgroundPiecesWithExplosions(window, backgroundPieces, explosionEffects, textures, useTextures);
             drawGlowEffects(window, glowEffects, textures);
@@ -6789,11 +6937,11 @@ int main(int argc, char* argv[]) {
         } else if (gameState == GameState::StatisticsView) {
             drawBackgroundPiecesWithExplosions(window, backgroundPieces, explosionEffects, textures, useTextures);
             drawGlowEffects(window, glowEffects, textures);
-            drawStatisticsScreen(window, titleFont, menuFont, fontLoaded, saveData, debugMode);
+            drawStatisticsScreen(window, titleFont, menuFont, fontLoaded, saveData, gameHistory, debugMode);
         } else if (gameState == GameState::BestScoresView) {
             drawBackgroundPiecesWithExplosions(window, backgroundPieces, explosionEffects, textures, useTextures);
             drawGlowEffects(window, glowEffects, textures);
-            drawBestScoresScreen(window, titleFont, menuFont, fontLoaded, saveData, debugMode);
+            drawBestScoresScreen(window, titleFont, menuFont, fontLoaded, saveData, gameHistory, debugMode);
         } else if (gameState == GameState::Options) {
             splashElapsedTime += deltaTime;
             drawBackgroundPiecesWithExplosions(window, backgroundPieces, explosionEffects, textures, useTextures);
@@ -6877,6 +7025,7 @@ int main(int argc, char* argv[]) {
         if (!gameOver) {
             bool useGravityFlipForGhost = (challengeModeActive && selectedChallengeMode == ChallengeMode::GravityFlip) ? gravityFlipped : false;
             activePiece.drawGhost(window, textures, useTextures, grid, useGravityFlipForGhost);
+            drawPerfectClearGuide(window, pcTrainer, menuFont, fontLoaded, currentTheme.frameColor);
             
 
             if (hasBlocksInTopRows(grid, 5)) {
@@ -6914,6 +7063,7 @@ int main(int argc, char* argv[]) {
         }
 
         drawCombo(window, displayCombo, currentCombo, lastMoveScore, menuFont, fontLoaded, !useSprintUI, comboFadeScale);
+        drawFinesseInfo(window, finesseTracker, menuFont, fontLoaded);
         drawGridBorder(window, currentTheme.frameColor);
         drawTesseraTitle(window, titleFont, fontLoaded);
         
@@ -6989,6 +7139,7 @@ int main(int argc, char* argv[]) {
             int lineTarget = useLineGoalInterface ? currentConfig->lineGoal : 0;
             
             drawGameOver(window, totalScore, totalLinesCleared, currentLevel, textures, useTextures, menuFont, fontLoaded, saveData, totalHardDropScore, totalLineScore, totalComboScore, selectedClassicDifficulty, useLineGoalInterface, sprintTimer, lineTarget, sprintCompleted, challengeModeActive, practiceModeActive, uiAlpha, currentTheme.frameColor, gameOverUiFadeTimer, gameOverNewHighScore, gameOverHighScoreBaseline, currentTheme.backgroundColor);
+            drawFinesseSummary(window, finesseTracker, menuFont, fontLoaded, uiAlpha, currentTheme.frameColor);
         }
         
         if (gameState == GameState::Paused) {
@@ -7005,6 +7156,8 @@ int main(int argc, char* argv[]) {
         }
         
 
+        sceneZone.finish();
+        TraceZone overlayZone("draw overlay");
         if (showVolumeIndicator) {
             drawVolumeIndicator(window, menuFont, fontLoaded, audioManager.getMasterVolume(), audioManager.isMutedStatus());
         }
@@ -7015,9 +7168,22 @@ int main(int argc, char* argv[]) {
         if (showCustomCursor) {
             drawCustomCursor(window, textures, useTextures);
         }
+        overlayZone.finish();
         
+        TraceZone displayZone("display");
         window.display();
+        displayZone.finish();
+        if (!firstFramePresented) {
+            traceInstant("first frame presented");
+            firstFramePresented = true;
+        }
+    }
+    
+    flushSaveData();
+    if ((gameState == GameState::Playing || gameState == GameState::Paused) && !gameOver) {
+        writeGameSnapshot(captureGameSnapshot());
     }
+    traceWrite();
     return 0;
 }
 